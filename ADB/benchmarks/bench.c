@@ -0,0 +1,175 @@
+#include "bench.h"
+
+#include <stdio.h>
+#include <stdlib.h>
+
+#if defined(_WIN32)
+#define WIN32_LEAN_AND_MEAN
+#include <Windows.h>
+#include "platform/win32_work_queue.h"
+#else
+#include <unistd.h>
+#endif
+
+
+volatile uint64_t BenchSink;
+
+
+memory_arena *
+BenchCreateArena(uint64_t ReserveSize)
+{
+    memory_arena_params Params =
+    {
+        .AllocatedFromFile = __FILE__,
+        .AllocatedFromLine = __LINE__,
+        .ReserveSize       = ReserveSize,
+        .CommitSize        = MiB(16),
+    };
+
+    memory_arena *Result = AllocateArena(Params);
+    if (!Result)
+    {
+        fprintf(stderr, "Could not reserve %llu bytes\n", (unsigned long long)ReserveSize);
+        exit(1);
+    }
+
+    return Result;
+}
+
+
+uint32_t
+BenchGetProcessorCount(void)
+{
+#if defined(_WIN32)
+    uint32_t Result = (uint32_t)GetActiveProcessorCount(ALL_PROCESSOR_GROUPS);
+#else
+    uint32_t Result = (uint32_t)sysconf(_SC_NPROCESSORS_ONLN);
+#endif
+
+    return Result ? Result : 1;
+}
+
+
+void
+BenchSleepMilliseconds(uint32_t Milliseconds)
+{
+#if defined(_WIN32)
+    Sleep(Milliseconds);
+#else
+    usleep(Milliseconds * 1000);
+#endif
+}
+
+
+uint32_t
+BenchGetWorkerCounts(uint32_t *Counts, uint32_t MaxCount)
+{
+    uint32_t MaxWorkers = Maximum(BenchGetProcessorCount() - 1, 1);
+    uint32_t Result     = 0;
+
+    for (uint32_t WorkerCount = 1; WorkerCount < MaxWorkers && Result < MaxCount; WorkerCount *= 2)
+    {
+        Counts[Result++] = WorkerCount;
+    }
+
+    if (Result < MaxCount)
+    {
+        Counts[Result++] = MaxWorkers;
+    }
+
+    return Result;
+}
+
+
+static int
+BenchCompareSamples(const void *A, const void *B)
+{
+    uint64_t SampleA = *(const uint64_t *)A;
+    uint64_t SampleB = *(const uint64_t *)B;
+
+    int Result = (SampleA > SampleB) - (SampleA < SampleB);
+    return Result;
+}
+
+
+bench_stats
+BenchGetStats(uint64_t *Samples, uint32_t Count)
+{
+    bench_stats Result = {0};
+
+    if (Count)
+    {
+        qsort(Samples, Count, sizeof(uint64_t), BenchCompareSamples);
+
+        double Sum = 0.0;
+        for (uint32_t Idx = 0; Idx < Count; ++Idx)
+        {
+            Sum += (double)Samples[Idx];
+        }
+
+        Result.Count           = Count;
+        Result.MinNanoseconds  = Samples[0];
+        Result.P50Nanoseconds  = Samples[(Count - 1) / 2];
+        Result.P99Nanoseconds  = Samples[((Count - 1) * 99) / 100];
+        Result.MaxNanoseconds  = Samples[Count - 1];
+        Result.MeanNanoseconds = Sum / (double)Count;
+    }
+
+    return Result;
+}
+
+
+void
+BenchPrintHeader(const char *Title)
+{
+    printf("\n%s\n", Title);
+    printf("%-40s %12s %12s %12s %14s\n", "", "min (us)", "median (us)", "p99 (us)", "items/s");
+}
+
+
+void
+BenchPrintStats(const char *Name, bench_stats Stats, double ItemsPerRun)
+{
+    printf("%-40s %12.2f %12.2f %12.2f", Name, Stats.MinNanoseconds / 1e3, Stats.P50Nanoseconds / 1e3, Stats.P99Nanoseconds / 1e3);
+
+    if (ItemsPerRun > 0.0 && Stats.P50Nanoseconds)
+    {
+        printf(" %14.4g", ItemsPerRun * 1e9 / (double)Stats.P50Nanoseconds);
+    }
+
+    printf("\n");
+}
+
+
+engine_memory *
+BenchStartWorkers(uint32_t WorkerCount, memory_arena *Arena)
+{
+    engine_memory *Result = 0;
+
+#if defined(_WIN32)
+    Result = PushStruct(Arena, engine_memory);
+    if (Result && !Win32StartWorkQueue(WorkerCount, Arena, Result))
+    {
+        Result = 0;
+    }
+#else
+    Unused(WorkerCount);
+    Unused(Arena);
+#endif
+
+    return Result;
+}
+
+
+void
+BenchStopWorkers(engine_memory *EngineMemory)
+{
+#if defined(_WIN32)
+    if (EngineMemory && EngineMemory->WorkQueue)
+    {
+        Win32StopWorkers(EngineMemory->WorkQueue);
+    }
+#else
+    Unused(EngineMemory);
+#endif
+}
@@ -0,0 +1,55 @@
+#pragma once
+
+#include <stdint.h>
+#include <stdbool.h>
+
+#include "utilities.h"
+#include "platform/platform.h"
+
+// =====================================================
+// [SECTION] Benchmark Support
+// [DESCRIP]
+//   Shared by the bench_*.c programs. Each one is a
+//   standalone executable that prints a table and exits;
+//   build them with benchmarks/build.sh or build.bat.
+//   Times are wall clock (OSGetTimeNanoseconds). Every
+//   measurement is repeated and reported as min / median /
+//   p99 so one preempted run does not skew the result.
+// =====================================================
+
+
+typedef struct bench_stats
+{
+    uint32_t Count;
+    uint64_t MinNanoseconds;
+    uint64_t P50Nanoseconds;
+    uint64_t P99Nanoseconds;
+    uint64_t MaxNanoseconds;
+    double   MeanNanoseconds;
+} bench_stats;
+
+
+// Written with results the compiler must not optimize away.
+extern volatile uint64_t BenchSink;
+
+memory_arena  *BenchCreateArena           (uint64_t ReserveSize);
+uint32_t       BenchGetProcessorCount     (void);
+void           BenchSleepMilliseconds     (uint32_t Milliseconds);
+
+// Worker counts for scaling runs: 1, 2, 4... and one per logical processor besides
+// the calling thread. Always at least one entry. Returns the number written.
+uint32_t       BenchGetWorkerCounts       (uint32_t *Counts, uint32_t MaxCount);
+
+// Sorts 'Samples' in place.
+bench_stats    BenchGetStats              (uint64_t *Samples, uint32_t Count);
+
+// Prints one row: min, median, p99 and, when ItemsPerRun is not zero, the median
+// throughput in items per second.
+void           BenchPrintHeader           (const char *Title);
+void           BenchPrintStats            (const char *Name, bench_stats Stats, double ItemsPerRun);
+
+// Starts the platform work queue with 'WorkerCount' workers and returns an
+// engine_memory wired to it. Only the Win32 queue exists, so elsewhere this returns
+// null and threaded runs are skipped. BenchStopWorkers joins the workers.
+engine_memory *BenchStartWorkers          (uint32_t WorkerCount, memory_arena *Arena);
+void           BenchStopWorkers           (engine_memory *EngineMemory);
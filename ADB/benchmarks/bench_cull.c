@@ -0,0 +1,202 @@
+// Vec3BatchCullBoxes against a scalar loop testing one box at a time (six planes,
+// leaving at the first plane that rejects it). The first table culls 100K random
+// boxes scattered around the camera at each instruction set and checks every set
+// keeps the same boxes. The second lays out square worlds of 16x16 chunks on Z = 0,
+// seen from 100 units away as DrawChunks does. Only the visible chunks are submitted,
+// so the cost the world size adds is the cull itself.
+
+#include <math.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+
+#include "bench.h"
+#include "engine/math/vector_batch.h"
+#include "engine/rendering/renderer.h"
+
+
+#define BENCH_BOX_COUNT  100000
+#define BENCH_RUN_COUNT  50
+#define BENCH_CHUNK_SIZE 16.f
+
+
+typedef struct
+{
+    vec3_soa  Centers;
+    vec3_soa  Extents;
+    uint32_t *Visible;
+    uint64_t  Count;
+    plane    *Planes;
+} bench_cull_data;
+
+
+static uint64_t
+ScalarCullBoxes(bench_cull_data *Data)
+{
+    uint64_t Result = 0;
+
+    for (uint64_t Idx = 0; Idx < Data->Count; ++Idx)
+    {
+        vec3 Center = Vec3(Data->Centers.X[Idx], Data->Centers.Y[Idx], Data->Centers.Z[Idx]);
+        vec3 Extent = Vec3(Data->Extents.X[Idx], Data->Extents.Y[Idx], Data->Extents.Z[Idx]);
+        bool Inside = true;
+
+        for (uint32_t PlaneIdx = 0; PlaneIdx < FrustumPlane_Count && Inside; ++PlaneIdx)
+        {
+            plane Plane    = Data->Planes[PlaneIdx];
+            float Distance = Vec3Dot(Plane.Normal, Center) + Plane.Offset;
+            float Radius   = fabsf(Plane.Normal.X) * Extent.X + fabsf(Plane.Normal.Y) * Extent.Y + fabsf(Plane.Normal.Z) * Extent.Z;
+
+            Inside = Distance + Radius >= 0.f;
+        }
+
+        if (Inside)
+        {
+            Data->Visible[Result++] = (uint32_t)Idx;
+        }
+    }
+
+    return Result;
+}
+
+
+static uint64_t
+BatchCullBoxes(bench_cull_data *Data)
+{
+    uint64_t Result = Vec3BatchCullBoxes(Data->Centers, Data->Extents, Data->Planes, FrustumPlane_Count, Data->Visible, Data->Count);
+    return Result;
+}
+
+
+typedef uint64_t bench_cull_workload(bench_cull_data *Data);
+
+
+static bench_stats
+MeasureCull(bench_cull_workload *Workload, bench_cull_data *Data, uint64_t *OutVisibleCount)
+{
+    uint64_t Samples[BENCH_RUN_COUNT];
+
+    *OutVisibleCount = Workload(Data);
+
+    for (uint32_t Run = 0; Run < BENCH_RUN_COUNT; ++Run)
+    {
+        uint64_t Start = OSGetTimeNanoseconds();
+        BenchSink += Workload(Data);
+        Samples[Run] = OSGetTimeNanoseconds() - Start;
+    }
+
+    bench_stats Result = BenchGetStats(Samples, BENCH_RUN_COUNT);
+    return Result;
+}
+
+
+static float
+RandomUnit(void)
+{
+    float Result = (float)rand() / (float)RAND_MAX * 2.f - 1.f;
+    return Result;
+}
+
+
+int
+main(void)
+{
+    memory_arena *Arena = BenchCreateArena(GiB(1));
+
+    // Large enough for the biggest world below.
+    uint64_t MaxCount = 1024 * 1024;
+
+    bench_cull_data Data =
+    {
+        .Centers = PushVec3SoA(Arena, MaxCount),
+        .Extents = PushVec3SoA(Arena, MaxCount),
+        .Visible = PushArray(Arena, uint32_t, MaxCount),
+    };
+
+    uint32_t *Reference = PushArray(Arena, uint32_t, MaxCount);
+
+    // Random boxes, some of them behind the camera or past the far plane.
+    camera Camera = CreateCamera(Vec3(0.f, 0.f, -10.f), 60.f, 16.f / 9.f);
+    Data.Planes = GetCameraCache(&Camera)->Planes;
+    Data.Count  = BENCH_BOX_COUNT;
+
+    srand(1);
+
+    for (uint32_t Idx = 0; Idx < BENCH_BOX_COUNT; ++Idx)
+    {
+        Data.Centers.X[Idx] = RandomUnit() * 500.f;
+        Data.Centers.Y[Idx] = RandomUnit() * 500.f;
+        Data.Centers.Z[Idx] = RandomUnit() * 500.f;
+        Data.Extents.X[Idx] = 8.f;
+        Data.Extents.Y[Idx] = 8.f;
+        Data.Extents.Z[Idx] = fabsf(RandomUnit());
+    }
+
+    uint64_t    ReferenceCount;
+    bench_stats ScalarStats = MeasureCull(ScalarCullBoxes, &Data, &ReferenceCount);
+    memcpy(Reference, Data.Visible, ReferenceCount * sizeof(uint32_t));
+
+    printf("%u random boxes, %llu inside the frustum\n", BENCH_BOX_COUNT, (unsigned long long)ReferenceCount);
+    BenchPrintHeader("Culling (items are boxes)");
+    BenchPrintStats("scalar, early out", ScalarStats, BENCH_BOX_COUNT);
+
+    const char    *ISANames[] = { "Vec3BatchCullBoxes, SSE2", "Vec3BatchCullBoxes, AVX2", "Vec3BatchCullBoxes, AVX-512" };
+    VectorISA_Type Best       = GetVectorBatchISA();
+
+    for (uint32_t ISA = 0; ISA <= (uint32_t)Best; ++ISA)
+    {
+        SetVectorBatchISA((VectorISA_Type)ISA);
+
+        uint64_t    VisibleCount;
+        bench_stats Stats = MeasureCull(BatchCullBoxes, &Data, &VisibleCount);
+
+        BenchPrintStats(ISANames[ISA], Stats, BENCH_BOX_COUNT);
+
+        if (VisibleCount != ReferenceCount || memcmp(Data.Visible, Reference, VisibleCount * sizeof(uint32_t)) != 0)
+        {
+            printf("  MISMATCH: %llu boxes kept, the scalar loop kept %llu\n", (unsigned long long)VisibleCount, (unsigned long long)ReferenceCount);
+        }
+    }
+
+    SetVectorBatchISA(Best);
+
+    // Chunk grids centered under a camera looking straight down at them.
+    Camera      = CreateCamera(Vec3(0.f, 0.f, -100.f), 60.f, 16.f / 9.f);
+    Data.Planes = GetCameraCache(&Camera)->Planes;
+
+    printf("\nWorlds of %gx%g chunks, camera 100 units above the middle\n", BENCH_CHUNK_SIZE, BENCH_CHUNK_SIZE);
+    printf("%10s %10s %14s %14s %14s\n", "chunks", "visible", "cull p50 (us)", "cull p99 (us)", "ns per chunk");
+
+    uint32_t WorldSides[] = { 16, 64, 256, 1024 };
+
+    for (uint32_t SideIdx = 0; SideIdx < ArrayCount(WorldSides); ++SideIdx)
+    {
+        uint32_t Side = WorldSides[SideIdx];
+        float    Half = 0.5f * BENCH_CHUNK_SIZE;
+
+        Data.Count = (uint64_t)Side * Side;
+
+        for (uint32_t Y = 0; Y < Side; ++Y)
+        {
+            for (uint32_t X = 0; X < Side; ++X)
+            {
+                uint64_t Idx = (uint64_t)Y * Side + X;
+
+                Data.Centers.X[Idx] = ((float)X - 0.5f * (float)Side) * BENCH_CHUNK_SIZE + Half;
+                Data.Centers.Y[Idx] = ((float)Y - 0.5f * (float)Side) * BENCH_CHUNK_SIZE + Half;
+                Data.Centers.Z[Idx] = 0.f;
+                Data.Extents.X[Idx] = Half;
+                Data.Extents.Y[Idx] = Half;
+                Data.Extents.Z[Idx] = 0.f;
+            }
+        }
+
+        uint64_t    VisibleCount;
+        bench_stats Stats = MeasureCull(BatchCullBoxes, &Data, &VisibleCount);
+
+        printf("%10llu %10llu %14.2f %14.2f %14.2f\n", (unsigned long long)Data.Count, (unsigned long long)VisibleCount,
+               Stats.P50Nanoseconds / 1e3, Stats.P99Nanoseconds / 1e3, (double)Stats.P50Nanoseconds / (double)Data.Count);
+    }
+
+    return 0;
+}
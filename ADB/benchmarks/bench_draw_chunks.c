@@ -0,0 +1,147 @@
+// DrawChunks throughput against the number of workers recording. A 128x128 chunk
+// world (16K chunks) is seen from high enough that about half of it is visible, and
+// every frame culls it, records the visible chunks in blocks of contexts and merges
+// and sorts them the way the backend does at the end of the frame. Record is
+// DrawChunks alone; frame adds BuildRenderPassList, which runs on one thread.
+// Draws only carry resource handles until the backend resolves them, so the chunks
+// get handles of their own instead of real buffers.
+
+#include <stdio.h>
+
+#include "bench.h"
+#include "null_renderer.h"
+#include "engine/rendering/renderer.h"
+#include "game/world/chunk.h"
+
+
+#define BENCH_WORLD_SIDE 128
+#define BENCH_RUN_COUNT  50
+
+
+typedef struct
+{
+    bench_stats Record;
+    bench_stats Frame;
+    uint32_t    Drawn;
+    uint32_t    Batches;
+} bench_draw_result;
+
+
+static void
+MakeChunkWorld(chunk *Chunks)
+{
+    uint32_t Half = BENCH_WORLD_SIDE / 2;
+
+    for (uint32_t Y = 0; Y < BENCH_WORLD_SIDE; ++Y)
+    {
+        for (uint32_t X = 0; X < BENCH_WORLD_SIDE; ++X)
+        {
+            uint32_t Idx    = Y * BENCH_WORLD_SIDE + X;
+            vec3     Origin = Vec3(((float)X - (float)Half) * CHUNK_SIZE_X, ((float)Y - (float)Half) * CHUNK_SIZE_Y, 0.f);
+            chunk   *Chunk  = Chunks + Idx;
+
+            *Chunk = MakeChunk(ChunkMesh_Greedy, Origin);
+
+            Chunk->Material     = (resource_handle){.Value = 1 + Idx % 4, .Type = RendererResource_Material};
+            Chunk->VertexBuffer = (resource_handle){.Value = 1 + Idx, .Type = RendererResource_VertexBuffer};
+            Chunk->QuadCount    = 32;
+            Chunk->VertexCount  = 4 * Chunk->QuadCount;
+            Chunk->IndexCount   = 6 * Chunk->QuadCount;
+        }
+    }
+}
+
+
+static bench_draw_result
+MeasureDraws(camera *Camera, renderer *Renderer, chunk *Chunks, memory_arena *Arena, engine_memory *EngineMemory)
+{
+    bench_draw_result Result = {0};
+    uint64_t          RecordSamples[BENCH_RUN_COUNT];
+    uint64_t          FrameSamples[BENCH_RUN_COUNT];
+
+    // One warmup frame commits the context arenas and wakes the workers.
+    for (uint32_t Run = 0; Run <= BENCH_RUN_COUNT; ++Run)
+    {
+        memory_region Region = EnterMemoryRegion(Arena);
+        render_stats  Stats  = {0};
+
+        uint64_t Start = OSGetTimeNanoseconds();
+        Result.Drawn = DrawChunks(Camera, Renderer, Arena, Chunks, BENCH_WORLD_SIDE * BENCH_WORLD_SIDE, EngineMemory);
+        uint64_t Recorded = OSGetTimeNanoseconds();
+        render_pass_list PassList = BuildRenderPassList(Renderer->Contexts, RENDER_MAX_CONTEXTS, &Stats, Arena);
+        uint64_t End = OSGetTimeNanoseconds();
+
+        BenchSink += (uint64_t)(uintptr_t)PassList.First;
+
+        if (Run > 0)
+        {
+            RecordSamples[Run - 1] = Recorded - Start;
+            FrameSamples[Run - 1]  = End - Start;
+        }
+
+        Result.Batches = Stats.Batches;
+
+        LeaveMemoryRegion(Region);
+    }
+
+    Result.Record = BenchGetStats(RecordSamples, BENCH_RUN_COUNT);
+    Result.Frame  = BenchGetStats(FrameSamples, BENCH_RUN_COUNT);
+
+    return Result;
+}
+
+
+static void
+PrintDrawResult(const char *Name, bench_draw_result *Result, bench_draw_result *Baseline)
+{
+    double DrawsPerSecond = (double)Result->Drawn / ((double)Result->Record.P50Nanoseconds / 1e9);
+    double Speedup        = (double)Baseline->Record.P50Nanoseconds / (double)Result->Record.P50Nanoseconds;
+
+    printf("%-12s %12.2f %12.2f %10.2fx %12.2f %12.2f %14.1f\n", Name, Result->Record.P50Nanoseconds / 1e3,
+           Result->Record.P99Nanoseconds / 1e3, Speedup, Result->Frame.P50Nanoseconds / 1e3,
+           Result->Frame.P99Nanoseconds / 1e3, DrawsPerSecond / 1e6);
+}
+
+
+int
+main(void)
+{
+    memory_arena *Arena    = BenchCreateArena(GiB(1));
+    renderer     *Renderer = CreateNullRenderer(Arena);
+    chunk        *Chunks   = PushArray(Arena, chunk, BENCH_WORLD_SIDE * BENCH_WORLD_SIDE);
+
+    MakeChunkWorld(Chunks);
+
+    camera Camera = CreateCamera(Vec3(0.f, 0.f, -900.f), 60.f, 16.f / 9.f);
+
+    bench_draw_result Inline = MeasureDraws(&Camera, Renderer, Chunks, Arena, 0);
+
+    printf("%u chunks, %u drawn per frame in up to %u contexts, %u batches built\n", BENCH_WORLD_SIDE * BENCH_WORLD_SIDE,
+           Inline.Drawn, RENDER_MAX_CONTEXTS - 1, Inline.Batches);
+    printf("%-12s %12s %12s %11s %12s %12s %14s\n", "workers", "record (us)", "p99 (us)", "speedup", "frame (us)", "p99 (us)", "M draws/s");
+
+    PrintDrawResult("none", &Inline, &Inline);
+
+    uint32_t WorkerCounts[32];
+    uint32_t WorkerCountCount = BenchGetWorkerCounts(WorkerCounts, ArrayCount(WorkerCounts));
+
+    for (uint32_t Idx = 0; Idx < WorkerCountCount; ++Idx)
+    {
+        engine_memory *EngineMemory = BenchStartWorkers(WorkerCounts[Idx], Arena);
+        if (!EngineMemory)
+        {
+            printf("(threaded runs need the Win32 work queue, skipped)\n");
+            break;
+        }
+
+        char Name[16];
+        snprintf(Name, sizeof(Name), "%u", EngineMemory->WorkerCount);
+
+        bench_draw_result Threaded = MeasureDraws(&Camera, Renderer, Chunks, Arena, EngineMemory);
+        PrintDrawResult(Name, &Threaded, &Inline);
+
+        BenchStopWorkers(EngineMemory);
+    }
+
+    return 0;
+}
@@ -0,0 +1,260 @@
+// The fast_math approximations against libm. Speed: 1M random inputs in the range
+// hot paths use, through libm, the scalar Fast* call and the batch version. Accuracy:
+// the largest error over an evenly spaced sweep of each documented domain, against
+// double precision, next to the bound fast_math.h states.
+
+#include <math.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+
+#include "bench.h"
+#include "engine/math/fast_math.h"
+
+
+#define BENCH_INPUT_COUNT (1u << 20)
+#define BENCH_SWEEP_COUNT (1u << 23)
+#define BENCH_RUN_COUNT   15
+
+
+typedef float  bench_scalar_function(float X);
+typedef void   bench_batch_function (float *In, float *Out, uint64_t Count);
+typedef double bench_reference      (double X);
+
+
+static float
+LibmRsqrt(float X)
+{
+    float Result = 1.f / sqrtf(X);
+    return Result;
+}
+
+
+static double
+ReferenceRsqrt(double X)
+{
+    double Result = 1.0 / sqrt(X);
+    return Result;
+}
+
+
+typedef struct
+{
+    const char            *Name;
+    bench_scalar_function *Libm;
+    bench_scalar_function *Fast;
+    bench_batch_function  *Batch;
+
+    // Inputs are uniform in [Min, Max], the range hot paths call with.
+    float                  Min;
+    float                  Max;
+} bench_speed_case;
+
+
+typedef enum
+{
+    BenchError_Absolute,
+    BenchError_Relative,
+
+    // Absolute, less one ulp of the result (log2 away from 1).
+    BenchError_AbsolutePlusUlp,
+} bench_error;
+
+
+typedef struct
+{
+    const char            *Name;
+    bench_scalar_function *Libm;
+    bench_scalar_function *Fast;
+    bench_reference       *Reference;
+
+    // Evenly spaced over [Min, Max], or over the bit patterns of every positive
+    // normal float.
+    float                  Min;
+    float                  Max;
+    bool                   SweepBits;
+
+    bench_error            Error;
+    double                 Bound;
+} bench_accuracy_case;
+
+
+static float *Inputs;
+static float *Outputs;
+
+
+static bench_stats
+MeasureScalar(bench_scalar_function *Function)
+{
+    uint64_t Samples[BENCH_RUN_COUNT];
+
+    for (uint32_t Run = 0; Run < BENCH_RUN_COUNT; ++Run)
+    {
+        uint64_t Start = OSGetTimeNanoseconds();
+        for (uint32_t Idx = 0; Idx < BENCH_INPUT_COUNT; ++Idx)
+        {
+            Outputs[Idx] = Function(Inputs[Idx]);
+        }
+        Samples[Run] = OSGetTimeNanoseconds() - Start;
+
+        BenchSink += (uint64_t)Outputs[Run];
+    }
+
+    bench_stats Result = BenchGetStats(Samples, BENCH_RUN_COUNT);
+    return Result;
+}
+
+
+static bench_stats
+MeasureBatch(bench_batch_function *Function)
+{
+    uint64_t Samples[BENCH_RUN_COUNT];
+
+    for (uint32_t Run = 0; Run < BENCH_RUN_COUNT; ++Run)
+    {
+        uint64_t Start = OSGetTimeNanoseconds();
+        Function(Inputs, Outputs, BENCH_INPUT_COUNT);
+        Samples[Run] = OSGetTimeNanoseconds() - Start;
+
+        BenchSink += (uint64_t)Outputs[Run];
+    }
+
+    bench_stats Result = BenchGetStats(Samples, BENCH_RUN_COUNT);
+    return Result;
+}
+
+
+static float
+GetSweepInput(bench_accuracy_case *Case, uint64_t Idx, uint64_t Count)
+{
+    float Result;
+
+    if (Case->SweepBits)
+    {
+        uint32_t Smallest = 0x00800000u;
+        uint32_t Largest  = 0x7F7FFFFFu;
+        uint32_t Bits     = Smallest + (uint32_t)((double)Idx / (double)(Count - 1) * (double)(Largest - Smallest));
+
+        memcpy(&Result, &Bits, sizeof(float));
+    }
+    else
+    {
+        Result = (float)((double)Case->Min + ((double)Case->Max - (double)Case->Min) * (double)Idx / (double)(Count - 1));
+    }
+
+    return Result;
+}
+
+
+static double
+MeasureError(bench_accuracy_case *Case, bench_scalar_function *Function)
+{
+    double Result = 0.0;
+
+    for (uint64_t Idx = 0; Idx < BENCH_SWEEP_COUNT; ++Idx)
+    {
+        float  X         = GetSweepInput(Case, Idx, BENCH_SWEEP_COUNT);
+        double Reference = Case->Reference((double)X);
+        double Error     = fabs((double)Function(X) - Reference);
+
+        // Relative error is meaningless at the poles of tan.
+        if (Case->Error == BenchError_Relative)
+        {
+            Error = fabs(Reference) < 1e30 && Reference != 0.0 ? Error / fabs(Reference) : 0.0;
+        }
+        else if (Case->Error == BenchError_AbsolutePlusUlp)
+        {
+            float Rounded = (float)Reference;
+            Error = fmax(Error - fabs((double)nextafterf(Rounded, INFINITY) - (double)Rounded), 0.0);
+        }
+
+        Result = fmax(Result, Error);
+    }
+
+    return Result;
+}
+
+
+int
+main(void)
+{
+    memory_arena *Arena = BenchCreateArena(MiB(64));
+
+    Inputs  = PushArray(Arena, float, BENCH_INPUT_COUNT);
+    Outputs = PushArray(Arena, float, BENCH_INPUT_COUNT);
+
+    bench_speed_case SpeedCases[] =
+    {
+        { "rsqrt", LibmRsqrt, FastRsqrt, FastRsqrtBatch,  0.01f,  100.f   },
+        { "sin",   sinf,      FastSin,   FastSinBatch,   -100.f,  100.f   },
+        { "cos",   cosf,      FastCos,   FastCosBatch,   -100.f,  100.f   },
+        { "tan",   tanf,      FastTan,   FastTanBatch,   -1.5f,   1.5f    },
+        { "exp2",  exp2f,     FastExp2,  FastExp2Batch,  -126.f,  127.99f },
+        { "log2",  log2f,     FastLog2,  FastLog2Batch,   0.01f,  100.f   },
+    };
+
+    bench_accuracy_case AccuracyCases[] =
+    {
+        { "rsqrt", LibmRsqrt, FastRsqrt, ReferenceRsqrt,  0.f,      0.f,     true,  BenchError_Relative,        4e-7 },
+        { "sin",   sinf,      FastSin,   sin,      -39000.f,  39000.f, false, BenchError_Absolute,        2e-7 },
+        { "cos",   cosf,      FastCos,   cos,      -39000.f,  39000.f, false, BenchError_Absolute,        2e-7 },
+        { "tan",   tanf,      FastTan,   tan,      -39000.f,  39000.f, false, BenchError_Relative,        4e-7 },
+        { "exp2",  exp2f,     FastExp2,  exp2,     -126.f,    127.99f, false, BenchError_Relative,        2e-7 },
+        { "log2",  log2f,     FastLog2,  log2,      0.5f,     1.9999f, false, BenchError_Absolute,        2e-7 },
+        { "log2",  log2f,     FastLog2,  log2,      0.f,      0.f,     true,  BenchError_AbsolutePlusUlp, 1e-7 },
+    };
+
+    srand(1);
+
+    printf("%u inputs per run; ns per call (speedup over libm)\n", BENCH_INPUT_COUNT);
+    printf("%-8s %10s %18s %18s\n", "", "libm", "Fast*", "Fast*Batch");
+
+    for (uint32_t CaseIdx = 0; CaseIdx < ArrayCount(SpeedCases); ++CaseIdx)
+    {
+        bench_speed_case *Case = SpeedCases + CaseIdx;
+
+        for (uint32_t Idx = 0; Idx < BENCH_INPUT_COUNT; ++Idx)
+        {
+            Inputs[Idx] = Case->Min + (Case->Max - Case->Min) * ((float)rand() / (float)RAND_MAX);
+        }
+
+        bench_stats Libm  = MeasureScalar(Case->Libm);
+        bench_stats Fast  = MeasureScalar(Case->Fast);
+        bench_stats Batch = MeasureBatch(Case->Batch);
+
+        double LibmNanos  = (double)Libm.P50Nanoseconds / BENCH_INPUT_COUNT;
+        double FastNanos  = (double)Fast.P50Nanoseconds / BENCH_INPUT_COUNT;
+        double BatchNanos = (double)Batch.P50Nanoseconds / BENCH_INPUT_COUNT;
+
+        printf("%-8s %10.2f %10.2f (%4.1fx) %10.2f (%4.1fx)\n", Case->Name, LibmNanos,
+               FastNanos, LibmNanos / FastNanos, BatchNanos, LibmNanos / BatchNanos);
+    }
+
+    printf("\nLargest error over %u evenly spaced inputs, against double precision\n", BENCH_SWEEP_COUNT);
+    printf("%-8s %-26s %12s %12s   %s\n", "", "domain", "libm float", "Fast*", "stated bound");
+
+    for (uint32_t CaseIdx = 0; CaseIdx < ArrayCount(AccuracyCases); ++CaseIdx)
+    {
+        bench_accuracy_case *Case = AccuracyCases + CaseIdx;
+        char                 Domain[64];
+
+        if (Case->SweepBits)
+        {
+            snprintf(Domain, sizeof(Domain), "positive normal floats");
+        }
+        else
+        {
+            snprintf(Domain, sizeof(Domain), "[%g, %g]", Case->Min, Case->Max);
+        }
+
+        const char *Kinds[] = { "abs", "rel", "abs, past 1 ulp," };
+
+        double LibmError = MeasureError(Case, Case->Libm);
+        double FastError = MeasureError(Case, Case->Fast);
+
+        printf("%-8s %-26s %12.3g %12.3g   %s < %.0e%s\n", Case->Name, Domain, LibmError, FastError,
+               Kinds[Case->Error], Case->Bound, FastError < Case->Bound ? "" : "  EXCEEDED");
+    }
+
+    return 0;
+}
@@ -0,0 +1,235 @@
+// A camera flying a serpentine path over the streaming world, crossing a chunk
+// boundary every 8 frames. Every frame runs UpdateWorld, DrawWorld and the merge and
+// sort the backend does, as UpdateEngine would. Reported per world size: frame time
+// over all frames and over the frames where the camera entered a new chunk, the
+// bytes uploaded per frame against UploadBudget, and the buffer memory held by the
+// null renderer after warmup and at the end of the flight, which should not grow.
+// Chunks are built on the calling thread when there is no work queue, so those rows
+// show the cost the background jobs take off the frame. Frames are 1 ms apart, the
+// time a paced frame loop would leave the workers; the gap is not timed.
+
+#include <math.h>
+#include <stdio.h>
+
+#include "bench.h"
+#include "null_renderer.h"
+#include "engine/rendering/renderer.h"
+#include "game/world/world.h"
+
+
+#define BENCH_FRAME_COUNT   4000
+#define BENCH_WARMUP_FRAMES 4000
+#define BENCH_FRAME_GAP_MS  1
+#define BENCH_SPEED         2.f
+#define BENCH_LANE_LENGTH   1024.f
+#define BENCH_LANE_SPACING  48.f
+#define BENCH_HEIGHT        60.f
+
+
+typedef struct
+{
+    const char   *Name;
+    world_params  Params;
+} bench_world_case;
+
+
+typedef struct
+{
+    bench_stats Frame;
+    bench_stats Boundary;
+    uint64_t    UploadedBytes;
+    uint64_t    MaxUploadBytes;
+    uint32_t    OverBudgetFrames;
+    uint32_t    Loaded;
+    uint32_t    MaxResident;
+    uint64_t    WarmLiveBytes;
+    uint64_t    EndLiveBytes;
+} bench_flight_result;
+
+
+static uint64_t FrameSamples[BENCH_FRAME_COUNT];
+static uint64_t BoundarySamples[BENCH_FRAME_COUNT];
+
+
+// Lanes along X, joined by short legs along Y, so the camera crosses chunk borders on
+// both axes.
+static vec3
+GetFlightPosition(uint32_t Frame)
+{
+    float Distance = (float)Frame * BENCH_SPEED;
+    float Segment  = BENCH_LANE_LENGTH + BENCH_LANE_SPACING;
+    float Lane     = floorf(Distance / Segment);
+    float Along    = Distance - Lane * Segment;
+    bool  Forward  = fmodf(Lane, 2.f) == 0.f;
+
+    vec3 Result = Vec3(0.f, Lane * BENCH_LANE_SPACING, -BENCH_HEIGHT);
+
+    if (Along < BENCH_LANE_LENGTH)
+    {
+        Result.X = Forward ? Along : BENCH_LANE_LENGTH - Along;
+    }
+    else
+    {
+        Result.X  = Forward ? BENCH_LANE_LENGTH : 0.f;
+        Result.Y += Along - BENCH_LANE_LENGTH;
+    }
+
+    return Result;
+}
+
+
+static void
+RunFrame(uint32_t Frame, camera *Camera, world *World, renderer *Renderer, memory_arena *Arena, engine_memory *EngineMemory)
+{
+    memory_region Region   = EnterMemoryRegion(Arena);
+    vec3          Position = GetFlightPosition(Frame);
+
+    SetCameraPosition(Position, Camera);
+
+    UpdateWorld(Position, World, Renderer, Arena, EngineMemory);
+    DrawWorld(Camera, World, Renderer, Arena, EngineMemory);
+
+    render_pass_list PassList = BuildRenderPassList(Renderer->Contexts, RENDER_MAX_CONTEXTS, 0, Arena);
+    BenchSink += (uint64_t)(uintptr_t)PassList.First;
+
+    LeaveMemoryRegion(Region);
+}
+
+
+// Every run gets state memory and a renderer of its own, as the engine sets them up:
+// the world has no destroy call, so the chunks of the last run stay resident in the
+// old renderer.
+static bench_flight_result
+Fly(world_params Params, memory_arena *Arena, engine_memory *EngineMemory)
+{
+    bench_flight_result Result   = {0};
+    memory_arena       *State    = BenchCreateArena(MiB(64));
+    renderer           *Renderer = CreateNullRenderer(State);
+    world              *World    = CreateWorld(Params, State);
+    camera              Camera   = CreateCamera(GetFlightPosition(0), 60.f, 16.f / 9.f);
+
+    uint64_t StartLiveBytes = GetNullRendererStats().LiveBytes;
+
+    // Hovering over the start until the load radius is filled.
+    uint32_t LoadSide = 2 * Params.LoadRadius + 1;
+
+    for (uint32_t Frame = 0; Frame < BENCH_WARMUP_FRAMES && World->ChunkCount < LoadSide * LoadSide; ++Frame)
+    {
+        RunFrame(0, &Camera, World, Renderer, Arena, EngineMemory);
+        BenchSleepMilliseconds(BENCH_FRAME_GAP_MS);
+    }
+
+    Result.WarmLiveBytes = GetNullRendererStats().LiveBytes - StartLiveBytes;
+
+    uint32_t BoundaryCount = 0;
+
+    for (uint32_t Frame = 0; Frame < BENCH_FRAME_COUNT; ++Frame)
+    {
+        vec3 Previous = GetFlightPosition(Frame);
+        vec3 Position = GetFlightPosition(Frame + 1);
+        bool Crossed  = floorf(Previous.X / CHUNK_SIZE_X) != floorf(Position.X / CHUNK_SIZE_X) ||
+                        floorf(Previous.Y / CHUNK_SIZE_Y) != floorf(Position.Y / CHUNK_SIZE_Y);
+
+        uint64_t Start = OSGetTimeNanoseconds();
+        RunFrame(Frame + 1, &Camera, World, Renderer, Arena, EngineMemory);
+        uint64_t Elapsed = OSGetTimeNanoseconds() - Start;
+
+        BenchSleepMilliseconds(BENCH_FRAME_GAP_MS);
+
+        FrameSamples[Frame] = Elapsed;
+        if (Crossed)
+        {
+            BoundarySamples[BoundaryCount++] = Elapsed;
+        }
+
+        uint64_t Uploaded = World->Stats.UploadedBytes;
+
+        Result.UploadedBytes  += Uploaded;
+        Result.MaxUploadBytes  = Maximum(Result.MaxUploadBytes, Uploaded);
+        Result.Loaded         += World->Stats.Loaded;
+        Result.MaxResident     = Maximum(Result.MaxResident, World->ChunkCount);
+
+        // The budget can only be passed by the one chunk every frame may upload.
+        if (Uploaded > Params.UploadBudget)
+        {
+            Result.OverBudgetFrames += 1;
+        }
+    }
+
+    Result.EndLiveBytes = GetNullRendererStats().LiveBytes - StartLiveBytes;
+    Result.Frame        = BenchGetStats(FrameSamples, BENCH_FRAME_COUNT);
+    Result.Boundary     = BenchGetStats(BoundarySamples, BoundaryCount);
+
+    return Result;
+}
+
+
+static void
+PrintFlight(const char *Name, bench_flight_result *Result)
+{
+    printf("%-28s %8.3f %8.3f %8.3f %10.3f %10.3f %9.1f %9.1f %6u %7u %6u %8.2f %8.2f\n", Name,
+           Result->Frame.P50Nanoseconds / 1e6, Result->Frame.P99Nanoseconds / 1e6, Result->Frame.MaxNanoseconds / 1e6,
+           Result->Boundary.P50Nanoseconds / 1e6, Result->Boundary.P99Nanoseconds / 1e6,
+           (double)Result->UploadedBytes / BENCH_FRAME_COUNT / 1024.0, Result->MaxUploadBytes / 1024.0,
+           Result->OverBudgetFrames, Result->Loaded, Result->MaxResident,
+           Result->WarmLiveBytes / (1024.0 * 1024.0), Result->EndLiveBytes / (1024.0 * 1024.0));
+}
+
+
+int
+main(void)
+{
+    memory_arena *Arena = BenchCreateArena(GiB(1));
+
+    bench_world_case Cases[] =
+    {
+        {
+            "radius 4 (engine)",
+            { .Mesh = ChunkMesh_Greedy, .LoadRadius = 4, .UnloadRadius = 5, .BuildJobCount = 8, .UploadBudget = KiB(64), .Seed = 1 },
+        },
+        {
+            "radius 12",
+            { .Mesh = ChunkMesh_Greedy, .LoadRadius = 12, .UnloadRadius = 14, .BuildJobCount = 16, .UploadBudget = KiB(256), .Seed = 1 },
+        },
+    };
+
+    float Travelled = BENCH_FRAME_COUNT * BENCH_SPEED;
+
+    printf("%u frames, %.0f tiles flown (%.0f chunk lengths), %.0f tiles above the ground\n", BENCH_FRAME_COUNT, Travelled,
+           Travelled / CHUNK_SIZE_X, BENCH_HEIGHT);
+    printf("%-28s %26s %21s %19s %6s %7s %6s %17s\n", "", "frame (ms)", "boundary frame (ms)", "upload (KiB)", "over", "loaded",
+           "max", "buffers (MiB)");
+    printf("%-28s %8s %8s %8s %10s %10s %9s %9s %6s %7s %6s %8s %8s\n", "", "p50", "p99", "max", "p50", "p99", "mean", "max",
+           "budget", "chunks", "chunks", "warm", "end");
+
+    uint32_t WorkerCounts[32];
+    uint32_t WorkerCountCount = BenchGetWorkerCounts(WorkerCounts, ArrayCount(WorkerCounts));
+
+    for (uint32_t CaseIdx = 0; CaseIdx < ArrayCount(Cases); ++CaseIdx)
+    {
+        bench_world_case *Case = Cases + CaseIdx;
+        char              Name[64];
+
+        bench_flight_result Inline = Fly(Case->Params, Arena, 0);
+
+        snprintf(Name, sizeof(Name), "%s, inline", Case->Name);
+        PrintFlight(Name, &Inline);
+
+        engine_memory *EngineMemory = BenchStartWorkers(WorkerCounts[WorkerCountCount - 1], Arena);
+        if (EngineMemory)
+        {
+            bench_flight_result Background = Fly(Case->Params, Arena, EngineMemory);
+
+            snprintf(Name, sizeof(Name), "%s, workers: %u", Case->Name, EngineMemory->WorkerCount);
+            PrintFlight(Name, &Background);
+
+            BenchStopWorkers(EngineMemory);
+        }
+        else
+        {
+            printf("(background builds need the Win32 work queue, skipped)\n");
+        }
+    }
+
+    return 0;
+}
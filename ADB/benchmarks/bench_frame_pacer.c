@@ -0,0 +1,134 @@
+// Frame times of the main loop's pacing, with a simulated frame that busy-waits for
+// a jittered 2-6 ms. The old loop ended every frame with Sleep(8); the pacer either
+// runs unlocked or sleeps to a 60/120 Hz deadline and spins the rest. A frame
+// "misses" when it runs more than 0.5 ms past its target.
+
+#include <stdio.h>
+
+#include "bench.h"
+
+#if defined(_WIN32)
+#define WIN32_LEAN_AND_MEAN
+#include <Windows.h>
+#include "platform/win32_frame_pacer.h"
+#endif
+
+
+#define BENCH_FRAME_COUNT       600
+#define BENCH_WORK_MIN_NANOS    2000000ull
+#define BENCH_WORK_JITTER_NANOS 4000000ull
+#define BENCH_MISS_SLACK_NANOS  500000ull
+
+
+#if defined(_WIN32)
+
+typedef enum
+{
+    BenchPacing_Sleep8,
+    BenchPacing_Pacer,
+} bench_pacing;
+
+
+static uint32_t
+NextRandom(uint32_t *State)
+{
+    *State = *State * 1664525u + 1013904223u;
+    return *State >> 8;
+}
+
+
+// Same seed for every mode, so each one sees the same sequence of frame costs.
+static void
+SimulateFrameWork(uint32_t *Seed)
+{
+    uint64_t Work  = BENCH_WORK_MIN_NANOS + (NextRandom(Seed) % (BENCH_WORK_JITTER_NANOS + 1));
+    uint64_t Start = OSGetTimeNanoseconds();
+
+    while (OSGetTimeNanoseconds() - Start < Work)
+    {
+        CPUPause();
+    }
+}
+
+
+static void
+MeasurePacing(const char *Name, bench_pacing Pacing, uint64_t TargetNanoseconds)
+{
+    static uint64_t Samples[BENCH_FRAME_COUNT];
+
+    win32_frame_pacer Pacer = {0};
+    if (Pacing == BenchPacing_Pacer)
+    {
+        Win32InitializeFramePacer(&Pacer, TargetNanoseconds);
+    }
+
+    uint32_t Seed       = 1234;
+    uint32_t MissCount  = 0;
+    uint64_t FrameStart = OSGetTimeNanoseconds();
+    uint64_t RunStart   = FrameStart;
+
+    for (uint32_t Frame = 0; Frame < BENCH_FRAME_COUNT; ++Frame)
+    {
+        SimulateFrameWork(&Seed);
+
+        if (Pacing == BenchPacing_Sleep8)
+        {
+            Sleep(8);
+        }
+        else
+        {
+            Win32EndFrame(&Pacer);
+        }
+
+        uint64_t Now = OSGetTimeNanoseconds();
+        Samples[Frame] = Now - FrameStart;
+        FrameStart     = Now;
+
+        if (TargetNanoseconds && Samples[Frame] > TargetNanoseconds + BENCH_MISS_SLACK_NANOS)
+        {
+            MissCount += 1;
+        }
+    }
+
+    double Seconds = (double)(OSGetTimeNanoseconds() - RunStart) / 1e9;
+
+    if (Pacing == BenchPacing_Pacer)
+    {
+        Win32ShutdownFramePacer(&Pacer);
+    }
+
+    bench_stats Stats = BenchGetStats(Samples, BENCH_FRAME_COUNT);
+
+    printf("%-28s %8.1f %10.2f %10.2f %10.2f %10.2f", Name, BENCH_FRAME_COUNT / Seconds,
+           Stats.P50Nanoseconds / 1e6, Stats.P99Nanoseconds / 1e6, Stats.MaxNanoseconds / 1e6,
+           (double)(Stats.P99Nanoseconds - Stats.MinNanoseconds) / 1e6);
+
+    if (TargetNanoseconds)
+    {
+        printf(" %8u", MissCount);
+    }
+
+    printf("\n");
+}
+
+#endif
+
+
+int
+main(void)
+{
+#if defined(_WIN32)
+    printf("%u frames of %.1f-%.1f ms simulated work\n", BENCH_FRAME_COUNT,
+           BENCH_WORK_MIN_NANOS / 1e6, (BENCH_WORK_MIN_NANOS + BENCH_WORK_JITTER_NANOS) / 1e6);
+    printf("%-28s %8s %10s %10s %10s %10s %8s\n", "", "fps", "p50 (ms)", "p99 (ms)", "max (ms)", "p99-min", "misses");
+
+    MeasurePacing("Sleep(8) (old loop)",   BenchPacing_Sleep8, 0);
+    MeasurePacing("pacer, unlocked",       BenchPacing_Pacer,  0);
+    MeasurePacing("pacer, 120 Hz",         BenchPacing_Pacer,  8333333ull);
+    MeasurePacing("pacer, 60 Hz",          BenchPacing_Pacer,  16666667ull);
+#else
+    printf("bench_frame_pacer needs the Win32 frame pacer, skipped\n");
+#endif
+
+    return 0;
+}
@@ -0,0 +1,202 @@
+// Greedy chunk meshing against one quad per tile, over tile patterns from best to
+// worst case. For each pattern: quads emitted, vertex bytes uploaded, and the time
+// BuildChunkMesh takes per 16x16 chunk. The checkerboard has no two equal neighbours,
+// so greedy meshing finds nothing to merge and only pays for the search.
+
+#include <stdio.h>
+#include <string.h>
+
+#include "bench.h"
+#include "game/world/chunk.h"
+
+
+#define BENCH_CHUNK_COUNT 64
+#define BENCH_RUN_COUNT   25
+
+
+typedef uint8_t bench_tile_pattern(uint32_t X, uint32_t Y);
+
+
+static uint32_t
+HashTile(uint32_t Value)
+{
+    Value ^= Value >> 16;
+    Value *= 0x7FEB352Du;
+    Value ^= Value >> 15;
+    Value *= 0x846CA68Bu;
+    Value ^= Value >> 16;
+
+    return Value;
+}
+
+
+static uint8_t
+PatternUniform(uint32_t X, uint32_t Y)
+{
+    Unused(X);
+    Unused(Y);
+
+    return 0;
+}
+
+
+static uint8_t
+PatternStripes(uint32_t X, uint32_t Y)
+{
+    Unused(X);
+
+    uint8_t Result = (uint8_t)(Y & 1);
+    return Result;
+}
+
+
+static uint8_t
+PatternRandom(uint32_t X, uint32_t Y)
+{
+    uint8_t Result = (uint8_t)(HashTile(Y * 4096 + X) % 4);
+    return Result;
+}
+
+
+static uint8_t
+PatternCheckerboard(uint32_t X, uint32_t Y)
+{
+    uint8_t Result = (uint8_t)((X ^ Y) & 1);
+    return Result;
+}
+
+
+// Four terrain types in 8x8 tile cells, so blobs straddle chunk borders like a map.
+static uint8_t
+PatternTerrain(uint32_t X, uint32_t Y)
+{
+    uint32_t CellX  = X >> 3;
+    uint32_t CellY  = Y >> 3;
+    uint8_t  Result = (uint8_t)(HashTile(CellX * 73856093u ^ CellY * 19349663u) % 4);
+
+    return Result;
+}
+
+
+// The terrain with a single random tile in each 4x4 block, like scattered props.
+static uint8_t
+PatternTerrainProps(uint32_t X, uint32_t Y)
+{
+    uint8_t Result = PatternTerrain(X, Y);
+
+    if ((HashTile(Y * 4096 + X) & 15) == 0)
+    {
+        Result = (uint8_t)(4 + (X & 3));
+    }
+
+    return Result;
+}
+
+
+typedef struct
+{
+    const char         *Name;
+    bench_tile_pattern *Pattern;
+} bench_pattern_case;
+
+
+typedef struct
+{
+    bench_stats Stats;
+    uint64_t    QuadCount;
+    uint64_t    VertexBytes;
+} bench_mesh_result;
+
+
+static bench_mesh_result
+MeasureMeshing(chunk *Chunks, ChunkMesh_Type Mesh, memory_arena *Arena)
+{
+    bench_mesh_result Result = {0};
+    uint64_t          Samples[BENCH_RUN_COUNT];
+
+    for (uint32_t Idx = 0; Idx < BENCH_CHUNK_COUNT; ++Idx)
+    {
+        Chunks[Idx].Mesh = Mesh;
+    }
+
+    for (uint32_t Run = 0; Run < BENCH_RUN_COUNT; ++Run)
+    {
+        memory_region Region = EnterMemoryRegion(Arena);
+
+        uint64_t Start = OSGetTimeNanoseconds();
+        for (uint32_t Idx = 0; Idx < BENCH_CHUNK_COUNT; ++Idx)
+        {
+            chunk_mesh_data Data = BuildChunkMesh(Chunks + Idx, Arena);
+            BenchSink += (uint64_t)(uintptr_t)Data.Vertices;
+        }
+        Samples[Run] = OSGetTimeNanoseconds() - Start;
+
+        LeaveMemoryRegion(Region);
+    }
+
+    for (uint32_t Idx = 0; Idx < BENCH_CHUNK_COUNT; ++Idx)
+    {
+        Result.QuadCount   += Chunks[Idx].QuadCount;
+        Result.VertexBytes += Chunks[Idx].VertexCount * sizeof(tile_vertex_packed);
+    }
+
+    Result.Stats = BenchGetStats(Samples, BENCH_RUN_COUNT);
+    return Result;
+}
+
+
+int
+main(void)
+{
+    memory_arena *Arena  = BenchCreateArena(MiB(256));
+    chunk        *Chunks = PushArray(Arena, chunk, BENCH_CHUNK_COUNT);
+
+    bench_pattern_case Cases[] =
+    {
+        { "uniform",                   PatternUniform      },
+        { "terrain, 8x8 blobs",        PatternTerrain      },
+        { "terrain with props",        PatternTerrainProps },
+        { "stripes (one row each)",    PatternStripes      },
+        { "random, 4 types",           PatternRandom       },
+        { "checkerboard (worst case)", PatternCheckerboard },
+    };
+
+    uint32_t TileCount = BENCH_CHUNK_COUNT * CHUNK_SIZE_X * CHUNK_SIZE_Y;
+
+    printf("%u chunks of %ux%u tiles (%u tiles), times are per chunk\n", BENCH_CHUNK_COUNT, CHUNK_SIZE_X, CHUNK_SIZE_Y, TileCount);
+    printf("%-28s %8s %10s %12s %12s %12s %14s\n", "", "quads", "fewer", "KiB upload", "greedy (us)", "p99 (us)", "per tile (us)");
+
+    for (uint32_t CaseIdx = 0; CaseIdx < ArrayCount(Cases); ++CaseIdx)
+    {
+        bench_pattern_case *Case = Cases + CaseIdx;
+
+        // An 8x8 block of chunks, tiles addressed in world coordinates.
+        for (uint32_t Idx = 0; Idx < BENCH_CHUNK_COUNT; ++Idx)
+        {
+            uint32_t OriginX = (Idx % 8) * CHUNK_SIZE_X;
+            uint32_t OriginY = (Idx / 8) * CHUNK_SIZE_Y;
+
+            Chunks[Idx] = MakeChunk(ChunkMesh_Greedy, Vec3((float)OriginX, (float)OriginY, 0.f));
+
+            for (uint32_t Y = 0; Y < CHUNK_SIZE_Y; ++Y)
+            {
+                for (uint32_t X = 0; X < CHUNK_SIZE_X; ++X)
+                {
+                    Chunks[Idx].Tiles[Y * CHUNK_SIZE_X + X].Data = Case->Pattern(OriginX + X, OriginY + Y);
+                }
+            }
+        }
+
+        bench_mesh_result PerTile = MeasureMeshing(Chunks, ChunkMesh_Vertices, Arena);
+        bench_mesh_result Greedy  = MeasureMeshing(Chunks, ChunkMesh_Greedy, Arena);
+
+        printf("%-28s %8llu %9.1fx %12.1f %12.2f %12.2f %14.2f\n", Case->Name, (unsigned long long)Greedy.QuadCount,
+               (double)PerTile.QuadCount / (double)Greedy.QuadCount, Greedy.VertexBytes / 1024.0,
+               Greedy.Stats.P50Nanoseconds / 1e3 / BENCH_CHUNK_COUNT, Greedy.Stats.P99Nanoseconds / 1e3 / BENCH_CHUNK_COUNT,
+               PerTile.Stats.P50Nanoseconds / 1e3 / BENCH_CHUNK_COUNT);
+    }
+
+    printf("\nOne quad per tile always uploads %u quads, %.1f KiB.\n", TileCount, TileCount * 4 * sizeof(tile_vertex_packed) / 1024.0);
+
+    return 0;
+}
@@ -0,0 +1,450 @@
+// The SSE matrix library against the plain C it replaces: one float loop per
+// element for multiply and transform, cofactor expansion for the inverse. Each run
+// goes over 4096 random matrices (1M points for the batch transforms). The last table
+// is the largest absolute error of both paths against a double precision reference.
+
+#include <math.h>
+#include <stdio.h>
+#include <stdlib.h>
+
+#include "bench.h"
+#include "engine/math/matrix.h"
+
+
+#define BENCH_MATRIX_COUNT 4096
+#define BENCH_POINT_COUNT  (1u << 20)
+#define BENCH_RUN_COUNT    25
+
+
+static float *
+Mat4Elements(mat4x4 *M)
+{
+    float *Result = &M->c0r0;
+    return Result;
+}
+
+
+// ==============================================
+// <Scalar Reference>
+// ==============================================
+
+
+static mat4x4
+ScalarMultiply(mat4x4 A, mat4x4 B)
+{
+    mat4x4 Result;
+    float *R = Mat4Elements(&Result);
+    float *X = Mat4Elements(&A);
+    float *Y = Mat4Elements(&B);
+
+    for (uint32_t Column = 0; Column < 4; ++Column)
+    {
+        for (uint32_t Row = 0; Row < 4; ++Row)
+        {
+            float Sum = 0.f;
+            for (uint32_t K = 0; K < 4; ++K)
+            {
+                Sum += X[K * 4 + Row] * Y[Column * 4 + K];
+            }
+
+            R[Column * 4 + Row] = Sum;
+        }
+    }
+
+    return Result;
+}
+
+
+static mat4x4
+ScalarTranspose(mat4x4 M)
+{
+    mat4x4 Result;
+    float *R = Mat4Elements(&Result);
+    float *X = Mat4Elements(&M);
+
+    for (uint32_t Column = 0; Column < 4; ++Column)
+    {
+        for (uint32_t Row = 0; Row < 4; ++Row)
+        {
+            R[Column * 4 + Row] = X[Row * 4 + Column];
+        }
+    }
+
+    return Result;
+}
+
+
+// The usual 2x2 sub-determinant expansion, on the column-major element array.
+static mat4x4
+ScalarInverse(mat4x4 M)
+{
+    float *m = Mat4Elements(&M);
+    float  Inv[16];
+
+    Inv[0]  =  m[5] * m[10] * m[15] - m[5] * m[11] * m[14] - m[9] * m[6] * m[15] + m[9] * m[7] * m[14] + m[13] * m[6] * m[11] - m[13] * m[7] * m[10];
+    Inv[4]  = -m[4] * m[10] * m[15] + m[4] * m[11] * m[14] + m[8] * m[6] * m[15] - m[8] * m[7] * m[14] - m[12] * m[6] * m[11] + m[12] * m[7] * m[10];
+    Inv[8]  =  m[4] * m[9]  * m[15] - m[4] * m[11] * m[13] - m[8] * m[5] * m[15] + m[8] * m[7] * m[13] + m[12] * m[5] * m[11] - m[12] * m[7] * m[9];
+    Inv[12] = -m[4] * m[9]  * m[14] + m[4] * m[10] * m[13] + m[8] * m[5] * m[14] - m[8] * m[6] * m[13] - m[12] * m[5] * m[10] + m[12] * m[6] * m[9];
+    Inv[1]  = -m[1] * m[10] * m[15] + m[1] * m[11] * m[14] + m[9] * m[2] * m[15] - m[9] * m[3] * m[14] - m[13] * m[2] * m[11] + m[13] * m[3] * m[10];
+    Inv[5]  =  m[0] * m[10] * m[15] - m[0] * m[11] * m[14] - m[8] * m[2] * m[15] + m[8] * m[3] * m[14] + m[12] * m[2] * m[11] - m[12] * m[3] * m[10];
+    Inv[9]  = -m[0] * m[9]  * m[15] + m[0] * m[11] * m[13] + m[8] * m[1] * m[15] - m[8] * m[3] * m[13] - m[12] * m[1] * m[11] + m[12] * m[3] * m[9];
+    Inv[13] =  m[0] * m[9]  * m[14] - m[0] * m[10] * m[13] - m[8] * m[1] * m[14] + m[8] * m[2] * m[13] + m[12] * m[1] * m[10] - m[12] * m[2] * m[9];
+    Inv[2]  =  m[1] * m[6]  * m[15] - m[1] * m[7]  * m[14] - m[5] * m[2] * m[15] + m[5] * m[3] * m[14] + m[13] * m[2] * m[7]  - m[13] * m[3] * m[6];
+    Inv[6]  = -m[0] * m[6]  * m[15] + m[0] * m[7]  * m[14] + m[4] * m[2] * m[15] - m[4] * m[3] * m[14] - m[12] * m[2] * m[7]  + m[12] * m[3] * m[6];
+    Inv[10] =  m[0] * m[5]  * m[15] - m[0] * m[7]  * m[13] - m[4] * m[1] * m[15] + m[4] * m[3] * m[13] + m[12] * m[1] * m[7]  - m[12] * m[3] * m[5];
+    Inv[14] = -m[0] * m[5]  * m[14] + m[0] * m[6]  * m[13] + m[4] * m[1] * m[14] - m[4] * m[2] * m[13] - m[12] * m[1] * m[6]  + m[12] * m[2] * m[5];
+    Inv[3]  = -m[1] * m[6]  * m[11] + m[1] * m[7]  * m[10] + m[5] * m[2] * m[11] - m[5] * m[3] * m[10] - m[9]  * m[2] * m[7]  + m[9]  * m[3] * m[6];
+    Inv[7]  =  m[0] * m[6]  * m[11] - m[0] * m[7]  * m[10] - m[4] * m[2] * m[11] + m[4] * m[3] * m[10] + m[8]  * m[2] * m[7]  - m[8]  * m[3] * m[6];
+    Inv[11] = -m[0] * m[5]  * m[11] + m[0] * m[7]  * m[9]  + m[4] * m[1] * m[11] - m[4] * m[3] * m[9]  - m[8]  * m[1] * m[7]  + m[8]  * m[3] * m[5];
+    Inv[15] =  m[0] * m[5]  * m[10] - m[0] * m[6]  * m[9]  - m[4] * m[1] * m[10] + m[4] * m[2] * m[9]  + m[8]  * m[1] * m[6]  - m[8]  * m[2] * m[5];
+
+    mat4x4 Result = {0};
+    float *R      = Mat4Elements(&Result);
+    float  Det    = m[0] * Inv[0] + m[1] * Inv[4] + m[2] * Inv[8] + m[3] * Inv[12];
+
+    if (Det != 0.f)
+    {
+        for (uint32_t Idx = 0; Idx < 16; ++Idx)
+        {
+            R[Idx] = Inv[Idx] / Det;
+        }
+    }
+
+    return Result;
+}
+
+
+static vec3
+ScalarTransformPoint(mat4x4 *M, vec3 Point)
+{
+    vec3 Result =
+    {
+        .X = M->c0r0 * Point.X + M->c1r0 * Point.Y + M->c2r0 * Point.Z + M->c3r0,
+        .Y = M->c0r1 * Point.X + M->c1r1 * Point.Y + M->c2r1 * Point.Z + M->c3r1,
+        .Z = M->c0r2 * Point.X + M->c1r2 * Point.Y + M->c2r2 * Point.Z + M->c3r2,
+    };
+
+    return Result;
+}
+
+
+// ==============================================
+// <Workloads>
+// ==============================================
+
+
+typedef struct
+{
+    mat4x4 *A;
+    mat4x4 *B;
+    mat4x4 *Out;
+    vec3   *Points;
+    vec3   *Transformed;
+} bench_matrix_data;
+
+
+typedef void bench_matrix_workload(bench_matrix_data *Data);
+
+
+static void
+RunScalarMultiply(bench_matrix_data *Data)
+{
+    for (uint32_t Idx = 0; Idx < BENCH_MATRIX_COUNT; ++Idx)
+    {
+        Data->Out[Idx] = ScalarMultiply(Data->A[Idx], Data->B[Idx]);
+    }
+}
+
+
+static void
+RunMultiply(bench_matrix_data *Data)
+{
+    for (uint32_t Idx = 0; Idx < BENCH_MATRIX_COUNT; ++Idx)
+    {
+        Data->Out[Idx] = Mat4Multiply(Data->A[Idx], Data->B[Idx]);
+    }
+}
+
+
+static void
+RunScalarTranspose(bench_matrix_data *Data)
+{
+    for (uint32_t Idx = 0; Idx < BENCH_MATRIX_COUNT; ++Idx)
+    {
+        Data->Out[Idx] = ScalarTranspose(Data->A[Idx]);
+    }
+}
+
+
+static void
+RunTranspose(bench_matrix_data *Data)
+{
+    for (uint32_t Idx = 0; Idx < BENCH_MATRIX_COUNT; ++Idx)
+    {
+        Data->Out[Idx] = Mat4Transpose(Data->A[Idx]);
+    }
+}
+
+
+static void
+RunScalarInverse(bench_matrix_data *Data)
+{
+    for (uint32_t Idx = 0; Idx < BENCH_MATRIX_COUNT; ++Idx)
+    {
+        Data->Out[Idx] = ScalarInverse(Data->A[Idx]);
+    }
+}
+
+
+static void
+RunInverse(bench_matrix_data *Data)
+{
+    for (uint32_t Idx = 0; Idx < BENCH_MATRIX_COUNT; ++Idx)
+    {
+        Data->Out[Idx] = Mat4Inverse(Data->A[Idx]);
+    }
+}
+
+
+static void
+RunInverseAffine(bench_matrix_data *Data)
+{
+    for (uint32_t Idx = 0; Idx < BENCH_MATRIX_COUNT; ++Idx)
+    {
+        Data->Out[Idx] = Mat4InverseAffine(Data->B[Idx]);
+    }
+}
+
+
+static void
+RunScalarTransformPoints(bench_matrix_data *Data)
+{
+    for (uint32_t Idx = 0; Idx < BENCH_POINT_COUNT; ++Idx)
+    {
+        Data->Transformed[Idx] = ScalarTransformPoint(Data->A, Data->Points[Idx]);
+    }
+}
+
+
+static void
+RunTransformPoints(bench_matrix_data *Data)
+{
+    Mat4TransformPoints(Data->A, Data->Points, Data->Transformed, BENCH_POINT_COUNT);
+}
+
+
+static bench_stats
+MeasureWorkload(bench_matrix_workload *Workload, bench_matrix_data *Data)
+{
+    uint64_t Samples[BENCH_RUN_COUNT];
+
+    Workload(Data);
+
+    for (uint32_t Run = 0; Run < BENCH_RUN_COUNT; ++Run)
+    {
+        uint64_t Start = OSGetTimeNanoseconds();
+        Workload(Data);
+        Samples[Run] = OSGetTimeNanoseconds() - Start;
+
+        BenchSink += (uint64_t)Data->Out[Run].c0r0 + (uint64_t)Data->Transformed[Run].X;
+    }
+
+    bench_stats Result = BenchGetStats(Samples, BENCH_RUN_COUNT);
+    return Result;
+}
+
+
+// ==============================================
+// <Accuracy>
+// ==============================================
+
+
+static void
+ReferenceMultiply(mat4x4 *A, mat4x4 *B, double *Out)
+{
+    float *X = Mat4Elements(A);
+    float *Y = Mat4Elements(B);
+
+    for (uint32_t Column = 0; Column < 4; ++Column)
+    {
+        for (uint32_t Row = 0; Row < 4; ++Row)
+        {
+            double Sum = 0.0;
+            for (uint32_t K = 0; K < 4; ++K)
+            {
+                Sum += (double)X[K * 4 + Row] * (double)Y[Column * 4 + K];
+            }
+
+            Out[Column * 4 + Row] = Sum;
+        }
+    }
+}
+
+
+static double
+MultiplyError(mat4x4 *A, mat4x4 *B, mat4x4 Product)
+{
+    double Reference[16];
+    ReferenceMultiply(A, B, Reference);
+
+    double Result = 0.0;
+    for (uint32_t Idx = 0; Idx < 16; ++Idx)
+    {
+        Result = fmax(Result, fabs(Reference[Idx] - Mat4Elements(&Product)[Idx]));
+    }
+
+    return Result;
+}
+
+
+// Distance of M * Inverse from identity, for matrices whose inverse stays small
+// (the error of an ill-conditioned inverse says nothing about the code).
+static double
+InverseError(mat4x4 *M, mat4x4 Inverse, bool *Counted)
+{
+    double Product[16];
+    ReferenceMultiply(M, &Inverse, Product);
+
+    double Largest = 0.0;
+    double Result  = 0.0;
+    for (uint32_t Idx = 0; Idx < 16; ++Idx)
+    {
+        Largest = fmax(Largest, fabs(Mat4Elements(&Inverse)[Idx]));
+        Result  = fmax(Result, fabs(Product[Idx] - ((Idx % 5) == 0 ? 1.0 : 0.0)));
+    }
+
+    *Counted = Largest < 50.0;
+    return *Counted ? Result : 0.0;
+}
+
+
+static void
+PrintAccuracy(bench_matrix_data *Data)
+{
+    double MultiplyErrors[2]  = {0};
+    double InverseErrors[3]   = {0};
+    double TransformErrors[2] = {0};
+    bool   Counted;
+
+    for (uint32_t Idx = 0; Idx < BENCH_MATRIX_COUNT; ++Idx)
+    {
+        mat4x4 *A = Data->A + Idx;
+        mat4x4 *B = Data->B + Idx;
+
+        MultiplyErrors[0] = fmax(MultiplyErrors[0], MultiplyError(A, B, ScalarMultiply(*A, *B)));
+        MultiplyErrors[1] = fmax(MultiplyErrors[1], MultiplyError(A, B, Mat4Multiply(*A, *B)));
+
+        InverseErrors[0] = fmax(InverseErrors[0], InverseError(A, ScalarInverse(*A), &Counted));
+        InverseErrors[1] = fmax(InverseErrors[1], InverseError(A, Mat4Inverse(*A), &Counted));
+        InverseErrors[2] = fmax(InverseErrors[2], InverseError(B, Mat4InverseAffine(*B), &Counted));
+    }
+
+    mat4x4 *M = Data->A;
+    Mat4TransformPoints(M, Data->Points, Data->Transformed, BENCH_POINT_COUNT);
+
+    for (uint32_t Idx = 0; Idx < BENCH_POINT_COUNT; ++Idx)
+    {
+        vec3   P      = Data->Points[Idx];
+        double Ref[3] =
+        {
+            (double)M->c0r0 * P.X + (double)M->c1r0 * P.Y + (double)M->c2r0 * P.Z + M->c3r0,
+            (double)M->c0r1 * P.X + (double)M->c1r1 * P.Y + (double)M->c2r1 * P.Z + M->c3r1,
+            (double)M->c0r2 * P.X + (double)M->c1r2 * P.Y + (double)M->c2r2 * P.Z + M->c3r2,
+        };
+
+        vec3 Scalar = ScalarTransformPoint(M, P);
+        vec3 Batch  = Data->Transformed[Idx];
+
+        TransformErrors[0] = fmax(TransformErrors[0], fmax(fabs(Ref[0] - Scalar.X), fmax(fabs(Ref[1] - Scalar.Y), fabs(Ref[2] - Scalar.Z))));
+        TransformErrors[1] = fmax(TransformErrors[1], fmax(fabs(Ref[0] - Batch.X),  fmax(fabs(Ref[1] - Batch.Y),  fabs(Ref[2] - Batch.Z))));
+    }
+
+    printf("\nMax absolute error against double precision (inputs in [-1, 1])\n");
+    printf("%-40s %12s %12s\n", "", "scalar", "SSE");
+    printf("%-40s %12.3g %12.3g\n", "multiply",                  MultiplyErrors[0],  MultiplyErrors[1]);
+    printf("%-40s %12.3g %12.3g\n", "inverse (|M * Inv - I|)",   InverseErrors[0],   InverseErrors[1]);
+    printf("%-40s %12s %12.3g\n",   "inverse affine",            "-",                InverseErrors[2]);
+    printf("%-40s %12.3g %12.3g\n", "transform points",          TransformErrors[0], TransformErrors[1]);
+}
+
+
+// ==============================================
+// <Entry Point>
+// ==============================================
+
+
+static float
+RandomUnit(void)
+{
+    float Result = (float)rand() / (float)RAND_MAX * 2.f - 1.f;
+    return Result;
+}
+
+
+typedef struct
+{
+    const char            *Name;
+    bench_matrix_workload *Workload;
+    double                 ItemsPerRun;
+} bench_matrix_case;
+
+
+int
+main(void)
+{
+    memory_arena *Arena = BenchCreateArena(MiB(256));
+
+    bench_matrix_data Data =
+    {
+        .A           = PushArray(Arena, mat4x4, BENCH_MATRIX_COUNT),
+        .B           = PushArray(Arena, mat4x4, BENCH_MATRIX_COUNT),
+        .Out         = PushArray(Arena, mat4x4, BENCH_MATRIX_COUNT),
+        .Points      = PushArray(Arena, vec3, BENCH_POINT_COUNT),
+        .Transformed = PushArray(Arena, vec3, BENCH_POINT_COUNT),
+    };
+
+    srand(1);
+
+    // B is affine, so it also feeds Mat4InverseAffine.
+    for (uint32_t Idx = 0; Idx < BENCH_MATRIX_COUNT; ++Idx)
+    {
+        for (uint32_t Element = 0; Element < 16; ++Element)
+        {
+            Mat4Elements(Data.A + Idx)[Element] = RandomUnit();
+            Mat4Elements(Data.B + Idx)[Element] = RandomUnit();
+        }
+
+        Data.B[Idx].c0r3 = Data.B[Idx].c1r3 = Data.B[Idx].c2r3 = 0.f;
+        Data.B[Idx].c3r3 = 1.f;
+    }
+
+    for (uint32_t Idx = 0; Idx < BENCH_POINT_COUNT; ++Idx)
+    {
+        Data.Points[Idx] = Vec3(RandomUnit(), RandomUnit(), RandomUnit());
+    }
+
+    bench_matrix_case Cases[] =
+    {
+        { "multiply, scalar",                 RunScalarMultiply,        BENCH_MATRIX_COUNT },
+        { "Mat4Multiply",                     RunMultiply,              BENCH_MATRIX_COUNT },
+        { "transpose, scalar",                RunScalarTranspose,       BENCH_MATRIX_COUNT },
+        { "Mat4Transpose",                    RunTranspose,             BENCH_MATRIX_COUNT },
+        { "inverse, scalar cofactors",        RunScalarInverse,         BENCH_MATRIX_COUNT },
+        { "Mat4Inverse",                      RunInverse,               BENCH_MATRIX_COUNT },
+        { "Mat4InverseAffine",                RunInverseAffine,         BENCH_MATRIX_COUNT },
+        { "transform points, scalar",         RunScalarTransformPoints, BENCH_POINT_COUNT  },
+        { "Mat4TransformPoints",              RunTransformPoints,       BENCH_POINT_COUNT  },
+    };
+
+    BenchPrintHeader("Matrix operations (items are matrices or points)");
+
+    for (uint32_t CaseIdx = 0; CaseIdx < ArrayCount(Cases); ++CaseIdx)
+    {
+        bench_stats Stats = MeasureWorkload(Cases[CaseIdx].Workload, &Data);
+        BenchPrintStats(Cases[CaseIdx].Name, Stats, Cases[CaseIdx].ItemsPerRun);
+    }
+
+    PrintAccuracy(&Data);
+
+    return 0;
+}
@@ -0,0 +1,242 @@
+// ParallelFor, ParallelReduce and ParallelPrefixSum over 16M elements, against the
+// plain loop they replace. Each primitive runs on the calling thread alone (no
+// engine_memory), then with 1, 2, 4... workers up to one per logical processor.
+// Speedup is relative to the plain loop's median.
+
+#include <math.h>
+#include <stdio.h>
+#include <string.h>
+
+#include "bench.h"
+#include "engine/jobs/parallel.h"
+
+
+#define BENCH_ELEMENT_COUNT (1u << 24)
+#define BENCH_RUN_COUNT     25
+#define BENCH_GRAIN         4096
+
+
+typedef struct
+{
+    float    *Input;
+    float    *Output;
+    uint32_t *Values;
+    uint32_t *Sums;
+} bench_parallel_data;
+
+
+typedef void bench_parallel_workload(bench_parallel_data *Data, engine_memory *EngineMemory);
+
+
+// A few flops per element, so the loop is not purely bandwidth bound.
+static void
+ScaleRange(uint64_t Begin, uint64_t End, void *Context)
+{
+    bench_parallel_data *Data = (bench_parallel_data *)Context;
+
+    for (uint64_t Idx = Begin; Idx < End; ++Idx)
+    {
+        Data->Output[Idx] = sqrtf(Data->Input[Idx]) * 0.5f + 1.f;
+    }
+}
+
+
+static void
+SumRange(uint64_t Begin, uint64_t End, void *Partial, void *Context)
+{
+    bench_parallel_data *Data = (bench_parallel_data *)Context;
+    double               Sum  = *(double *)Partial;
+
+    for (uint64_t Idx = Begin; Idx < End; ++Idx)
+    {
+        Sum += Data->Input[Idx];
+    }
+
+    *(double *)Partial = Sum;
+}
+
+
+static void
+CombineSums(void *Into, void *From, void *Context)
+{
+    Unused(Context);
+
+    *(double *)Into += *(double *)From;
+}
+
+
+static void
+RunSerialFor(bench_parallel_data *Data, engine_memory *EngineMemory)
+{
+    Unused(EngineMemory);
+
+    ScaleRange(0, BENCH_ELEMENT_COUNT, Data);
+}
+
+
+static void
+RunParallelFor(bench_parallel_data *Data, engine_memory *EngineMemory)
+{
+    ParallelFor(0, BENCH_ELEMENT_COUNT, BENCH_GRAIN, ScaleRange, Data, EngineMemory);
+}
+
+
+static void
+RunSerialReduce(bench_parallel_data *Data, engine_memory *EngineMemory)
+{
+    Unused(EngineMemory);
+
+    double Sum = 0.0;
+    SumRange(0, BENCH_ELEMENT_COUNT, &Sum, Data);
+
+    BenchSink += (uint64_t)Sum;
+}
+
+
+static memory_arena *ReduceArena;
+
+static void
+RunParallelReduce(bench_parallel_data *Data, engine_memory *EngineMemory)
+{
+    double Identity = 0.0;
+    double Sum      = 0.0;
+
+    ParallelReduce(0, BENCH_ELEMENT_COUNT, BENCH_GRAIN, &Identity, sizeof(double), SumRange, CombineSums, Data, &Sum, ReduceArena, EngineMemory);
+
+    BenchSink += (uint64_t)Sum;
+}
+
+
+static void
+RunSerialPrefixSum(bench_parallel_data *Data, engine_memory *EngineMemory)
+{
+    Unused(EngineMemory);
+
+    uint32_t Running = 0;
+    for (uint32_t Idx = 0; Idx < BENCH_ELEMENT_COUNT; ++Idx)
+    {
+        Data->Sums[Idx] = Running;
+        Running        += Data->Values[Idx];
+    }
+
+    BenchSink += Running;
+}
+
+
+static void
+RunParallelPrefixSum(bench_parallel_data *Data, engine_memory *EngineMemory)
+{
+    BenchSink += ParallelPrefixSum(Data->Values, Data->Sums, BENCH_ELEMENT_COUNT, BENCH_GRAIN, EngineMemory);
+}
+
+
+static bench_stats
+MeasureWorkload(bench_parallel_workload *Workload, bench_parallel_data *Data, engine_memory *EngineMemory)
+{
+    uint64_t Samples[BENCH_RUN_COUNT];
+
+    // One untimed run to fault the pages in and wake the workers.
+    Workload(Data, EngineMemory);
+
+    for (uint32_t Run = 0; Run < BENCH_RUN_COUNT; ++Run)
+    {
+        uint64_t Start = OSGetTimeNanoseconds();
+        Workload(Data, EngineMemory);
+        Samples[Run] = OSGetTimeNanoseconds() - Start;
+    }
+
+    bench_stats Result = BenchGetStats(Samples, BENCH_RUN_COUNT);
+    return Result;
+}
+
+
+typedef struct
+{
+    const char              *Name;
+    bench_parallel_workload *Serial;
+    bench_parallel_workload *Parallel;
+} bench_parallel_case;
+
+
+int
+main(void)
+{
+    memory_arena *Arena = BenchCreateArena(GiB(1));
+    ReduceArena = BenchCreateArena(MiB(64));
+
+    bench_parallel_data Data =
+    {
+        .Input  = PushArray(Arena, float, BENCH_ELEMENT_COUNT),
+        .Output = PushArray(Arena, float, BENCH_ELEMENT_COUNT),
+        .Values = PushArray(Arena, uint32_t, BENCH_ELEMENT_COUNT),
+        .Sums   = PushArray(Arena, uint32_t, BENCH_ELEMENT_COUNT),
+    };
+
+    for (uint32_t Idx = 0; Idx < BENCH_ELEMENT_COUNT; ++Idx)
+    {
+        Data.Input[Idx]  = (float)(Idx % 1024);
+        Data.Values[Idx] = Idx % 7;
+    }
+
+    bench_parallel_case Cases[] =
+    {
+        { "ParallelFor (sqrt)",        RunSerialFor,       RunParallelFor       },
+        { "ParallelReduce (sum)",      RunSerialReduce,    RunParallelReduce    },
+        { "ParallelPrefixSum (u32)",   RunSerialPrefixSum, RunParallelPrefixSum },
+    };
+
+    uint32_t ProcessorCount = BenchGetProcessorCount();
+    printf("%u elements, grain %u, %u logical processors\n", BENCH_ELEMENT_COUNT, BENCH_GRAIN, ProcessorCount);
+
+    bench_stats Baselines[ArrayCount(Cases)];
+
+    for (uint32_t CaseIdx = 0; CaseIdx < ArrayCount(Cases); ++CaseIdx)
+    {
+        bench_parallel_case *Case = Cases + CaseIdx;
+        BenchPrintHeader(Case->Name);
+
+        Baselines[CaseIdx] = MeasureWorkload(Case->Serial, &Data, 0);
+        BenchPrintStats("plain loop", Baselines[CaseIdx], BENCH_ELEMENT_COUNT);
+
+        bench_stats Inline = MeasureWorkload(Case->Parallel, &Data, 0);
+        BenchPrintStats("no workers (calling thread only)", Inline, BENCH_ELEMENT_COUNT);
+    }
+
+    // The calling thread is always one more participant than the workers.
+    printf("\nSpeedup over the plain loop (median)\n");
+    printf("%-10s", "workers");
+    for (uint32_t CaseIdx = 0; CaseIdx < ArrayCount(Cases); ++CaseIdx)
+    {
+        printf(" %27s", Cases[CaseIdx].Name);
+    }
+    printf("\n");
+
+    uint32_t WorkerCounts[32];
+    uint32_t WorkerCountCount = BenchGetWorkerCounts(WorkerCounts, ArrayCount(WorkerCounts));
+
+    for (uint32_t Idx = 0; Idx < WorkerCountCount; ++Idx)
+    {
+        engine_memory *EngineMemory = BenchStartWorkers(WorkerCounts[Idx], Arena);
+        if (!EngineMemory)
+        {
+            printf("(threaded runs need the Win32 work queue, skipped)\n");
+            break;
+        }
+
+        printf("%-10u", EngineMemory->WorkerCount);
+
+        for (uint32_t CaseIdx = 0; CaseIdx < ArrayCount(Cases); ++CaseIdx)
+        {
+            bench_stats Stats   = MeasureWorkload(Cases[CaseIdx].Parallel, &Data, EngineMemory);
+            double      Speedup = (double)Baselines[CaseIdx].P50Nanoseconds / (double)Stats.P50Nanoseconds;
+
+            printf(" %14.2f us  %7.2fx", Stats.P50Nanoseconds / 1e3, Speedup);
+        }
+
+        printf("\n");
+
+        BenchStopWorkers(EngineMemory);
+    }
+
+    return 0;
+}
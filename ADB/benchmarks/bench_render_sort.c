@@ -0,0 +1,318 @@
+// Recording and sorting 100K draws, submitted in shuffled order and in an order
+// already grouped by state. The draws mix chunks, tile chunks and instanced meshes,
+// seen by four cameras. For each order: the time to push the items and the time
+// BuildRenderPassList takes to sort them and rebuild the pass list, then the passes,
+// groups and batches the backend binds. The old linked lists only merged a draw into
+// the last pass and group, so their counts are replayed from the submission order;
+// the sorted list is the same whatever the order.
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+
+#include "bench.h"
+#include "engine/rendering/draw.h"
+#include "engine/rendering/renderer.h"
+#include "engine/rendering/renderer_internal.h"
+
+
+#define BENCH_DRAW_COUNT     100000
+#define BENCH_RUN_COUNT      25
+#define BENCH_CAMERA_COUNT   4
+#define BENCH_MATERIAL_COUNT 32
+#define BENCH_MESH_COUNT     256
+
+
+typedef struct
+{
+    RenderPass_Type Pass;
+    uint32_t        Camera;
+    uint32_t        Material;
+    uint32_t        Buffer;
+    float           Depth;
+} bench_draw;
+
+
+typedef struct
+{
+    uint32_t Passes;
+    uint32_t Groups;
+    uint32_t Batches;
+} bench_state_changes;
+
+
+typedef struct
+{
+    bench_stats         Record;
+    bench_stats         Build;
+    render_stats        Stats;
+    bench_state_changes Sorted;
+    bench_state_changes Linked;
+} bench_sort_result;
+
+
+static float
+RandomUnit(void)
+{
+    float Result = (float)rand() / (float)RAND_MAX;
+    return Result;
+}
+
+
+static resource_handle
+MakeBenchHandle(uint32_t Value, RendererResource_Type Type)
+{
+    resource_handle Result = {.Value = Value, .Type = Type};
+    return Result;
+}
+
+
+// Half the draws are chunks, each with its own vertex buffer. A quarter are tile
+// chunks, also one buffer each. The last quarter instance a few hundred meshes, so
+// draws of the same mesh and material can share a batch.
+static void
+MakeDraws(bench_draw *Draws)
+{
+    for (uint32_t Idx = 0; Idx < BENCH_DRAW_COUNT; ++Idx)
+    {
+        bench_draw *Draw = Draws + Idx;
+        uint32_t    Kind = Idx % 4;
+
+        Draw->Camera   = (Idx / 4) % BENCH_CAMERA_COUNT;
+        Draw->Material = 1 + (uint32_t)rand() % BENCH_MATERIAL_COUNT;
+        Draw->Depth    = RandomUnit();
+
+        if (Kind < 2)
+        {
+            Draw->Pass   = RenderPass_Chunk;
+            Draw->Buffer = 1 + Idx;
+        }
+        else if (Kind == 2)
+        {
+            Draw->Pass   = RenderPass_Tile;
+            Draw->Buffer = 1 + Idx;
+        }
+        else
+        {
+            uint32_t Mesh = (uint32_t)rand() % BENCH_MESH_COUNT;
+
+            Draw->Pass     = RenderPass_Mesh;
+            Draw->Buffer   = 1 + Mesh;
+            Draw->Material = 1 + Mesh % BENCH_MATERIAL_COUNT;
+        }
+    }
+}
+
+
+static void
+ShuffleDraws(bench_draw *Draws)
+{
+    for (uint32_t Idx = BENCH_DRAW_COUNT - 1; Idx > 0; --Idx)
+    {
+        uint32_t   Other = (uint32_t)rand() % (Idx + 1);
+        bench_draw Swap  = Draws[Idx];
+
+        Draws[Idx]   = Draws[Other];
+        Draws[Other] = Swap;
+    }
+}
+
+
+static int
+CompareDrawState(const void *A, const void *B)
+{
+    const bench_draw *DrawA = (const bench_draw *)A;
+    const bench_draw *DrawB = (const bench_draw *)B;
+
+    int Result = (int)DrawA->Pass - (int)DrawB->Pass;
+    if (!Result) Result = (int)DrawA->Camera   - (int)DrawB->Camera;
+    if (!Result) Result = (int)DrawA->Material - (int)DrawB->Material;
+    if (!Result) Result = (int)DrawA->Buffer   - (int)DrawB->Buffer;
+
+    return Result;
+}
+
+
+static void
+RecordDraws(bench_draw *Draws, camera *Cameras, render_context *Context)
+{
+    for (uint32_t Idx = 0; Idx < BENCH_DRAW_COUNT; ++Idx)
+    {
+        bench_draw      *Draw     = Draws + Idx;
+        camera          *Camera   = Cameras + Draw->Camera;
+        resource_handle  Material = MakeBenchHandle(Draw->Material, RendererResource_Material);
+        vec3             Origin   = Vec3((float)(Draw->Buffer % 512) * 16.f, (float)(Draw->Buffer / 512) * 16.f, 0.f);
+
+        if (Draw->Pass == RenderPass_Chunk)
+        {
+            DrawChunkIntance(MakeBenchHandle(Draw->Buffer, RendererResource_VertexBuffer), 1024, (resource_handle){0}, 1536, RenderIndex_Quads,
+                             Material, Origin, Draw->Depth, Camera, Context);
+        }
+        else if (Draw->Pass == RenderPass_Tile)
+        {
+            DrawChunkTiles(MakeBenchHandle(Draw->Buffer, RendererResource_VertexBuffer), 256, Material, Origin, Draw->Depth, Camera, Context);
+        }
+        else
+        {
+            mat4x4 World = Mat4Translation(Origin);
+
+            DrawMeshInstance(MakeBenchHandle(Draw->Buffer, RendererResource_VertexBuffer), MakeBenchHandle(Draw->Buffer, RendererResource_IndexBuffer),
+                             36, RenderIndex_U16, Material, &World, Draw->Depth, Camera, Context);
+        }
+    }
+}
+
+
+// What the linked lists built: a new pass whenever the pass type changed, a new group
+// whenever the pass or camera did, and a new batch whenever the group or buffer did
+// or the mesh batch was full.
+static bench_state_changes
+ReplayLinkedLists(bench_draw *Draws)
+{
+    bench_state_changes Result    = {0};
+    bench_draw         *Previous  = 0;
+    uint32_t            Instances = 0;
+
+    for (uint32_t Idx = 0; Idx < BENCH_DRAW_COUNT; ++Idx)
+    {
+        bench_draw *Draw     = Draws + Idx;
+        bool        NewPass  = !Previous || Previous->Pass != Draw->Pass;
+        bool        NewGroup = NewPass || Previous->Camera != Draw->Camera;
+        bool        NewBatch = NewGroup || Draw->Pass != RenderPass_Mesh ||
+                               Previous->Buffer != Draw->Buffer || Previous->Material != Draw->Material ||
+                               Instances == MESH_INSTANCE_PER_BATCH;
+
+        Instances = NewBatch ? 1 : Instances + 1;
+
+        Result.Passes  += NewPass;
+        Result.Groups  += NewGroup;
+        Result.Batches += NewBatch;
+
+        Previous = Draw;
+    }
+
+    return Result;
+}
+
+
+static bench_state_changes
+CountStateChanges(render_pass_list *PassList)
+{
+    bench_state_changes Result = {0};
+
+    for (render_pass_node *PassNode = PassList->First; PassNode != 0; PassNode = PassNode->Next)
+    {
+        Result.Passes += 1;
+
+        for (render_group_node *GroupNode = PassNode->Value.First; GroupNode != 0; GroupNode = GroupNode->Next)
+        {
+            Result.Groups += 1;
+
+            for (render_batch_node *BatchNode = GroupNode->BatchList.First; BatchNode != 0; BatchNode = BatchNode->Next)
+            {
+                Result.Batches += 1;
+            }
+        }
+    }
+
+    return Result;
+}
+
+
+static bench_sort_result
+MeasureSort(bench_draw *Draws, camera *Cameras, render_context *Context, memory_arena *FrameArena)
+{
+    bench_sort_result Result = {0};
+    uint64_t          RecordSamples[BENCH_RUN_COUNT];
+    uint64_t          BuildSamples[BENCH_RUN_COUNT];
+
+    // One warmup frame commits the arenas.
+    for (uint32_t Run = 0; Run <= BENCH_RUN_COUNT; ++Run)
+    {
+        memory_region Region = EnterMemoryRegion(FrameArena);
+
+        uint64_t Start = OSGetTimeNanoseconds();
+        RecordDraws(Draws, Cameras, Context);
+        uint64_t Recorded = OSGetTimeNanoseconds();
+        render_pass_list PassList = BuildRenderPassList(Context, 1, &Result.Stats, FrameArena);
+        uint64_t End = OSGetTimeNanoseconds();
+
+        if (Run > 0)
+        {
+            RecordSamples[Run - 1] = Recorded - Start;
+            BuildSamples[Run - 1]  = End - Recorded;
+        }
+
+        Result.Sorted = CountStateChanges(&PassList);
+
+        LeaveMemoryRegion(Region);
+    }
+
+    Result.Record = BenchGetStats(RecordSamples, BENCH_RUN_COUNT);
+    Result.Build  = BenchGetStats(BuildSamples, BENCH_RUN_COUNT);
+    Result.Linked = ReplayLinkedLists(Draws);
+
+    return Result;
+}
+
+
+static void
+PrintSortResult(const char *Name, bench_sort_result *Result)
+{
+    double Total = (double)(Result->Record.P50Nanoseconds + Result->Build.P50Nanoseconds);
+
+    printf("%-22s %10.2f %10.2f %10.2f %12.1f\n", Name, Result->Record.P50Nanoseconds / 1e6,
+           Result->Build.P50Nanoseconds / 1e6, Result->Build.P99Nanoseconds / 1e6, BENCH_DRAW_COUNT / Total * 1e3);
+}
+
+
+static void
+PrintStateChanges(const char *Name, bench_state_changes Linked, bench_state_changes Sorted)
+{
+    printf("%-22s %10u %10u %10u %10u %10u %10u\n", Name, Linked.Passes, Linked.Groups, Linked.Batches,
+           Sorted.Passes, Sorted.Groups, Sorted.Batches);
+}
+
+
+int
+main(void)
+{
+    memory_arena *Arena      = BenchCreateArena(MiB(64));
+    memory_arena *FrameArena = BenchCreateArena(GiB(1));
+    bench_draw   *Draws      = PushArray(Arena, bench_draw, BENCH_DRAW_COUNT);
+
+    render_context Context = {.Arena = BenchCreateArena(GiB(1))};
+
+    camera Cameras[BENCH_CAMERA_COUNT];
+    for (uint32_t Idx = 0; Idx < BENCH_CAMERA_COUNT; ++Idx)
+    {
+        Cameras[Idx] = CreateCamera(Vec3(100.f * (float)Idx, 0.f, -100.f), 60.f, 16.f / 9.f);
+    }
+
+    srand(1);
+    MakeDraws(Draws);
+
+    ShuffleDraws(Draws);
+    bench_sort_result Shuffled = MeasureSort(Draws, Cameras, &Context, FrameArena);
+
+    qsort(Draws, BENCH_DRAW_COUNT, sizeof(bench_draw), CompareDrawState);
+    bench_sort_result Grouped = MeasureSort(Draws, Cameras, &Context, FrameArena);
+
+    printf("%u draws: %u%% chunks, %u%% tile chunks, %u%% instances of %u meshes; %u cameras, %u materials\n",
+           BENCH_DRAW_COUNT, 50, 25, 25, BENCH_MESH_COUNT, BENCH_CAMERA_COUNT, BENCH_MATERIAL_COUNT);
+    printf("%-22s %10s %10s %10s %12s\n", "submission order", "push (ms)", "sort (ms)", "p99 (ms)", "draws/ms");
+    PrintSortResult("shuffled", &Shuffled);
+    PrintSortResult("grouped by state", &Grouped);
+
+    printf("\nState changes the backend binds\n");
+    printf("%-22s %32s %32s\n", "", "linked lists (last only)", "sorted keys");
+    printf("%-22s %10s %10s %10s %10s %10s %10s\n", "submission order", "passes", "groups", "batches", "passes", "groups", "batches");
+    PrintStateChanges("shuffled", Shuffled.Linked, Shuffled.Sorted);
+    PrintStateChanges("grouped by state", Grouped.Linked, Grouped.Sorted);
+
+    printf("\nrender_stats, shuffled: %u items, %u groups and %u batches submitted, %u groups and %u batches built\n",
+           Shuffled.Stats.Items, Shuffled.Stats.GroupsSubmitted, Shuffled.Stats.BatchesSubmitted,
+           Shuffled.Stats.Groups, Shuffled.Stats.Batches);
+
+    return 0;
+}
@@ -0,0 +1,238 @@
+// Per-frame CPU cost of drawing static chunks immediately against through retained
+// lists. Each world is a square of chunks small enough to be in view whole, split
+// into 16 region lists. Every frame is timed from recording to the linked pass list
+// the backend would walk:
+//   immediate   DrawChunks culls and records every chunk, BuildRenderPassList sorts
+//   retained    all 16 lists are up to date and only submitted
+//   one edit    one region's Version changes each frame and is recorded again
+//   all stale   every list is rebuilt every frame, the worst case
+// Draws only carry resource handles until the backend resolves them, so the chunks
+// get handles of their own instead of real buffers.
+
+#include <stdio.h>
+
+#include "bench.h"
+#include "null_renderer.h"
+#include "engine/rendering/renderer.h"
+#include "game/world/chunk.h"
+
+
+#define BENCH_REGION_COUNT 16
+#define BENCH_RUN_COUNT    50
+
+
+typedef enum
+{
+    BenchMode_Immediate,
+    BenchMode_Retained,
+    BenchMode_OneEdit,
+    BenchMode_AllStale,
+    BenchMode_Count,
+} bench_mode;
+
+
+typedef struct
+{
+    camera                *Camera;
+    renderer              *Renderer;
+    chunk                 *Chunks;
+    uint32_t               ChunkCount;
+    render_retained_list  *Regions[BENCH_REGION_COUNT];
+    uint64_t               Versions[BENCH_REGION_COUNT];
+    memory_arena          *Arena;
+} bench_retained_world;
+
+
+static void
+MakeChunkWorld(chunk *Chunks, uint32_t Side)
+{
+    uint32_t Half = Side / 2;
+
+    for (uint32_t Y = 0; Y < Side; ++Y)
+    {
+        for (uint32_t X = 0; X < Side; ++X)
+        {
+            uint32_t Idx    = Y * Side + X;
+            vec3     Origin = Vec3(((float)X - (float)Half) * CHUNK_SIZE_X, ((float)Y - (float)Half) * CHUNK_SIZE_Y, 0.f);
+            chunk   *Chunk  = Chunks + Idx;
+
+            *Chunk = MakeChunk(ChunkMesh_Greedy, Origin);
+
+            Chunk->Material     = (resource_handle){.Value = 1 + Idx % 4, .Type = RendererResource_Material};
+            Chunk->VertexBuffer = (resource_handle){.Value = 1 + Idx, .Type = RendererResource_VertexBuffer};
+            Chunk->QuadCount    = 32;
+            Chunk->VertexCount  = 4 * Chunk->QuadCount;
+            Chunk->IndexCount   = 6 * Chunk->QuadCount;
+        }
+    }
+}
+
+
+// Regions are runs of rows, so a region list holds neighbouring chunks.
+static void
+SubmitRegions(bench_retained_world *World)
+{
+    uint32_t RegionSize = World->ChunkCount / BENCH_REGION_COUNT;
+
+    for (uint32_t Region = 0; Region < BENCH_REGION_COUNT; ++Region)
+    {
+        render_retained_list *List    = World->Regions[Region];
+        render_context       *Context = BeginRetainedList(World->Versions[Region], List);
+
+        if (Context)
+        {
+            RecordChunks(World->Camera, Context, World->Chunks + Region * RegionSize, RegionSize);
+            EndRetainedList(List);
+        }
+
+        SubmitRetainedList(World->Camera, List, World->Renderer);
+    }
+}
+
+
+static uint32_t
+CountBatches(render_pass_list *PassList)
+{
+    uint32_t Result = 0;
+
+    for (render_pass_node *PassNode = PassList->First; PassNode != 0; PassNode = PassNode->Next)
+    {
+        for (render_group_node *GroupNode = PassNode->Value.First; GroupNode != 0; GroupNode = GroupNode->Next)
+        {
+            for (render_batch_node *BatchNode = GroupNode->BatchList.First; BatchNode != 0; BatchNode = BatchNode->Next)
+            {
+                Result += 1;
+            }
+        }
+    }
+
+    return Result;
+}
+
+
+// 'OutBatchCount' is only counted when given, outside the timed frames.
+static void
+RunFrame(bench_retained_world *World, bench_mode Mode, uint32_t Frame, uint32_t *OutBatchCount)
+{
+    memory_region Region = EnterMemoryRegion(World->Arena);
+
+    if (Mode == BenchMode_Immediate)
+    {
+        DrawChunks(World->Camera, World->Renderer, World->Arena, World->Chunks, World->ChunkCount, 0);
+    }
+    else
+    {
+        if (Mode == BenchMode_OneEdit)
+        {
+            World->Versions[Frame % BENCH_REGION_COUNT] += 1;
+        }
+        else if (Mode == BenchMode_AllStale)
+        {
+            for (uint32_t Idx = 0; Idx < BENCH_REGION_COUNT; ++Idx)
+            {
+                World->Versions[Idx] += 1;
+            }
+        }
+
+        SubmitRegions(World);
+    }
+
+    render_pass_list PassList = BuildRenderPassList(World->Renderer->Contexts, RENDER_MAX_CONTEXTS, 0, World->Arena);
+    LinkRetainedLists(&PassList, World->Renderer, World->Arena);
+
+    if (OutBatchCount)
+    {
+        *OutBatchCount = CountBatches(&PassList);
+    }
+
+    BenchSink += (uint64_t)(uintptr_t)PassList.First;
+
+    LeaveMemoryRegion(Region);
+}
+
+
+static bench_stats
+MeasureFrames(bench_retained_world *World, bench_mode Mode, uint32_t *OutBatchCount)
+{
+    uint64_t Samples[BENCH_RUN_COUNT];
+
+    // The warmup frame builds the lists the retained mode then keeps.
+    RunFrame(World, Mode, 0, OutBatchCount);
+
+    for (uint32_t Run = 0; Run < BENCH_RUN_COUNT; ++Run)
+    {
+        uint64_t Start = OSGetTimeNanoseconds();
+        RunFrame(World, Mode, Run + 1, 0);
+        Samples[Run] = OSGetTimeNanoseconds() - Start;
+    }
+
+    bench_stats Result = BenchGetStats(Samples, BENCH_RUN_COUNT);
+    return Result;
+}
+
+
+int
+main(void)
+{
+    memory_arena *Arena    = BenchCreateArena(GiB(1));
+    renderer     *Renderer = CreateNullRenderer(Arena);
+
+    // Seen from 900 units away, a 64x64 chunk square (1024 units) fits the frustum.
+    camera Camera = CreateCamera(Vec3(0.f, 0.f, -900.f), 60.f, 16.f / 9.f);
+
+    bench_retained_world World = {.Camera = &Camera, .Renderer = Renderer, .Arena = Arena};
+
+    for (uint32_t Idx = 0; Idx < BENCH_REGION_COUNT; ++Idx)
+    {
+        World.Regions[Idx] = CreateRetainedList(Arena);
+    }
+
+    const char *ModeNames[BenchMode_Count] = { "immediate", "retained", "one edit", "all stale" };
+
+    printf("%u region lists per world; frame time in us, p50 / p99\n", BENCH_REGION_COUNT);
+    printf("%10s %10s", "chunks", "batches");
+    for (uint32_t Mode = 0; Mode < BenchMode_Count; ++Mode)
+    {
+        printf(" %19s", ModeNames[Mode]);
+    }
+    printf("\n");
+
+    uint32_t WorldSides[] = { 16, 32, 64 };
+
+    for (uint32_t SideIdx = 0; SideIdx < ArrayCount(WorldSides); ++SideIdx)
+    {
+        uint32_t Side = WorldSides[SideIdx];
+
+        World.ChunkCount = Side * Side;
+        World.Chunks     = PushArray(Arena, chunk, World.ChunkCount);
+
+        MakeChunkWorld(World.Chunks, Side);
+
+        for (uint32_t Idx = 0; Idx < BENCH_REGION_COUNT; ++Idx)
+        {
+            InvalidateRetainedList(World.Regions[Idx]);
+        }
+
+        bench_stats Stats[BenchMode_Count];
+        uint32_t    Batches[BenchMode_Count];
+
+        for (uint32_t Mode = 0; Mode < BenchMode_Count; ++Mode)
+        {
+            Stats[Mode] = MeasureFrames(&World, (bench_mode)Mode, &Batches[Mode]);
+        }
+
+        printf("%10u %10u", World.ChunkCount, Batches[BenchMode_Immediate]);
+        for (uint32_t Mode = 0; Mode < BenchMode_Count; ++Mode)
+        {
+            printf(" %9.1f / %7.1f", Stats[Mode].P50Nanoseconds / 1e3, Stats[Mode].P99Nanoseconds / 1e3);
+
+            if (Batches[Mode] != Batches[BenchMode_Immediate])
+            {
+                printf("  MISMATCH: %u batches", Batches[Mode]);
+            }
+        }
+        printf("\n");
+    }
+
+    return 0;
+}
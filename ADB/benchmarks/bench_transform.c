@@ -0,0 +1,243 @@
+// UpdateTransforms on 100K-node hierarchies of three shapes: all roots, 1000 rigs of
+// 100 bones (a binary tree, 7 levels) and 10K chains of 10 nodes. Each frame first
+// animates either every node or one node in ten (their subtrees follow through the
+// dirty flags), then only UpdateTransforms is timed, on the calling thread alone and
+// with 1, 2, 4... workers. Every shape is checked once against a recursive
+// Mat4Multiply reference.
+
+#include <math.h>
+#include <stdio.h>
+#include <stdlib.h>
+
+#include "bench.h"
+#include "engine/scene/transform.h"
+
+
+#define BENCH_NODE_COUNT 100000
+#define BENCH_RUN_COUNT  50
+
+
+typedef enum
+{
+    BenchShape_Flat,
+    BenchShape_Rigs,
+    BenchShape_Chains,
+    BenchShape_Count,
+} bench_shape;
+
+
+typedef struct
+{
+    transform_hierarchy *Hierarchy;
+    transform_handle    *Handles;
+    uint32_t            *Parents;
+    vec3                *Positions;
+    quat                *Rotations;
+    vec3                *Scales;
+    uint32_t             AnimatedStep;
+    uint32_t             Frame;
+} bench_transform_scene;
+
+
+static float
+RandomUnit(void)
+{
+    float Result = (float)rand() / (float)RAND_MAX * 2.f - 1.f;
+    return Result;
+}
+
+
+// Parent index of each node, or the node itself for roots. Parents always come first.
+static uint32_t
+GetShapeParent(bench_shape Shape, uint32_t Idx)
+{
+    uint32_t Result = Idx;
+
+    if (Shape == BenchShape_Rigs && Idx % 100 != 0)
+    {
+        uint32_t Bone = Idx % 100;
+        Result = Idx - Bone + (Bone - 1) / 2;
+    }
+    else if (Shape == BenchShape_Chains && Idx % 10 != 0)
+    {
+        Result = Idx - 1;
+    }
+
+    return Result;
+}
+
+
+static void
+CreateScene(bench_transform_scene *Scene, bench_shape Shape, memory_arena *Arena)
+{
+    Scene->Hierarchy = CreateTransformHierarchy(BENCH_NODE_COUNT, Arena);
+
+    for (uint32_t Idx = 0; Idx < BENCH_NODE_COUNT; ++Idx)
+    {
+        uint32_t         Parent       = GetShapeParent(Shape, Idx);
+        transform_handle ParentHandle = Parent != Idx ? Scene->Handles[Parent] : (transform_handle){0};
+
+        Scene->Parents[Idx]   = Parent;
+        Scene->Positions[Idx] = Vec3(RandomUnit() * 10.f, RandomUnit() * 10.f, RandomUnit() * 10.f);
+        Scene->Rotations[Idx] = QuatFromAxisAngle(Vec3Normalize(Vec3(RandomUnit(), RandomUnit(), 1.f)), RandomUnit() * 3.f);
+        Scene->Scales[Idx]    = Vec3(1.f + 0.1f * RandomUnit(), 1.f + 0.1f * RandomUnit(), 1.f + 0.1f * RandomUnit());
+        Scene->Handles[Idx]   = CreateTransform(ParentHandle, Scene->Positions[Idx], Scene->Rotations[Idx], Scene->Scales[Idx], Scene->Hierarchy);
+    }
+}
+
+
+// Spins the animated nodes a little further every frame.
+static void
+AnimateScene(bench_transform_scene *Scene)
+{
+    quat Step = QuatFromAxisAngle(Vec3(0.f, 0.f, 1.f), 0.01f * (float)(++Scene->Frame));
+
+    for (uint32_t Idx = Scene->Frame % Scene->AnimatedStep; Idx < BENCH_NODE_COUNT; Idx += Scene->AnimatedStep)
+    {
+        SetTransformRotation(Scene->Handles[Idx], QuatMultiply(Scene->Rotations[Idx], Step), Scene->Hierarchy);
+    }
+}
+
+
+static mat4x4
+MakeLocalMatrix(vec3 Position, quat Rotation, vec3 Scale)
+{
+    float X = Rotation.X, Y = Rotation.Y, Z = Rotation.Z, W = Rotation.W;
+
+    mat4x4 Result =
+    {
+        (1.f - 2.f * (Y * Y + Z * Z)) * Scale.X, (2.f * (X * Y + W * Z)) * Scale.X, (2.f * (X * Z - W * Y)) * Scale.X, 0.f,
+        (2.f * (X * Y - W * Z)) * Scale.Y, (1.f - 2.f * (X * X + Z * Z)) * Scale.Y, (2.f * (Y * Z + W * X)) * Scale.Y, 0.f,
+        (2.f * (X * Z + W * Y)) * Scale.Z, (2.f * (Y * Z - W * X)) * Scale.Z, (1.f - 2.f * (X * X + Y * Y)) * Scale.Z, 0.f,
+        Position.X, Position.Y, Position.Z, 1.f,
+    };
+
+    return Result;
+}
+
+
+// Largest difference between the hierarchy and parent * local computed node by node,
+// after a full update from the creation values.
+static float
+CheckScene(bench_transform_scene *Scene, memory_arena *Arena)
+{
+    float   Result    = 0.f;
+    mat4x4 *Reference = PushArray(Arena, mat4x4, BENCH_NODE_COUNT);
+
+    UpdateTransforms(Scene->Hierarchy, Arena, 0);
+
+    for (uint32_t Idx = 0; Idx < BENCH_NODE_COUNT; ++Idx)
+    {
+        uint32_t Parent = Scene->Parents[Idx];
+        mat4x4   Local  = MakeLocalMatrix(Scene->Positions[Idx], Scene->Rotations[Idx], Scene->Scales[Idx]);
+
+        Reference[Idx] = Parent != Idx ? Mat4Multiply(Reference[Parent], Local) : Local;
+
+        float *Expected = &Reference[Idx].c0r0;
+        float *Actual   = &GetTransformWorldMatrix(Scene->Handles[Idx], Scene->Hierarchy)->c0r0;
+
+        for (uint32_t Entry = 0; Entry < 16; ++Entry)
+        {
+            Result = fmaxf(Result, fabsf(Expected[Entry] - Actual[Entry]));
+        }
+    }
+
+    return Result;
+}
+
+
+static bench_stats
+MeasureUpdates(bench_transform_scene *Scene, memory_arena *Arena, engine_memory *EngineMemory)
+{
+    uint64_t Samples[BENCH_RUN_COUNT];
+
+    // One untimed frame wakes the workers.
+    AnimateScene(Scene);
+    UpdateTransforms(Scene->Hierarchy, Arena, EngineMemory);
+
+    for (uint32_t Run = 0; Run < BENCH_RUN_COUNT; ++Run)
+    {
+        AnimateScene(Scene);
+
+        uint64_t Start = OSGetTimeNanoseconds();
+        UpdateTransforms(Scene->Hierarchy, Arena, EngineMemory);
+        Samples[Run] = OSGetTimeNanoseconds() - Start;
+    }
+
+    BenchSink += (uint64_t)GetTransformWorldMatrix(Scene->Handles[BENCH_NODE_COUNT - 1], Scene->Hierarchy)->c3r0;
+
+    bench_stats Result = BenchGetStats(Samples, BENCH_RUN_COUNT);
+    return Result;
+}
+
+
+int
+main(void)
+{
+    memory_arena *Arena = BenchCreateArena(GiB(1));
+
+    const char *ShapeNames[BenchShape_Count] = { "flat, 100K roots", "1000 rigs of 100", "10K chains of 10" };
+    uint32_t    AnimatedSteps[]              = { 1, 10 };
+
+    bench_transform_scene Scene =
+    {
+        .Handles   = PushArray(Arena, transform_handle, BENCH_NODE_COUNT),
+        .Parents   = PushArray(Arena, uint32_t, BENCH_NODE_COUNT),
+        .Positions = PushArray(Arena, vec3, BENCH_NODE_COUNT),
+        .Rotations = PushArray(Arena, quat, BENCH_NODE_COUNT),
+        .Scales    = PushArray(Arena, vec3, BENCH_NODE_COUNT),
+    };
+
+    uint32_t WorkerCounts[32];
+    uint32_t WorkerCountCount = BenchGetWorkerCounts(WorkerCounts, ArrayCount(WorkerCounts));
+
+    printf("%u nodes, UpdateTransforms p50 / p99 in us\n", BENCH_NODE_COUNT);
+    printf("%-18s %9s %10s %21s", "", "animated", "max error", "no workers");
+    for (uint32_t Idx = 0; Idx < WorkerCountCount; ++Idx)
+    {
+        printf(" %13u workers", WorkerCounts[Idx]);
+    }
+    printf("\n");
+
+    srand(1);
+
+    for (uint32_t Shape = 0; Shape < BenchShape_Count; ++Shape)
+    {
+        for (uint32_t StepIdx = 0; StepIdx < ArrayCount(AnimatedSteps); ++StepIdx)
+        {
+            memory_region Region = EnterMemoryRegion(Arena);
+
+            Scene.AnimatedStep = AnimatedSteps[StepIdx];
+            Scene.Frame        = 0;
+
+            CreateScene(&Scene, (bench_shape)Shape, Arena);
+
+            float       Error  = CheckScene(&Scene, Arena);
+            bench_stats Inline = MeasureUpdates(&Scene, Arena, 0);
+
+            printf("%-18s %8u%% %10.2g %10.1f / %8.1f", ShapeNames[Shape], 100 / Scene.AnimatedStep, Error,
+                   Inline.P50Nanoseconds / 1e3, Inline.P99Nanoseconds / 1e3);
+
+            for (uint32_t Idx = 0; Idx < WorkerCountCount; ++Idx)
+            {
+                engine_memory *EngineMemory = BenchStartWorkers(WorkerCounts[Idx], Arena);
+                if (!EngineMemory)
+                {
+                    printf("  (threaded runs need the Win32 work queue, skipped)");
+                    break;
+                }
+
+                bench_stats Stats = MeasureUpdates(&Scene, Arena, EngineMemory);
+                printf(" %10.1f / %8.1f", Stats.P50Nanoseconds / 1e3, Stats.P99Nanoseconds / 1e3);
+
+                BenchStopWorkers(EngineMemory);
+            }
+
+            printf("\n");
+
+            LeaveMemoryRegion(Region);
+        }
+    }
+
+    return 0;
+}
@@ -0,0 +1,316 @@
+// The SoA batch kernels at each instruction set the CPU offers, against the scalar
+// vec3 calls they replace (one by-value Vec3Add... per interleaved vertex). Two sizes:
+// 16K points stay in L1/L2 and show compute throughput, 4M points (48 MB per array)
+// spill every cache and should run at memory bandwidth. GB/s counts bytes read and
+// written by the kernel.
+
+#include <stdio.h>
+#include <stdlib.h>
+
+#include "bench.h"
+#include "engine/math/matrix.h"
+#include "engine/math/vector_batch.h"
+
+
+#define BENCH_SMALL_COUNT (1u << 14)
+#define BENCH_LARGE_COUNT (1u << 22)
+#define BENCH_RUN_COUNT   15
+
+
+typedef struct
+{
+    uint64_t  Count;
+
+    vec3     *AoSA;
+    vec3     *AoSB;
+    vec3     *AoSOut;
+    float    *Dots;
+
+    vec3_soa  A;
+    vec3_soa  B;
+    vec3_soa  Out;
+
+    mat4x4    Transform;
+} bench_vector_data;
+
+
+typedef void bench_vector_workload(bench_vector_data *Data);
+
+
+// ==============================================
+// <Scalar>
+// ==============================================
+
+
+static void
+ScalarAdd(bench_vector_data *Data)
+{
+    for (uint64_t Idx = 0; Idx < Data->Count; ++Idx)
+    {
+        Data->AoSOut[Idx] = Vec3Add(Data->AoSA[Idx], Data->AoSB[Idx]);
+    }
+}
+
+
+static void
+ScalarScale(bench_vector_data *Data)
+{
+    for (uint64_t Idx = 0; Idx < Data->Count; ++Idx)
+    {
+        Data->AoSOut[Idx] = Vec3Scale(Data->AoSA[Idx], 1.5f);
+    }
+}
+
+
+static void
+ScalarDot(bench_vector_data *Data)
+{
+    for (uint64_t Idx = 0; Idx < Data->Count; ++Idx)
+    {
+        Data->Dots[Idx] = Vec3Dot(Data->AoSA[Idx], Data->AoSB[Idx]);
+    }
+}
+
+
+static void
+ScalarCross(bench_vector_data *Data)
+{
+    for (uint64_t Idx = 0; Idx < Data->Count; ++Idx)
+    {
+        Data->AoSOut[Idx] = Vec3Cross(Data->AoSA[Idx], Data->AoSB[Idx]);
+    }
+}
+
+
+static void
+ScalarNormalize(bench_vector_data *Data)
+{
+    for (uint64_t Idx = 0; Idx < Data->Count; ++Idx)
+    {
+        Data->AoSOut[Idx] = Vec3Normalize(Data->AoSA[Idx]);
+    }
+}
+
+
+static void
+ScalarTransform(bench_vector_data *Data)
+{
+    for (uint64_t Idx = 0; Idx < Data->Count; ++Idx)
+    {
+        Data->AoSOut[Idx] = Mat4TransformPoint(Data->Transform, Data->AoSA[Idx]);
+    }
+}
+
+
+// ==============================================
+// <Batch>
+// ==============================================
+
+
+static void
+BatchAdd(bench_vector_data *Data)
+{
+    Vec3BatchAdd(Data->A, Data->B, Data->Out, Data->Count);
+}
+
+
+static void
+BatchScale(bench_vector_data *Data)
+{
+    Vec3BatchScale(Data->A, 1.5f, Data->Out, Data->Count);
+}
+
+
+static void
+BatchDot(bench_vector_data *Data)
+{
+    Vec3BatchDot(Data->A, Data->B, Data->Dots, Data->Count);
+}
+
+
+static void
+BatchCross(bench_vector_data *Data)
+{
+    Vec3BatchCross(Data->A, Data->B, Data->Out, Data->Count);
+}
+
+
+static void
+BatchNormalize(bench_vector_data *Data)
+{
+    Vec3BatchNormalize(Data->A, Data->Out, Data->Count);
+}
+
+
+static void
+BatchTransform(bench_vector_data *Data)
+{
+    Vec3BatchTransform(&Data->Transform, Data->A, Data->Out, Data->Count);
+}
+
+
+static void
+BatchGather(bench_vector_data *Data)
+{
+    Vec3GatherSoA(Data->AoSA, sizeof(vec3), Data->Out, Data->Count);
+}
+
+
+static void
+BatchScatter(bench_vector_data *Data)
+{
+    Vec3ScatterSoA(Data->A, Data->AoSOut, sizeof(vec3), Data->Count);
+}
+
+
+static bench_stats
+MeasureWorkload(bench_vector_workload *Workload, bench_vector_data *Data)
+{
+    uint64_t Samples[BENCH_RUN_COUNT];
+
+    Workload(Data);
+
+    for (uint32_t Run = 0; Run < BENCH_RUN_COUNT; ++Run)
+    {
+        uint64_t Start = OSGetTimeNanoseconds();
+        Workload(Data);
+        Samples[Run] = OSGetTimeNanoseconds() - Start;
+    }
+
+    BenchSink += (uint64_t)(Data->Out.X[Data->Count - 1] + Data->AoSOut[Data->Count - 1].Y + Data->Dots[0]);
+
+    bench_stats Result = BenchGetStats(Samples, BENCH_RUN_COUNT);
+    return Result;
+}
+
+
+// ==============================================
+// <Entry Point>
+// ==============================================
+
+
+typedef struct
+{
+    const char            *Name;
+    bench_vector_workload *Scalar;
+    bench_vector_workload *Batch;
+    uint32_t               BytesPerPoint;
+} bench_vector_case;
+
+
+static float
+RandomUnit(void)
+{
+    float Result = (float)rand() / (float)RAND_MAX * 2.f - 1.f;
+    return Result;
+}
+
+
+int
+main(void)
+{
+    memory_arena *Arena = BenchCreateArena(GiB(1));
+
+    bench_vector_data Data =
+    {
+        .AoSA   = PushArray(Arena, vec3, BENCH_LARGE_COUNT),
+        .AoSB   = PushArray(Arena, vec3, BENCH_LARGE_COUNT),
+        .AoSOut = PushArray(Arena, vec3, BENCH_LARGE_COUNT),
+        .Dots   = PushArray(Arena, float, BENCH_LARGE_COUNT),
+        .A      = PushVec3SoA(Arena, BENCH_LARGE_COUNT),
+        .B      = PushVec3SoA(Arena, BENCH_LARGE_COUNT),
+        .Out    = PushVec3SoA(Arena, BENCH_LARGE_COUNT),
+    };
+
+    srand(1);
+
+    for (uint32_t Idx = 0; Idx < BENCH_LARGE_COUNT; ++Idx)
+    {
+        Data.AoSA[Idx] = Vec3(RandomUnit(), RandomUnit(), RandomUnit());
+        Data.AoSB[Idx] = Vec3(RandomUnit(), RandomUnit(), RandomUnit());
+    }
+
+    Vec3GatherSoA(Data.AoSA, sizeof(vec3), Data.A, BENCH_LARGE_COUNT);
+    Vec3GatherSoA(Data.AoSB, sizeof(vec3), Data.B, BENCH_LARGE_COUNT);
+
+    for (uint32_t Element = 0; Element < 16; ++Element)
+    {
+        (&Data.Transform.c0r0)[Element] = RandomUnit();
+    }
+
+    bench_vector_case Cases[] =
+    {
+        { "add",       ScalarAdd,       BatchAdd,       36 },
+        { "scale",     ScalarScale,     BatchScale,     24 },
+        { "dot",       ScalarDot,       BatchDot,       28 },
+        { "cross",     ScalarCross,     BatchCross,     36 },
+        { "normalize", ScalarNormalize, BatchNormalize, 24 },
+        { "transform", ScalarTransform, BatchTransform, 24 },
+        { "gather",    0,               BatchGather,    24 },
+        { "scatter",   0,               BatchScatter,   24 },
+    };
+
+    const char    *ISANames[] = { "SSE2", "AVX2", "AVX-512" };
+    VectorISA_Type Best       = GetVectorBatchISA();
+    uint64_t       Counts[]   = { BENCH_SMALL_COUNT, BENCH_LARGE_COUNT };
+
+    printf("Best instruction set on this machine: %s\n", ISANames[Best]);
+
+    for (uint32_t CountIdx = 0; CountIdx < ArrayCount(Counts); ++CountIdx)
+    {
+        Data.Count = Counts[CountIdx];
+
+        printf("\n%llu points, median ns per point (GB/s), speedup over scalar\n", (unsigned long long)Data.Count);
+        printf("%-10s %21s", "kernel", "scalar");
+        for (uint32_t ISA = 0; ISA <= (uint32_t)Best; ++ISA)
+        {
+            printf(" %28s", ISANames[ISA]);
+        }
+        printf("\n");
+
+        for (uint32_t CaseIdx = 0; CaseIdx < ArrayCount(Cases); ++CaseIdx)
+        {
+            bench_vector_case *Case        = Cases + CaseIdx;
+            double             ScalarNanos = 0.0;
+
+            printf("%-10s", Case->Name);
+
+            if (Case->Scalar)
+            {
+                bench_stats Stats = MeasureWorkload(Case->Scalar, &Data);
+                ScalarNanos = (double)Stats.P50Nanoseconds;
+
+                printf(" %7.3f (%6.1f GB/s)", ScalarNanos / (double)Data.Count, (double)Case->BytesPerPoint * (double)Data.Count / ScalarNanos);
+            }
+            else
+            {
+                printf(" %21s", "-");
+            }
+
+            for (uint32_t ISA = 0; ISA <= (uint32_t)Best; ++ISA)
+            {
+                SetVectorBatchISA((VectorISA_Type)ISA);
+
+                bench_stats Stats = MeasureWorkload(Case->Batch, &Data);
+                double      Nanos = (double)Stats.P50Nanoseconds;
+
+                printf(" %7.3f (%6.1f GB/s)", Nanos / (double)Data.Count, (double)Case->BytesPerPoint * (double)Data.Count / Nanos);
+
+                if (ScalarNanos > 0.0)
+                {
+                    printf(" %5.1fx", ScalarNanos / Nanos);
+                }
+                else
+                {
+                    printf(" %6s", "");
+                }
+            }
+
+            SetVectorBatchISA(Best);
+
+            printf("\n");
+        }
+    }
+
+    return 0;
+}
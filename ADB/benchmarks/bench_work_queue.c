@@ -0,0 +1,132 @@
+// Submission cost and wake latency of the work queue for bursts of empty jobs, up to
+// 10k entries. Before every burst the workers are left idle long enough to spin out
+// and park, so each burst pays for the wakeup. Two ways to submit:
+//   AddEntries       one call, one ReleaseSemaphore sized to the sleeping workers
+//   AddCountedEntry  one call per entry, each one waking a sleeper (the old path)
+// Columns: time spent submitting, time until the first entry starts on a worker,
+// and time until the counter reaches zero (the submitting thread helps).
+
+#include <stdio.h>
+
+#include "bench.h"
+
+
+#define BENCH_ROUND_COUNT 200
+#define BENCH_IDLE_MILLIS 2
+
+
+static uint32_t          MainThreadID;
+static uint64_t volatile FirstWorkerStart;
+
+
+static void
+EmptyJob(platform_work_queue *Queue, void *Data)
+{
+    Unused(Queue);
+    Unused(Data);
+
+    if (!FirstWorkerStart && OSGetThreadID() != MainThreadID)
+    {
+        AtomicCompareExchangeU64(&FirstWorkerStart, OSGetTimeNanoseconds(), 0);
+    }
+}
+
+
+typedef struct
+{
+    bench_stats Submit;
+    bench_stats FirstStart;
+    bench_stats Complete;
+} bench_burst_stats;
+
+
+static bench_burst_stats
+MeasureBurst(engine_memory *EngineMemory, uint32_t BurstSize, bool Batched)
+{
+    static uint64_t Submit[BENCH_ROUND_COUNT];
+    static uint64_t FirstStart[BENCH_ROUND_COUNT];
+    static uint64_t Complete[BENCH_ROUND_COUNT];
+
+    for (uint32_t Round = 0; Round < BENCH_ROUND_COUNT; ++Round)
+    {
+        BenchSleepMilliseconds(BENCH_IDLE_MILLIS);
+
+        platform_work_counter Counter = {0};
+        FirstWorkerStart = 0;
+
+        uint64_t Start = OSGetTimeNanoseconds();
+
+        if (Batched)
+        {
+            EngineMemory->AddEntries(EngineMemory->WorkQueue, EmptyJob, 0, 0, BurstSize, &Counter);
+        }
+        else
+        {
+            for (uint32_t Idx = 0; Idx < BurstSize; ++Idx)
+            {
+                EngineMemory->AddCountedEntry(EngineMemory->WorkQueue, EmptyJob, 0, &Counter);
+            }
+        }
+
+        uint64_t Submitted = OSGetTimeNanoseconds();
+
+        EngineMemory->WaitForCounter(EngineMemory->WorkQueue, &Counter);
+
+        uint64_t Done = OSGetTimeNanoseconds();
+
+        // The submitting thread can run a whole small burst itself before any worker
+        // wakes up; those rounds have no worker start and count as the full time.
+        Submit[Round]     = Submitted - Start;
+        FirstStart[Round] = FirstWorkerStart ? FirstWorkerStart - Start : Done - Start;
+        Complete[Round]   = Done - Start;
+    }
+
+    bench_burst_stats Result =
+    {
+        .Submit     = BenchGetStats(Submit, BENCH_ROUND_COUNT),
+        .FirstStart = BenchGetStats(FirstStart, BENCH_ROUND_COUNT),
+        .Complete   = BenchGetStats(Complete, BENCH_ROUND_COUNT),
+    };
+
+    return Result;
+}
+
+
+int
+main(void)
+{
+    memory_arena *Arena = BenchCreateArena(MiB(256));
+
+    MainThreadID = OSGetThreadID();
+
+    engine_memory *EngineMemory = BenchStartWorkers(Maximum(BenchGetProcessorCount() - 1, 1), Arena);
+    if (!EngineMemory)
+    {
+        printf("bench_work_queue needs the Win32 work queue, skipped\n");
+        return 0;
+    }
+
+    printf("%u workers, %u rounds per row, %u ms idle before each burst\n", EngineMemory->WorkerCount, BENCH_ROUND_COUNT, BENCH_IDLE_MILLIS);
+    printf("%6s %-16s %22s %22s %22s\n", "burst", "submission", "submit p50/p99 (us)", "first start p50/p99", "complete p50/p99");
+
+    uint32_t BurstSizes[] = { 1, 8, 64, 1024, 10000 };
+
+    for (uint32_t SizeIdx = 0; SizeIdx < ArrayCount(BurstSizes); ++SizeIdx)
+    {
+        for (uint32_t Batched = 0; Batched < 2; ++Batched)
+        {
+            uint32_t          BurstSize = BurstSizes[SizeIdx];
+            bench_burst_stats Stats     = MeasureBurst(EngineMemory, BurstSize, Batched);
+
+            printf("%6u %-16s %10.1f / %9.1f %10.1f / %9.1f %10.1f / %9.1f\n",
+                   BurstSize, Batched ? "AddEntries" : "AddCountedEntry",
+                   Stats.Submit.P50Nanoseconds / 1e3, Stats.Submit.P99Nanoseconds / 1e3,
+                   Stats.FirstStart.P50Nanoseconds / 1e3, Stats.FirstStart.P99Nanoseconds / 1e3,
+                   Stats.Complete.P50Nanoseconds / 1e3, Stats.Complete.P99Nanoseconds / 1e3);
+        }
+    }
+
+    BenchStopWorkers(EngineMemory);
+
+    return 0;
+}
@@ -0,0 +1,41 @@
+@echo off
+rem Builds the benchmarks with cl into benchmarks\build. Run from a Visual Studio
+rem developer prompt. Pass benchmark names (bench_parallel ...) to build only those;
+rem run the executables yourself.
+
+setlocal
+set Root=%~dp0..
+set Out=%~dp0build
+set Flags=/nologo /std:c11 /O2 /Zi /I"%Root%" /I"%Root%\engine" /I"%Root%\benchmarks" /DENGINE_PROFILER=0
+
+rem Every benchmark links the same engine core; unused files cost link time only.
+set Core="%Root%\benchmarks\bench.c" "%Root%\utilities.c" "%Root%\platform\win32_os.c" "%Root%\platform\win32_work_queue.c" ^
+         "%Root%\platform\win32_frame_pacer.c" ^
+         "%Root%\engine\math\vector.c" "%Root%\engine\math\matrix.c" "%Root%\engine\math\vector_batch.c" ^
+         "%Root%\engine\math\fast_math.c" ^
+         "%Root%\engine\jobs\parallel.c" "%Root%\engine\rendering\renderer.c" ^
+         "%Root%\engine\rendering\renderer_internal.c" "%Root%\engine\rendering\resources.c" ^
+         "%Root%\engine\rendering\draw.c" "%Root%\engine\scene\transform.c" "%Root%\game\world\chunk.c" ^
+         "%Root%\game\world\world.c" "%Root%\benchmarks\null_renderer.c"
+
+if not exist "%Out%" mkdir "%Out%"
+pushd "%Out%"
+
+set Names=%*
+if "%Names%"=="" (
+    for %%F in ("%Root%\benchmarks\bench_*.c") do call :Build %%~nF || goto :Failed
+) else (
+    for %%N in (%Names%) do call :Build %%N || goto :Failed
+)
+
+popd
+exit /b 0
+
+:Build
+echo == %1
+cl %Flags% /Fe:%1.exe "%Root%\benchmarks\%1.c" %Core% /link winmm.lib
+exit /b %ERRORLEVEL%
+
+:Failed
+popd
+exit /b 1
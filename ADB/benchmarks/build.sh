@@ -0,0 +1,31 @@
+#!/bin/sh
+# Builds the benchmarks on a POSIX system into benchmarks/build. Pass benchmark
+# names (bench_parallel ...) to build only those; run the binaries yourself. CC
+# defaults to cc. Threaded runs need the Win32 work queue and are skipped here.
+
+set -e
+
+Root=$(cd "$(dirname "$0")/.." && pwd)
+Out="$Root/benchmarks/build"
+CC=${CC:-cc}
+Flags="-std=gnu11 -O2 -g -I$Root -I$Root/engine -I$Root/benchmarks -DENGINE_PROFILER=0"
+
+# Every benchmark links the same engine core; unused files cost link time only.
+Core="$Root/benchmarks/bench.c $Root/utilities.c $Root/platform/posix_os.c
+      $Root/engine/math/vector.c $Root/engine/math/matrix.c $Root/engine/math/vector_batch.c
+      $Root/engine/math/fast_math.c
+      $Root/engine/jobs/parallel.c $Root/engine/rendering/renderer.c
+      $Root/engine/rendering/renderer_internal.c $Root/engine/rendering/resources.c
+      $Root/engine/rendering/draw.c $Root/engine/scene/transform.c $Root/game/world/chunk.c
+      $Root/game/world/world.c $Root/benchmarks/null_renderer.c"
+
+mkdir -p "$Out"
+
+if [ $# -eq 0 ]; then
+    set -- $(cd "$Root/benchmarks" && ls bench_*.c | sed 's/\.c$//')
+fi
+
+for Name in "$@"; do
+    echo "== $Name"
+    $CC $Flags -o "$Out/$Name" "$Root/benchmarks/$Name.c" $Core -lm -lpthread
+done
@@ -0,0 +1,144 @@
+#include "null_renderer.h"
+
+#include <assert.h>
+#include <stdlib.h>
+#include <string.h>
+
+#include "engine/rendering/resources.h"
+
+
+typedef struct
+{
+    uint8_t *Data;
+    uint64_t Size;
+} null_buffer;
+
+
+static null_renderer_stats NullStats;
+
+
+static void *
+NullCreateBuffer(void *Data, uint64_t Size)
+{
+    null_buffer *Result = 0;
+
+    if (Size)
+    {
+        Result       = malloc(sizeof(null_buffer));
+        Result->Data = malloc(Size);
+        Result->Size = Size;
+
+        if (Data)
+        {
+            memcpy(Result->Data, Data, Size);
+        }
+
+        AtomicAddU64(&NullStats.BuffersCreated, 1);
+        AtomicAddU64(&NullStats.BytesCreated, Size);
+        AtomicAddU64(&NullStats.LiveBytes, Size);
+    }
+
+    return Result;
+}
+
+
+void *
+RendererCreateVertexBuffer(void *Data, uint64_t Size, renderer *Renderer)
+{
+    Unused(Renderer);
+
+    void *Result = NullCreateBuffer(Data, Size);
+    return Result;
+}
+
+
+void *
+RendererCreateIndexBuffer(void *Data, uint64_t Size, renderer *Renderer)
+{
+    Unused(Renderer);
+
+    void *Result = NullCreateBuffer(Data, Size);
+    return Result;
+}
+
+
+void
+RendererUpdateBuffer(void *Buffer, uint64_t Offset, void *Data, uint64_t Size, renderer *Renderer)
+{
+    Unused(Renderer);
+
+    null_buffer *Null = (null_buffer *)Buffer;
+
+    if (Null && Data && Size)
+    {
+        assert(Offset + Size <= Null->Size);
+
+        memcpy(Null->Data + Offset, Data, Size);
+
+        AtomicAddU64(&NullStats.BytesUpdated, Size);
+    }
+}
+
+
+void
+RendererReleaseBuffer(void *Buffer, renderer *Renderer)
+{
+    Unused(Renderer);
+
+    null_buffer *Null = (null_buffer *)Buffer;
+
+    if (Null)
+    {
+        AtomicAddU64(&NullStats.BuffersReleased, 1);
+        AtomicAddU64(&NullStats.LiveBytes, (uint64_t)0 - Null->Size);
+
+        free(Null->Data);
+        free(Null);
+    }
+}
+
+
+// Textures are never sampled, so any non-null handle will do. They are not counted:
+// the stats are about mesh traffic.
+void *
+RendererCreateTexture(loaded_texture Texture, renderer *Renderer)
+{
+    Unused(Renderer);
+
+    static uint8_t NullTexture;
+
+    void *Result = Texture.Data ? &NullTexture : 0;
+    return Result;
+}
+
+
+renderer *
+CreateNullRenderer(memory_arena *Arena)
+{
+    renderer *Result = PushStruct(Arena, renderer);
+    if (Result)
+    {
+        Result->Resources      = CreateResourceManager(Arena);
+        Result->ReferenceTable = CreateResourceReferenceTable(Arena);
+    }
+
+    return Result;
+}
+
+
+null_renderer_stats
+GetNullRendererStats(void)
+{
+    null_renderer_stats Result = NullStats;
+    return Result;
+}
+
+
+void
+ResetNullRendererStats(void)
+{
+    uint64_t LiveBytes = NullStats.LiveBytes;
+
+    memset(&NullStats, 0, sizeof(NullStats));
+    NullStats.LiveBytes = LiveBytes;
+}
@@ -0,0 +1,33 @@
+#pragma once
+
+#include <stdint.h>
+
+#include "utilities.h"
+#include "engine/rendering/renderer_internal.h"
+
+// =====================================================
+// [SECTION] Null Renderer Backend
+// [DESCRIP]
+//   Implements the backend hooks of renderer_internal.h
+//   without a GPU, so the benchmarks can link the chunk,
+//   world and draw code. Buffers live in host memory and
+//   are really written, so uploads cost a memcpy like a
+//   staging copy would. Every byte handed to the backend
+//   is counted in null_renderer_stats.
+// =====================================================
+
+typedef struct null_renderer_stats
+{
+    uint64_t BuffersCreated;
+    uint64_t BuffersReleased;
+    uint64_t BytesCreated;
+    uint64_t BytesUpdated;
+    uint64_t LiveBytes;
+} null_renderer_stats;
+
+// A renderer with a resource manager and reference table, as WinMain sets one up,
+// and no backend.
+renderer            *CreateNullRenderer      (memory_arena *Arena);
+
+null_renderer_stats  GetNullRendererStats    (void);
+void                 ResetNullRendererStats  (void);
@@ -7,7 +7,9 @@
 #include "rendering/renderer.h"
 #include "rendering/draw.h"
 #include "math/vector.h"
-#include "game/world/chunk.h"
+#include "scene/transform.h"
+#include "game/world/world.h"
+#include "profiler/profiler.h"
 
 
 // TODO: Clear the renderer API. Just remove all the bullshit and get something basic working.
@@ -16,31 +18,68 @@
 void
 UpdateEngine(int WindowWidth, int WindowHeight, gui_input_queue *InputQueue, renderer *Renderer, engine_memory *EngineMemory)
 {
+    ProfileBegin(UpdateEngine);
+
     RendererEnterFrame((clear_color) { .R = 0.f, .G = 0.f, .B = 0.f, .A = 1.f }, Renderer);
 
 	{
-		camera Camera = CreateCamera(Vec3(0.0f, 0.0f, -10.0f), 60.0f, (float)WindowWidth / (float)WindowHeight);
+		// The camera hangs off a rig node, so moving the rig (or anything it is
+		// parented to) moves the camera.
+		static bool                 CameraCreated = false;
+		static camera               Camera;
+		static transform_hierarchy *Scene;
+		static transform_handle     CameraRig;
+		if (!CameraCreated)
+		{
+			Scene         = CreateTransformHierarchy(1024, EngineMemory->StateMemory);
+			CameraRig     = CreateTransform((transform_handle){0}, Vec3(0.0f, 0.0f, -10.0f), QuatIdentity(), Vec3(1.0f, 1.0f, 1.0f), Scene);
+			Camera        = CreateCamera(Vec3(0.0f, 0.0f, 0.0f), 60.0f, (float)WindowWidth / (float)WindowHeight);
+			CameraCreated = true;
+		}
+
+		UpdateTransforms(Scene, EngineMemory->FrameMemory, EngineMemory);
+		SetCameraParent(*GetTransformWorldMatrix(CameraRig, Scene), &Camera);
+
+		if (WindowHeight > 0)
+		{
+			SetCameraAspectRatio((float)WindowWidth / (float)WindowHeight, &Camera);
+		}
 
 		//for (float X = -5; X < 5; ++X)
 		//{
 		//	for (float Y = -5; Y < 5; ++Y)
 		//	{
-		//		DrawGizmoCell(Vec3(X, Y, 0.0f), Vec3(1.0f, 1.0f, 1.0f), &Camera, Renderer, EngineMemory->FrameMemory);
+		//		DrawGizmoCell(Vec3(X, Y, 0.0f), Vec3(1.0f, 1.0f, 1.0f), &Camera, GetRenderContext(0, Renderer));
 		//	}
 		//}
 
-		static bool  FirstFrame = true;
-		static chunk Chunk     = {0};
-		if (FirstFrame)
+		// Chunks stream in around the camera. Building them runs on background jobs, so
+		// the frame only pays for the uploads, which are capped by UploadBudget.
+		static world *World = 0;
+		if (!World)
 		{
-			Chunk = CreateChunk(Renderer, EngineMemory->FrameMemory);
+			world_params Params =
+			{
+				.Mesh          = ChunkMesh_Greedy,
+				.LoadRadius    = 4,
+				.UnloadRadius  = 5,
+				.BuildJobCount = 8,
+				.UploadBudget  = KiB(64),
+				.Seed          = 1,
+			};
 
-			FirstFrame = false;
+			World = CreateWorld(Params, EngineMemory->StateMemory);
 		}
 
-		DrawChunk(&Camera, Renderer, EngineMemory->FrameMemory, &Chunk);
+		mat4x4 CameraWorld    = GetCameraWorldMatrix(&Camera);
+		vec3   CameraPosition = Vec3(CameraWorld.c3r0, CameraWorld.c3r1, CameraWorld.c3r2);
+
+		UpdateWorld(CameraPosition, World, Renderer, EngineMemory->FrameMemory, EngineMemory);
+		DrawWorld(&Camera, World, Renderer, EngineMemory->FrameMemory, EngineMemory);
 	}
 
 
 	RendererLeaveFrame(WindowWidth, WindowHeight, EngineMemory, Renderer);
+
+    ProfileEnd(UpdateEngine);
 } 
\ No newline at end of file
@@ -0,0 +1,322 @@
+#include "parallel.h"
+
+#include <stdint.h>
+#include <stdbool.h>
+#include <string.h>
+
+#include "utilities.h"
+#include "platform/platform.h"
+
+
+// =====================================================
+// [SECTION] Internal Types
+// =====================================================
+
+
+typedef struct
+{
+    uint64_t volatile      Next;
+    uint64_t               End;
+    uint64_t               Grain;
+    uint64_t               ParticipantCount;
+    parallel_for_callback *Callback;
+    void                  *Context;
+} parallel_for_job;
+
+
+typedef struct
+{
+    uint64_t                  Begin;
+    uint64_t                  End;
+    uint64_t                  BlockSize;
+    uint64_t                  PartialSize;
+    uint8_t                  *Partials;
+    void                     *Identity;
+    parallel_reduce_callback *Reduce;
+    void                     *Context;
+} parallel_reduce_job;
+
+
+typedef struct
+{
+    uint32_t *Values;
+    uint32_t *Output;
+    uint64_t  Count;
+    uint64_t  BlockSize;
+    uint32_t *BlockSums;
+} parallel_scan_job;
+
+
+// =====================================================
+// [SECTION] Parallel For
+// =====================================================
+
+
+static bool
+ClaimParallelRange(parallel_for_job *Job, uint64_t *OutBegin, uint64_t *OutEnd)
+{
+    uint64_t Begin = Job->Next;
+
+    while (Begin < Job->End)
+    {
+        uint64_t Remaining = Job->End - Begin;
+        uint64_t Size      = Maximum(Job->Grain, Remaining / (2 * Job->ParticipantCount));
+        uint64_t End       = Begin + Minimum(Size, Remaining);
+
+        uint64_t Observed = AtomicCompareExchangeU64(&Job->Next, End, Begin);
+        if (Observed == Begin)
+        {
+            *OutBegin = Begin;
+            *OutEnd   = End;
+
+            return true;
+        }
+
+        Begin = Observed;
+    }
+
+    return false;
+}
+
+
+static void
+RunParallelForJob(parallel_for_job *Job)
+{
+    uint64_t Begin = 0;
+    uint64_t End   = 0;
+
+    while (ClaimParallelRange(Job, &Begin, &End))
+    {
+        Job->Callback(Begin, End, Job->Context);
+    }
+}
+
+
+static void
+ParallelForEntry(platform_work_queue *Queue, void *Data)
+{
+    Unused(Queue);
+
+    RunParallelForJob((parallel_for_job *)Data);
+}
+
+
+void
+ParallelFor(uint64_t Begin, uint64_t End, uint64_t Grain, parallel_for_callback *Callback, void *Context, engine_memory *EngineMemory)
+{
+    if (!Callback || Begin >= End)
+    {
+        return;
+    }
+
+    Grain = Maximum(Grain, 1);
+
+    uint64_t Count       = End - Begin;
+    uint64_t ChunkCount  = (Count + Grain - 1) / Grain;
+    uint64_t HelperCount = 0;
+
+    if (EngineMemory && EngineMemory->AddEntries && EngineMemory->WaitForCounter)
+    {
+        HelperCount = Minimum((uint64_t)EngineMemory->WorkerCount, ChunkCount - 1);
+    }
+
+    if (HelperCount == 0)
+    {
+        Callback(Begin, End, Context);
+        return;
+    }
+
+    parallel_for_job Job =
+    {
+        .Next             = Begin,
+        .End              = End,
+        .Grain            = Grain,
+        .ParticipantCount = HelperCount + 1,
+        .Callback         = Callback,
+        .Context          = Context,
+    };
+
+    // Helpers that start after the range is drained return immediately.
+    platform_work_counter Counter = {0};
+    EngineMemory->AddEntries(EngineMemory->WorkQueue, ParallelForEntry, &Job, 0, (uint32_t)HelperCount, &Counter);
+
+    RunParallelForJob(&Job);
+
+    EngineMemory->WaitForCounter(EngineMemory->WorkQueue, &Counter);
+}
+
+
+// =====================================================
+// [SECTION] Block Helpers
+// [DESCRIP]
+//   Reduce and scan work on fixed blocks so partial
+//   results land in a known slot, then hand the block
+//   indices to ParallelFor for load balancing.
+// =====================================================
+
+
+static uint64_t
+GetParallelBlockSize(uint64_t Count, uint64_t Grain)
+{
+    uint64_t Result = (Count + PARALLEL_MAX_BLOCKS - 1) / PARALLEL_MAX_BLOCKS;
+    Result = Maximum(Result, Grain);
+    Result = Maximum(Result, 1);
+
+    return Result;
+}
+
+
+// =====================================================
+// [SECTION] Parallel Reduce
+// =====================================================
+
+
+static void
+ReduceParallelBlocks(uint64_t FirstBlock, uint64_t LastBlock, void *Context)
+{
+    parallel_reduce_job *Job = (parallel_reduce_job *)Context;
+
+    for (uint64_t Block = FirstBlock; Block < LastBlock; ++Block)
+    {
+        uint8_t *Partial = Job->Partials + Block * Job->PartialSize;
+        uint64_t Begin   = Job->Begin + Block * Job->BlockSize;
+        uint64_t End     = Minimum(Begin + Job->BlockSize, Job->End);
+
+        memcpy(Partial, Job->Identity, Job->PartialSize);
+        Job->Reduce(Begin, End, Partial, Job->Context);
+    }
+}
+
+
+void
+ParallelReduce(uint64_t Begin, uint64_t End, uint64_t Grain, void *Identity, uint64_t PartialSize,
+               parallel_reduce_callback *Reduce, parallel_combine_callback *Combine, void *Context,
+               void *Result, memory_arena *Arena, engine_memory *EngineMemory)
+{
+    if (!Identity || !PartialSize || !Reduce || !Combine || !Result || !Arena)
+    {
+        return;
+    }
+
+    memcpy(Result, Identity, PartialSize);
+
+    if (Begin >= End)
+    {
+        return;
+    }
+
+    uint64_t Count      = End - Begin;
+    uint64_t BlockSize  = GetParallelBlockSize(Count, Grain);
+    uint64_t BlockCount = (Count + BlockSize - 1) / BlockSize;
+
+    memory_region Region   = EnterMemoryRegion(Arena);
+    uint8_t      *Partials = PushArray(Arena, uint8_t, BlockCount * PartialSize);
+
+    if (Partials)
+    {
+        parallel_reduce_job Job =
+        {
+            .Begin       = Begin,
+            .End         = End,
+            .BlockSize   = BlockSize,
+            .PartialSize = PartialSize,
+            .Partials    = Partials,
+            .Identity    = Identity,
+            .Reduce      = Reduce,
+            .Context     = Context,
+        };
+
+        ParallelFor(0, BlockCount, 1, ReduceParallelBlocks, &Job, EngineMemory);
+
+        for (uint64_t Block = 0; Block < BlockCount; ++Block)
+        {
+            Combine(Result, Partials + Block * PartialSize, Context);
+        }
+    }
+
+    LeaveMemoryRegion(Region);
+}
+
+
+// =====================================================
+// [SECTION] Parallel Prefix Sum
+// =====================================================
+
+
+static void
+SumParallelBlocks(uint64_t FirstBlock, uint64_t LastBlock, void *Context)
+{
+    parallel_scan_job *Job = (parallel_scan_job *)Context;
+
+    for (uint64_t Block = FirstBlock; Block < LastBlock; ++Block)
+    {
+        uint64_t Begin = Block * Job->BlockSize;
+        uint64_t End   = Minimum(Begin + Job->BlockSize, Job->Count);
+        uint32_t Sum   = 0;
+
+        for (uint64_t Idx = Begin; Idx < End; ++Idx)
+        {
+            Sum += Job->Values[Idx];
+        }
+
+        Job->BlockSums[Block] = Sum;
+    }
+}
+
+
+static void
+ScanParallelBlocks(uint64_t FirstBlock, uint64_t LastBlock, void *Context)
+{
+    parallel_scan_job *Job = (parallel_scan_job *)Context;
+
+    for (uint64_t Block = FirstBlock; Block < LastBlock; ++Block)
+    {
+        uint64_t Begin   = Block * Job->BlockSize;
+        uint64_t End     = Minimum(Begin + Job->BlockSize, Job->Count);
+        uint32_t Running = Job->BlockSums[Block];
+
+        for (uint64_t Idx = Begin; Idx < End; ++Idx)
+        {
+            uint32_t Value = Job->Values[Idx];
+            Job->Output[Idx] = Running;
+            Running         += Value;
+        }
+    }
+}
+
+
+uint32_t
+ParallelPrefixSum(uint32_t *Values, uint32_t *Output, uint64_t Count, uint64_t Grain, engine_memory *EngineMemory)
+{
+    if (!Values || !Output || !Count)
+    {
+        return 0;
+    }
+
+    uint32_t BlockSums[PARALLEL_MAX_BLOCKS];
+
+    parallel_scan_job Job =
+    {
+        .Values    = Values,
+        .Output    = Output,
+        .Count     = Count,
+        .BlockSize = GetParallelBlockSize(Count, Grain),
+        .BlockSums = BlockSums,
+    };
+
+    uint64_t BlockCount = (Count + Job.BlockSize - 1) / Job.BlockSize;
+
+    ParallelFor(0, BlockCount, 1, SumParallelBlocks, &Job, EngineMemory);
+
+    uint32_t Total = 0;
+    for (uint64_t Block = 0; Block < BlockCount; ++Block)
+    {
+        uint32_t Sum = BlockSums[Block];
+        BlockSums[Block] = Total;
+        Total           += Sum;
+    }
+
+    ParallelFor(0, BlockCount, 1, ScanParallelBlocks, &Job, EngineMemory);
+
+    return Total;
+}
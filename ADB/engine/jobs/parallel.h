@@ -0,0 +1,53 @@
+#pragma once
+
+#include <stdint.h>
+
+
+// =====================================================
+// [SECTION] Forward Declarations
+// =====================================================
+
+
+typedef struct engine_memory engine_memory;
+typedef struct memory_arena  memory_arena;
+
+
+// =====================================================
+// [SECTION] Parallel Range API
+// [DESCRIP]
+//   Ranges are split over the worker pool and the calling
+//   thread takes part in the work. Every call returns once
+//   the whole range has been processed, which makes them
+//   usable from inside other jobs (see WaitForCounter).
+//   Grain is the smallest range handed to a callback.
+// =====================================================
+
+
+#define PARALLEL_MAX_BLOCKS 256
+
+
+typedef void parallel_for_callback      (uint64_t Begin, uint64_t End, void *Context);
+typedef void parallel_reduce_callback   (uint64_t Begin, uint64_t End, void *Partial, void *Context);
+typedef void parallel_combine_callback  (void *Into, void *From, void *Context);
+
+
+// Chunks shrink as the range drains (each claim takes a share of what remains), so
+// early claims amortize scheduling and late claims balance the tail.
+
+void      ParallelFor        (uint64_t Begin, uint64_t End, uint64_t Grain, parallel_for_callback *Callback, void *Context, engine_memory *EngineMemory);
+
+
+// Every block reduces into its own copy of 'Identity'. Partials are combined in block
+// order on the calling thread, so the result is deterministic even for operations
+// that are not commutative. Scratch memory is taken from 'Arena' and released before
+// returning.
+
+void      ParallelReduce     (uint64_t Begin, uint64_t End, uint64_t Grain, void *Identity, uint64_t PartialSize,
+                              parallel_reduce_callback *Reduce, parallel_combine_callback *Combine, void *Context,
+                              void *Result, memory_arena *Arena, engine_memory *EngineMemory);
+
+
+// Exclusive prefix sum. Output may alias Values. Returns the sum of every value
+// (wrapping like the output does).
+
+uint32_t  ParallelPrefixSum  (uint32_t *Values, uint32_t *Output, uint64_t Count, uint64_t Grain, engine_memory *EngineMemory);
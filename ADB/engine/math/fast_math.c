@@ -0,0 +1,232 @@
+#include <stdint.h>
+#include <string.h>
+
+#include <xmmintrin.h>
+#include <emmintrin.h>
+
+#include "fast_math.h"
+
+// ==============================================
+// <Internal>
+// ==============================================
+
+// Pi split so that Q * Part is exact for |Q| < 2^15 without FMA (Cody-Waite). The
+// halves reduce by pi/2, the whole parts by pi.
+
+#define FAST_PI_A 3.140625f
+#define FAST_PI_B 0.0009670257568359375f
+#define FAST_PI_C 6.2771141529083251953e-07f
+#define FAST_PI_D 1.2154201256553420762e-10f
+
+#define FAST_INV_PI      0.318309886183790671538f
+#define FAST_TWO_OVER_PI 0.636619772367581343076f
+
+
+static __m128
+Select4(__m128 Mask, __m128 IfTrue, __m128 IfFalse)
+{
+    __m128 Result = _mm_or_ps(_mm_and_ps(Mask, IfTrue), _mm_andnot_ps(Mask, IfFalse));
+    return Result;
+}
+
+
+static __m128
+ReduceByPi4(__m128 X, __m128 Q, float Scale)
+{
+    X = _mm_sub_ps(X, _mm_mul_ps(Q, _mm_set1_ps(FAST_PI_A * Scale)));
+    X = _mm_sub_ps(X, _mm_mul_ps(Q, _mm_set1_ps(FAST_PI_B * Scale)));
+    X = _mm_sub_ps(X, _mm_mul_ps(Q, _mm_set1_ps(FAST_PI_C * Scale)));
+    X = _mm_sub_ps(X, _mm_mul_ps(Q, _mm_set1_ps(FAST_PI_D * Scale)));
+
+    return X;
+}
+
+
+// Minimax polynomial for sin on [-pi/2, pi/2].
+static __m128
+SinPolynomial4(__m128 R)
+{
+    __m128 R2     = _mm_mul_ps(R, R);
+    __m128 Result = _mm_set1_ps(2.6083159809786593541503e-06f);
+
+    Result = _mm_add_ps(_mm_mul_ps(Result, R2), _mm_set1_ps(-0.0001981069071916863322258f));
+    Result = _mm_add_ps(_mm_mul_ps(Result, R2), _mm_set1_ps( 0.00833307858556509017944336f));
+    Result = _mm_add_ps(_mm_mul_ps(Result, R2), _mm_set1_ps(-0.166666597127914428710938f));
+    Result = _mm_add_ps(_mm_mul_ps(_mm_mul_ps(Result, R2), R), R);
+
+    return Result;
+}
+
+
+static __m128
+FastRsqrt4(__m128 X)
+{
+    __m128 Estimate = _mm_rsqrt_ps(X);
+    __m128 Square   = _mm_mul_ps(_mm_mul_ps(X, Estimate), Estimate);
+    __m128 Result   = _mm_mul_ps(_mm_mul_ps(_mm_set1_ps(0.5f), Estimate), _mm_sub_ps(_mm_set1_ps(3.f), Square));
+
+    return Result;
+}
+
+
+// X = R + Q * pi: sin(X) = (-1)^Q sin(R).
+static __m128
+FastSin4(__m128 X)
+{
+    __m128i Q = _mm_cvtps_epi32(_mm_mul_ps(X, _mm_set1_ps(FAST_INV_PI)));
+    __m128  R = ReduceByPi4(X, _mm_cvtepi32_ps(Q), 1.f);
+
+    __m128 Sign   = _mm_castsi128_ps(_mm_slli_epi32(Q, 31));
+    __m128 Result = _mm_xor_ps(SinPolynomial4(R), Sign);
+
+    return Result;
+}
+
+
+// X = R + Q * pi/2 with Q odd: cos(X) = -sin(R) when bit 1 of Q is clear.
+static __m128
+FastCos4(__m128 X)
+{
+    __m128  Half = _mm_sub_ps(_mm_mul_ps(X, _mm_set1_ps(FAST_INV_PI)), _mm_set1_ps(0.5f));
+    __m128i Q    = _mm_add_epi32(_mm_add_epi32(_mm_cvtps_epi32(Half), _mm_cvtps_epi32(Half)), _mm_set1_epi32(1));
+    __m128  R    = ReduceByPi4(X, _mm_cvtepi32_ps(Q), 0.5f);
+
+    __m128 Sign   = _mm_castsi128_ps(_mm_slli_epi32(_mm_andnot_si128(Q, _mm_set1_epi32(2)), 30));
+    __m128 Result = _mm_xor_ps(SinPolynomial4(R), Sign);
+
+    return Result;
+}
+
+
+// X = R + Q * pi/2 with |R| <= pi/4, where cos(R) >= 0.7 is recovered from sin(R)
+// without cancellation. tan(X) = tan(R) for even Q and -1/tan(R) for odd Q.
+static __m128
+FastTan4(__m128 X)
+{
+    __m128i Q = _mm_cvtps_epi32(_mm_mul_ps(X, _mm_set1_ps(FAST_TWO_OVER_PI)));
+    __m128  R = ReduceByPi4(X, _mm_cvtepi32_ps(Q), 0.5f);
+
+    __m128 Sin = SinPolynomial4(R);
+    __m128 Cos = _mm_sqrt_ps(_mm_sub_ps(_mm_set1_ps(1.f), _mm_mul_ps(Sin, Sin)));
+
+    __m128 Odd    = _mm_castsi128_ps(_mm_cmpeq_epi32(_mm_and_si128(Q, _mm_set1_epi32(1)), _mm_set1_epi32(1)));
+    __m128 Even   = _mm_div_ps(Sin, Cos);
+    __m128 Result = Select4(Odd, _mm_xor_ps(_mm_div_ps(Cos, Sin), _mm_set1_ps(-0.f)), Even);
+
+    return Result;
+}
+
+
+// X = Q + F with |F| <= 1/2: 2^X = 2^Q * P(F).
+static __m128
+FastExp2_4(__m128 X)
+{
+    X = _mm_min_ps(_mm_max_ps(X, _mm_set1_ps(-150.f)), _mm_set1_ps(128.f));
+
+    __m128i Q = _mm_cvtps_epi32(X);
+    __m128  F = _mm_sub_ps(X, _mm_cvtepi32_ps(Q));
+
+    __m128 P = _mm_set1_ps(0.1535920892e-3f);
+    P = _mm_add_ps(_mm_mul_ps(P, F), _mm_set1_ps(0.1339262701e-2f));
+    P = _mm_add_ps(_mm_mul_ps(P, F), _mm_set1_ps(0.9618384764e-2f));
+    P = _mm_add_ps(_mm_mul_ps(P, F), _mm_set1_ps(0.5550347269e-1f));
+    P = _mm_add_ps(_mm_mul_ps(P, F), _mm_set1_ps(0.2402264476e+0f));
+    P = _mm_add_ps(_mm_mul_ps(P, F), _mm_set1_ps(0.6931471825e+0f));
+    P = _mm_add_ps(_mm_mul_ps(P, F), _mm_set1_ps(1.f));
+
+    // 2^Q is applied in two halves so every Q in [-150, 128] has valid exponents:
+    // results between 2^127.5 and FLT_MAX stay finite, and small ones go denormal.
+    __m128i QLow   = _mm_srai_epi32(Q, 1);
+    __m128i QHigh  = _mm_sub_epi32(Q, QLow);
+    __m128  Low    = _mm_castsi128_ps(_mm_slli_epi32(_mm_add_epi32(QLow, _mm_set1_epi32(127)), 23));
+    __m128  High   = _mm_castsi128_ps(_mm_slli_epi32(_mm_add_epi32(QHigh, _mm_set1_epi32(127)), 23));
+    __m128  Result = _mm_mul_ps(_mm_mul_ps(P, Low), High);
+
+    return Result;
+}
+
+
+// X = 2^E * M with M in [sqrt(1/2), sqrt(2)). With T = (M - 1) / (M + 1),
+// log2(M) = 2/ln(2) * atanh(T), and |T| <= 0.172 lets the series stop at T^9.
+static __m128
+FastLog2_4(__m128 X)
+{
+    __m128i Bits     = _mm_castps_si128(X);
+    __m128i Exponent = _mm_sub_epi32(_mm_srli_epi32(Bits, 23), _mm_set1_epi32(127));
+    __m128  Mantissa = _mm_castsi128_ps(_mm_or_si128(_mm_and_si128(Bits, _mm_set1_epi32(0x007FFFFF)), _mm_set1_epi32(0x3F800000)));
+
+    __m128 Above = _mm_cmpgt_ps(Mantissa, _mm_set1_ps(1.41421356f));
+    Mantissa = Select4(Above, _mm_mul_ps(Mantissa, _mm_set1_ps(0.5f)), Mantissa);
+    Exponent = _mm_sub_epi32(Exponent, _mm_castps_si128(Above));
+
+    __m128 One = _mm_set1_ps(1.f);
+    __m128 T   = _mm_div_ps(_mm_sub_ps(Mantissa, One), _mm_add_ps(Mantissa, One));
+    __m128 T2  = _mm_mul_ps(T, T);
+
+    __m128 P = _mm_set1_ps(0.3205988980f);
+    P = _mm_add_ps(_mm_mul_ps(P, T2), _mm_set1_ps(0.4121985831f));
+    P = _mm_add_ps(_mm_mul_ps(P, T2), _mm_set1_ps(0.5770780164f));
+    P = _mm_add_ps(_mm_mul_ps(P, T2), _mm_set1_ps(0.9617966939f));
+    P = _mm_add_ps(_mm_mul_ps(P, T2), _mm_set1_ps(2.8853900818f));
+
+    __m128 Result = _mm_add_ps(_mm_cvtepi32_ps(Exponent), _mm_mul_ps(P, T));
+
+    return Result;
+}
+
+
+typedef __m128 fast_math_kernel(__m128 X);
+
+static void
+RunBatch(fast_math_kernel *Kernel, float *In, float *Out, uint64_t Count)
+{
+    uint64_t Idx = 0;
+
+    for (; Idx + 4 <= Count; Idx += 4)
+    {
+        _mm_storeu_ps(Out + Idx, Kernel(_mm_loadu_ps(In + Idx)));
+    }
+
+    // Tail through a padded copy; the extra lanes compute on 1.0, valid for every kernel.
+    if (Idx < Count)
+    {
+        float Tail[4] = { 1.f, 1.f, 1.f, 1.f };
+        memcpy(Tail, In + Idx, (Count - Idx) * sizeof(float));
+
+        _mm_storeu_ps(Tail, Kernel(_mm_loadu_ps(Tail)));
+        memcpy(Out + Idx, Tail, (Count - Idx) * sizeof(float));
+    }
+}
+
+// ==============================================
+// <Fast Math> : PUBLIC
+// ==============================================
+
+float FastRsqrt(float X) { return _mm_cvtss_f32(FastRsqrt4(_mm_set_ss(X))); }
+float FastSin(float X)   { return _mm_cvtss_f32(FastSin4(_mm_set_ss(X)));   }
+float FastCos(float X)   { return _mm_cvtss_f32(FastCos4(_mm_set_ss(X)));   }
+float FastTan(float X)   { return _mm_cvtss_f32(FastTan4(_mm_set_ss(X)));   }
+float FastExp2(float X)  { return _mm_cvtss_f32(FastExp2_4(_mm_set_ss(X))); }
+float FastLog2(float X)  { return _mm_cvtss_f32(FastLog2_4(_mm_set_ss(X))); }
+
+
+vec3
+Vec3NormalizeFast(vec3 V)
+{
+    float LengthSquared = Vec3Dot(V, V);
+    if (LengthSquared == 0.f)
+    {
+        return V;
+    }
+
+    vec3 Result = Vec3Scale(V, FastRsqrt(LengthSquared));
+    return Result;
+}
+
+
+void FastRsqrtBatch(float *In, float *Out, uint64_t Count) { RunBatch(FastRsqrt4, In, Out, Count); }
+void FastSinBatch(float *In, float *Out, uint64_t Count)   { RunBatch(FastSin4, In, Out, Count);   }
+void FastCosBatch(float *In, float *Out, uint64_t Count)   { RunBatch(FastCos4, In, Out, Count);   }
+void FastTanBatch(float *In, float *Out, uint64_t Count)   { RunBatch(FastTan4, In, Out, Count);   }
+void FastExp2Batch(float *In, float *Out, uint64_t Count)  { RunBatch(FastExp2_4, In, Out, Count); }
+void FastLog2Batch(float *In, float *Out, uint64_t Count)  { RunBatch(FastLog2_4, In, Out, Count); }
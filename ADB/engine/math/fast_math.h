@@ -0,0 +1,48 @@
+#pragma once
+
+#include <stdint.h>
+
+#include "vector.h"
+
+// =====================================================
+// [SECTION] Fast Math
+// [DESCRIP]
+//   Approximations for code that does not need libm
+//   precision (animation, particles, culling). They are
+//   opt-in: nothing in the engine switches to them
+//   implicitly. Scalar and batch versions share one
+//   4-wide SSE2 implementation and return identical
+//   results.
+//
+//   Bounds below were measured over dense sweeps of the
+//   stated domains against double precision. Outside
+//   the domains the results are unspecified (no traps).
+// =====================================================
+
+// 1 / sqrt(X), rsqrtps refined by one Newton-Raphson step.
+// X > 0 normal. Relative error < 4e-7.
+float FastRsqrt (float X);
+
+// |X| <= 39000. Absolute error < 2e-7 (sin, cos), relative error < 4e-7 (tan).
+float FastSin   (float X);
+float FastCos   (float X);
+float FastTan   (float X);
+
+// Exp2: X in [-126, 128), relative error < 2e-7. Results go denormal below -126
+// (with less precision), zero below -149 and +inf from 128.
+// Log2: X > 0 normal. Absolute error < 2e-7 for X in [0.5, 2), and elsewhere less
+// than 1e-7 plus one ulp of the result.
+float FastExp2  (float X);
+float FastLog2  (float X);
+
+// Zero-length vectors are returned untouched, like Vec3Normalize.
+vec3  Vec3NormalizeFast (vec3 V);
+
+// Element-wise over arrays, any alignment and count. Out may alias In.
+
+void FastRsqrtBatch (float *In, float *Out, uint64_t Count);
+void FastSinBatch   (float *In, float *Out, uint64_t Count);
+void FastCosBatch   (float *In, float *Out, uint64_t Count);
+void FastTanBatch   (float *In, float *Out, uint64_t Count);
+void FastExp2Batch  (float *In, float *Out, uint64_t Count);
+void FastLog2Batch  (float *In, float *Out, uint64_t Count);
@@ -0,0 +1,386 @@
+#include <stdint.h>
+#include <math.h>
+
+#include <xmmintrin.h>
+#include <emmintrin.h>
+
+#include "matrix.h"
+#include "vector.h"
+
+// ==============================================
+// <Internal>
+// ==============================================
+
+// Columns live in one register each. mat4x4 has no alignment guarantee, so loads
+// and stores are unaligned (free on anything recent when the data is aligned).
+
+typedef struct
+{
+    __m128 Columns[4];
+} mat4x4_simd;
+
+#define Mat4Swizzle(V, X, Y, Z, W)  _mm_shuffle_ps((V), (V), _MM_SHUFFLE(W, Z, Y, X))
+#define Mat4Shuffle(A, B, X, Y, Z, W) _mm_shuffle_ps((A), (B), _MM_SHUFFLE(W, Z, Y, X))
+
+static mat4x4_simd
+LoadMat4(mat4x4 *M)
+{
+    float      *At     = &M->c0r0;
+    mat4x4_simd Result =
+    {
+        .Columns[0] = _mm_loadu_ps(At +  0),
+        .Columns[1] = _mm_loadu_ps(At +  4),
+        .Columns[2] = _mm_loadu_ps(At +  8),
+        .Columns[3] = _mm_loadu_ps(At + 12),
+    };
+
+    return Result;
+}
+
+static mat4x4
+StoreMat4(mat4x4_simd M)
+{
+    mat4x4 Result;
+    float *At = &Result.c0r0;
+
+    _mm_storeu_ps(At +  0, M.Columns[0]);
+    _mm_storeu_ps(At +  4, M.Columns[1]);
+    _mm_storeu_ps(At +  8, M.Columns[2]);
+    _mm_storeu_ps(At + 12, M.Columns[3]);
+
+    return Result;
+}
+
+// M * V, as a sum of the columns weighted by the components of V.
+static __m128
+LinearCombine(__m128 V, mat4x4_simd *M)
+{
+    __m128 Result = _mm_mul_ps(Mat4Swizzle(V, 0, 0, 0, 0), M->Columns[0]);
+    Result = _mm_add_ps(Result, _mm_mul_ps(Mat4Swizzle(V, 1, 1, 1, 1), M->Columns[1]));
+    Result = _mm_add_ps(Result, _mm_mul_ps(Mat4Swizzle(V, 2, 2, 2, 2), M->Columns[2]));
+    Result = _mm_add_ps(Result, _mm_mul_ps(Mat4Swizzle(V, 3, 3, 3, 3), M->Columns[3]));
+
+    return Result;
+}
+
+// Reads exactly three floats so the last element of an array can be loaded safely.
+static __m128
+LoadVec3(vec3 *V, float W)
+{
+    __m128 XY     = _mm_castpd_ps(_mm_load_sd((double *)V->AsBuffer));
+    __m128 ZW     = _mm_setr_ps(V->Z, W, 0.f, 0.f);
+    __m128 Result = _mm_movelh_ps(XY, ZW);
+
+    return Result;
+}
+
+static void
+StoreVec3(vec3 *V, __m128 Value)
+{
+    _mm_store_sd((double *)V->AsBuffer, _mm_castps_pd(Value));
+    _mm_store_ss(&V->Z, Mat4Swizzle(Value, 2, 2, 2, 2));
+}
+
+static __m128
+Cross3(__m128 A, __m128 B)
+{
+    __m128 Result = _mm_sub_ps(_mm_mul_ps(Mat4Swizzle(A, 1, 2, 0, 3), Mat4Swizzle(B, 2, 0, 1, 3)),
+                               _mm_mul_ps(Mat4Swizzle(A, 2, 0, 1, 3), Mat4Swizzle(B, 1, 2, 0, 3)));
+    return Result;
+}
+
+// Sum of the four lanes, broadcast to every lane.
+static __m128
+HorizontalSum(__m128 V)
+{
+    __m128 Result = _mm_add_ps(V, Mat4Swizzle(V, 2, 3, 0, 1));
+    Result = _mm_add_ps(Result, Mat4Swizzle(Result, 1, 0, 3, 2));
+
+    return Result;
+}
+
+// 2x2 helpers for the block inverse. A 2x2 matrix is packed as (m00, m01, m10, m11).
+
+static __m128
+Mat2Multiply(__m128 A, __m128 B)
+{
+    __m128 Result = _mm_add_ps(_mm_mul_ps(A, Mat4Swizzle(B, 0, 3, 0, 3)),
+                               _mm_mul_ps(Mat4Swizzle(A, 1, 0, 3, 2), Mat4Swizzle(B, 2, 1, 2, 1)));
+    return Result;
+}
+
+// Adjugate(A) * B
+static __m128
+Mat2AdjugateMultiply(__m128 A, __m128 B)
+{
+    __m128 Result = _mm_sub_ps(_mm_mul_ps(Mat4Swizzle(A, 3, 3, 0, 0), B),
+                               _mm_mul_ps(Mat4Swizzle(A, 1, 1, 2, 2), Mat4Swizzle(B, 2, 3, 0, 1)));
+    return Result;
+}
+
+// A * Adjugate(B)
+static __m128
+Mat2MultiplyAdjugate(__m128 A, __m128 B)
+{
+    __m128 Result = _mm_sub_ps(_mm_mul_ps(A, Mat4Swizzle(B, 3, 0, 3, 0)),
+                               _mm_mul_ps(Mat4Swizzle(A, 1, 0, 3, 2), Mat4Swizzle(B, 2, 1, 2, 1)));
+    return Result;
+}
+
+// ==============================================
+// <Builders>
+// ==============================================
+
+mat4x4 Mat4Identity(void)
+{
+    mat4x4 Result =
+    {
+        .c0r0 = 1.f,
+        .c1r1 = 1.f,
+        .c2r2 = 1.f,
+        .c3r3 = 1.f,
+    };
+
+    return Result;
+}
+
+mat4x4 Mat4Translation(vec3 Translation)
+{
+    mat4x4 Result = Mat4Identity();
+    Result.c3r0 = Translation.X;
+    Result.c3r1 = Translation.Y;
+    Result.c3r2 = Translation.Z;
+
+    return Result;
+}
+
+mat4x4 Mat4Scale(vec3 Scale)
+{
+    mat4x4 Result = {0};
+    Result.c0r0 = Scale.X;
+    Result.c1r1 = Scale.Y;
+    Result.c2r2 = Scale.Z;
+    Result.c3r3 = 1.f;
+
+    return Result;
+}
+
+// Rows of the rotation are the camera basis, so the result takes world space
+// points to view space.
+mat4x4 Mat4LookTo(vec3 Eye, vec3 Forward, vec3 Up)
+{
+    vec3 F = Vec3Normalize(Forward);
+    vec3 R = Vec3Normalize(Vec3Cross(Up, F));
+    vec3 U = Vec3Cross(F, R);
+
+    mat4x4 Result =
+    {
+        .c0r0 = R.X, .c0r1 = U.X, .c0r2 = F.X, .c0r3 = 0.f,
+        .c1r0 = R.Y, .c1r1 = U.Y, .c1r2 = F.Y, .c1r3 = 0.f,
+        .c2r0 = R.Z, .c2r1 = U.Z, .c2r2 = F.Z, .c2r3 = 0.f,
+
+        .c3r0 = -Vec3Dot(R, Eye),
+        .c3r1 = -Vec3Dot(U, Eye),
+        .c3r2 = -Vec3Dot(F, Eye),
+        .c3r3 = 1.f,
+    };
+
+    return Result;
+}
+
+mat4x4 Mat4LookAt(vec3 Eye, vec3 Target, vec3 Up)
+{
+    mat4x4 Result = Mat4LookTo(Eye, Vec3Subtract(Target, Eye), Up);
+    return Result;
+}
+
+mat4x4 Mat4Perspective(float FovYRadians, float AspectRatio, float NearPlane, float FarPlane)
+{
+    float F = 1.f / tanf(FovYRadians * 0.5f);
+
+    mat4x4 Result = {0};
+    Result.c0r0 = F / AspectRatio;
+    Result.c1r1 = F;
+    Result.c2r2 = (FarPlane + NearPlane) / (FarPlane - NearPlane);
+    Result.c2r3 = 1.f;
+    Result.c3r2 = (-2.f * FarPlane * NearPlane) / (FarPlane - NearPlane);
+
+    return Result;
+}
+
+// ==============================================
+// <Operations>
+// ==============================================
+
+mat4x4 Mat4Multiply(mat4x4 A, mat4x4 B)
+{
+    mat4x4_simd SA = LoadMat4(&A);
+    mat4x4_simd SB = LoadMat4(&B);
+    mat4x4_simd Result;
+
+    Result.Columns[0] = LinearCombine(SB.Columns[0], &SA);
+    Result.Columns[1] = LinearCombine(SB.Columns[1], &SA);
+    Result.Columns[2] = LinearCombine(SB.Columns[2], &SA);
+    Result.Columns[3] = LinearCombine(SB.Columns[3], &SA);
+
+    return StoreMat4(Result);
+}
+
+mat4x4 Mat4Transpose(mat4x4 M)
+{
+    mat4x4_simd Result = LoadMat4(&M);
+    _MM_TRANSPOSE4_PS(Result.Columns[0], Result.Columns[1], Result.Columns[2], Result.Columns[3]);
+
+    return StoreMat4(Result);
+}
+
+// Block inverse over the four 2x2 sub-matrices
+//
+//   M = | A B |    inverse(M) = 1/|M| * | X Y |
+//       | C D |                         | Z W |
+//
+// using adjugates instead of 2x2 inverses. The algebra is written for rows, which
+// is fine: loading columns as rows inverts the transpose, and storing those rows
+// back as columns transposes the result again.
+mat4x4 Mat4Inverse(mat4x4 M)
+{
+    mat4x4_simd S = LoadMat4(&M);
+
+    __m128 A = _mm_movelh_ps(S.Columns[0], S.Columns[1]);
+    __m128 B = _mm_movehl_ps(S.Columns[1], S.Columns[0]);
+    __m128 C = _mm_movelh_ps(S.Columns[2], S.Columns[3]);
+    __m128 D = _mm_movehl_ps(S.Columns[3], S.Columns[2]);
+
+    // (|A|, |B|, |C|, |D|)
+    __m128 SubDeterminants = _mm_sub_ps(_mm_mul_ps(Mat4Shuffle(S.Columns[0], S.Columns[2], 0, 2, 0, 2), Mat4Shuffle(S.Columns[1], S.Columns[3], 1, 3, 1, 3)),
+                                        _mm_mul_ps(Mat4Shuffle(S.Columns[0], S.Columns[2], 1, 3, 1, 3), Mat4Shuffle(S.Columns[1], S.Columns[3], 0, 2, 0, 2)));
+
+    __m128 DetA = Mat4Swizzle(SubDeterminants, 0, 0, 0, 0);
+    __m128 DetB = Mat4Swizzle(SubDeterminants, 1, 1, 1, 1);
+    __m128 DetC = Mat4Swizzle(SubDeterminants, 2, 2, 2, 2);
+    __m128 DetD = Mat4Swizzle(SubDeterminants, 3, 3, 3, 3);
+
+    __m128 DC = Mat2AdjugateMultiply(D, C);
+    __m128 AB = Mat2AdjugateMultiply(A, B);
+
+    __m128 X = _mm_sub_ps(_mm_mul_ps(DetD, A), Mat2Multiply(B, DC));
+    __m128 W = _mm_sub_ps(_mm_mul_ps(DetA, D), Mat2Multiply(C, AB));
+    __m128 Y = _mm_sub_ps(_mm_mul_ps(DetB, C), Mat2MultiplyAdjugate(D, AB));
+    __m128 Z = _mm_sub_ps(_mm_mul_ps(DetC, B), Mat2MultiplyAdjugate(A, DC));
+
+    // |M| = |A||D| + |B||C| - tr((A#B)(D#C))
+    __m128 Trace = HorizontalSum(_mm_mul_ps(AB, Mat4Swizzle(DC, 0, 2, 1, 3)));
+    __m128 Det   = _mm_sub_ps(_mm_add_ps(_mm_mul_ps(DetA, DetD), _mm_mul_ps(DetB, DetC)), Trace);
+
+    if (_mm_cvtss_f32(Det) == 0.f)
+    {
+        mat4x4 Zero = {0};
+        return Zero;
+    }
+
+    __m128 InvDet = _mm_div_ps(_mm_setr_ps(1.f, -1.f, -1.f, 1.f), Det);
+
+    X = _mm_mul_ps(X, InvDet);
+    Y = _mm_mul_ps(Y, InvDet);
+    Z = _mm_mul_ps(Z, InvDet);
+    W = _mm_mul_ps(W, InvDet);
+
+    mat4x4_simd Result;
+    Result.Columns[0] = Mat4Shuffle(X, Y, 3, 1, 3, 1);
+    Result.Columns[1] = Mat4Shuffle(X, Y, 2, 0, 2, 0);
+    Result.Columns[2] = Mat4Shuffle(Z, W, 3, 1, 3, 1);
+    Result.Columns[3] = Mat4Shuffle(Z, W, 2, 0, 2, 0);
+
+    return StoreMat4(Result);
+}
+
+// With L the upper 3x3 and T the translation, inverse(M) = | inverse(L)  -inverse(L)T |.
+// The rows of inverse(L) are the cross products of L's columns over |L|.
+mat4x4 Mat4InverseAffine(mat4x4 M)
+{
+    mat4x4_simd S    = LoadMat4(&M);
+    __m128      Mask = _mm_castsi128_ps(_mm_setr_epi32(-1, -1, -1, 0));
+
+    __m128 C0 = _mm_and_ps(S.Columns[0], Mask);
+    __m128 C1 = _mm_and_ps(S.Columns[1], Mask);
+    __m128 C2 = _mm_and_ps(S.Columns[2], Mask);
+
+    __m128 Row0 = Cross3(C1, C2);
+    __m128 Row1 = Cross3(C2, C0);
+    __m128 Row2 = Cross3(C0, C1);
+    __m128 Det  = HorizontalSum(_mm_mul_ps(C0, Row0));
+
+    if (_mm_cvtss_f32(Det) == 0.f)
+    {
+        mat4x4 Zero = {0};
+        return Zero;
+    }
+
+    __m128 InvDet = _mm_div_ps(_mm_set1_ps(1.f), Det);
+
+    mat4x4_simd Result;
+    Result.Columns[0] = _mm_mul_ps(Row0, InvDet);
+    Result.Columns[1] = _mm_mul_ps(Row1, InvDet);
+    Result.Columns[2] = _mm_mul_ps(Row2, InvDet);
+    Result.Columns[3] = _mm_setzero_ps();
+
+    _MM_TRANSPOSE4_PS(Result.Columns[0], Result.Columns[1], Result.Columns[2], Result.Columns[3]);
+
+    __m128 Translation = _mm_and_ps(S.Columns[3], Mask);
+    Result.Columns[3]  = _mm_sub_ps(_mm_setr_ps(0.f, 0.f, 0.f, 1.f), LinearCombine(Translation, &Result));
+
+    return StoreMat4(Result);
+}
+
+// ==============================================
+// <Transforms>
+// ==============================================
+
+vec3 Mat4TransformPoint(mat4x4 M, vec3 Point)
+{
+    mat4x4_simd S = LoadMat4(&M);
+
+    vec3 Result;
+    StoreVec3(&Result, LinearCombine(LoadVec3(&Point, 1.f), &S));
+
+    return Result;
+}
+
+vec3 Mat4TransformVector(mat4x4 M, vec3 Vector)
+{
+    mat4x4_simd S = LoadMat4(&M);
+
+    vec3 Result;
+    StoreVec3(&Result, LinearCombine(LoadVec3(&Vector, 0.f), &S));
+
+    return Result;
+}
+
+// Each element is read completely before it is written, which keeps in-place
+// transforms correct.
+static void
+TransformVec3Array(mat4x4 *M, vec3 *Input, vec3 *Output, uint64_t Count, float W)
+{
+    mat4x4_simd S = LoadMat4(M);
+    S.Columns[3]  = _mm_mul_ps(S.Columns[3], _mm_set1_ps(W));
+
+    for (uint64_t Idx = 0; Idx < Count; ++Idx)
+    {
+        __m128 V      = LoadVec3(Input + Idx, 0.f);
+        __m128 Result = _mm_add_ps(S.Columns[3], _mm_mul_ps(Mat4Swizzle(V, 0, 0, 0, 0), S.Columns[0]));
+        Result        = _mm_add_ps(Result,       _mm_mul_ps(Mat4Swizzle(V, 1, 1, 1, 1), S.Columns[1]));
+        Result        = _mm_add_ps(Result,       _mm_mul_ps(Mat4Swizzle(V, 2, 2, 2, 2), S.Columns[2]));
+
+        StoreVec3(Output + Idx, Result);
+    }
+}
+
+void Mat4TransformPoints(mat4x4 *M, vec3 *Input, vec3 *Output, uint64_t Count)
+{
+    TransformVec3Array(M, Input, Output, Count, 1.f);
+}
+
+void Mat4TransformVectors(mat4x4 *M, vec3 *Input, vec3 *Output, uint64_t Count)
+{
+    TransformVec3Array(M, Input, Output, Count, 0.f);
+}
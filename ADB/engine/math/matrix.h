@@ -1,9 +1,45 @@
 #pragma once
 
+#include <stdint.h>
+
+#include "vector.h"
+
+// Column-major: c<column>r<row>, the layout HLSL reads by default. Matrices act on
+// column vectors (M * v), so in Mat4Multiply(A, B) B is applied first.
+
 typedef struct
 {
 	float c0r0, c0r1, c0r2, c0r3;
 	float c1r0, c1r1, c1r2, c1r3;
 	float c2r0, c2r1, c2r2, c2r3;
 	float c3r0, c3r1, c3r2, c3r3;
-} mat4x4;
\ No newline at end of file
+} mat4x4;
+
+mat4x4 Mat4Identity         (void);
+mat4x4 Mat4Translation      (vec3 Translation);
+mat4x4 Mat4Scale            (vec3 Scale);
+
+mat4x4 Mat4Multiply         (mat4x4 A, mat4x4 B);
+mat4x4 Mat4Transpose        (mat4x4 M);
+
+// Inverse returns a zero matrix when M is singular. InverseAffine expects the last
+// row to be (0, 0, 0, 1) and handles rotation, translation and any non-degenerate
+// scale or shear, at about half the cost.
+
+mat4x4 Mat4Inverse          (mat4x4 M);
+mat4x4 Mat4InverseAffine    (mat4x4 M);
+
+// Left-handed view space looking down +Z. Perspective maps depth to [-1, 1] and
+// stores view depth in w.
+
+mat4x4 Mat4LookAt           (vec3 Eye, vec3 Target, vec3 Up);
+mat4x4 Mat4LookTo           (vec3 Eye, vec3 Forward, vec3 Up);
+mat4x4 Mat4Perspective      (float FovYRadians, float AspectRatio, float NearPlane, float FarPlane);
+
+// Points are transformed with w = 1, vectors with w = 0. The result is not divided
+// by w. Output may alias Input.
+
+vec3   Mat4TransformPoint   (mat4x4 M, vec3 Point);
+vec3   Mat4TransformVector  (mat4x4 M, vec3 Vector);
+void   Mat4TransformPoints  (mat4x4 *M, vec3 *Input, vec3 *Output, uint64_t Count);
+void   Mat4TransformVectors (mat4x4 *M, vec3 *Input, vec3 *Output, uint64_t Count);
@@ -86,4 +86,37 @@ vec3 Vec3Cross(vec3 A, vec3 B)
         .Z = A.X * B.Y - A.Y * B.X,
     };
     return Result;
-}
\ No newline at end of file
+}
+
+
+quat QuatIdentity(void)
+{
+    quat Result = { .X = 0.f, .Y = 0.f, .Z = 0.f, .W = 1.f };
+    return Result;
+}
+
+quat QuatFromAxisAngle(vec3 Axis, float Radians)
+{
+    vec3  Unit = Vec3Normalize(Axis);
+    float Sin  = sinf(0.5f * Radians);
+
+    quat Result = {
+        .X = Unit.X * Sin,
+        .Y = Unit.Y * Sin,
+        .Z = Unit.Z * Sin,
+        .W = cosf(0.5f * Radians),
+    };
+    return Result;
+}
+
+// Rotation by B, then by A.
+quat QuatMultiply(quat A, quat B)
+{
+    quat Result = {
+        .X = A.W * B.X + A.X * B.W + A.Y * B.Z - A.Z * B.Y,
+        .Y = A.W * B.Y - A.X * B.Z + A.Y * B.W + A.Z * B.X,
+        .Z = A.W * B.Z + A.X * B.Y - A.Y * B.X + A.Z * B.W,
+        .W = A.W * B.W - A.X * B.X - A.Y * B.Y - A.Z * B.Z,
+    };
+    return Result;
+}
@@ -24,6 +24,26 @@ typedef struct
     };
 } vec3;
 
+// Unit quaternion, W is the scalar part.
+typedef struct
+{
+    union
+    {
+        struct
+        {
+            float X, Y, Z, W;
+        };
+        float AsBuffer[4];
+    };
+} quat;
+
+// Points P with Dot(Normal, P) + Offset >= 0 are on the positive side.
+typedef struct
+{
+    vec3  Normal;
+    float Offset;
+} plane;
+
 vec2 Vec2  (float X, float Y);
 vec3 Vec3  (float X, float Y, float Z);
 
@@ -33,4 +53,8 @@ vec3  Vec3Scale      (vec3 V, float Scale);
 float Vec3Dot        (vec3 A, vec3 B);
 float Vec3Length     (vec3 V);
 vec3  Vec3Normalize  (vec3 V);
-vec3  Vec3Cross      (vec3 A, vec3 B);
\ No newline at end of file
+vec3  Vec3Cross      (vec3 A, vec3 B);
+
+quat  QuatIdentity      (void);
+quat  QuatFromAxisAngle (vec3 Axis, float Radians);
+quat  QuatMultiply      (quat A, quat B);
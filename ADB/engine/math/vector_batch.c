@@ -0,0 +1,372 @@
+#include <stdint.h>
+#include <stdbool.h>
+#include <math.h>
+#include <assert.h>
+
+#if defined(_MSC_VER)
+#include <intrin.h>
+#endif
+#include <immintrin.h>
+
+#include "utilities.h"
+#include "vector_batch.h"
+
+// =====================================================
+// [SECTION] Kernel Instantiation
+// [DESCRIP]
+//   MSVC accepts every intrinsic regardless of /arch, so
+//   the wider sets only need a target attribute on GCC
+//   and Clang. Nothing outside this file may call the
+//   wide kernels before checking the CPU.
+// =====================================================
+
+#if defined(_MSC_VER)
+#define BatchTarget(Features)
+#else
+#define BatchTarget(Features) __attribute__((target(Features)))
+#endif
+
+
+#define BATCH_ISA                   SSE2
+#define BATCH_TARGET
+#define BATCH_WIDTH                 4
+#define batch_lane                  __m128
+#define BatchLoad(At)               _mm_loadu_ps(At)
+#define BatchStore(At, V)           _mm_storeu_ps(At, V)
+#define BatchSet1(V)                _mm_set1_ps(V)
+#define BatchAdd(A, B)              _mm_add_ps(A, B)
+#define BatchSub(A, B)              _mm_sub_ps(A, B)
+#define BatchMul(A, B)              _mm_mul_ps(A, B)
+#define BatchMulAdd(A, B, C)        _mm_add_ps(_mm_mul_ps(A, B), C)
+#define BatchDiv(A, B)              _mm_div_ps(A, B)
+#define BatchSqrt(A)                _mm_sqrt_ps(A)
+#define BatchSelectPositive(T, P, O) _mm_or_ps(_mm_and_ps(_mm_cmpgt_ps(T, _mm_setzero_ps()), P), _mm_andnot_ps(_mm_cmpgt_ps(T, _mm_setzero_ps()), O))
+#define BatchMin(A, B)              _mm_min_ps(A, B)
+#define BatchNonNegativeMask(V)     (uint32_t)_mm_movemask_ps(_mm_cmpge_ps(V, _mm_setzero_ps()))
+
+#include "vector_batch_kernels.h"
+
+#undef BATCH_ISA
+#undef BATCH_TARGET
+#undef BATCH_WIDTH
+#undef batch_lane
+#undef BatchLoad
+#undef BatchStore
+#undef BatchSet1
+#undef BatchAdd
+#undef BatchSub
+#undef BatchMul
+#undef BatchMulAdd
+#undef BatchDiv
+#undef BatchSqrt
+#undef BatchSelectPositive
+#undef BatchMin
+#undef BatchNonNegativeMask
+
+
+#define BATCH_ISA                   AVX2
+#define BATCH_TARGET                BatchTarget("avx2,fma")
+#define BATCH_WIDTH                 8
+#define batch_lane                  __m256
+#define BatchLoad(At)               _mm256_loadu_ps(At)
+#define BatchStore(At, V)           _mm256_storeu_ps(At, V)
+#define BatchSet1(V)                _mm256_set1_ps(V)
+#define BatchAdd(A, B)              _mm256_add_ps(A, B)
+#define BatchSub(A, B)              _mm256_sub_ps(A, B)
+#define BatchMul(A, B)              _mm256_mul_ps(A, B)
+#define BatchMulAdd(A, B, C)        _mm256_fmadd_ps(A, B, C)
+#define BatchDiv(A, B)              _mm256_div_ps(A, B)
+#define BatchSqrt(A)                _mm256_sqrt_ps(A)
+#define BatchSelectPositive(T, P, O) _mm256_blendv_ps(O, P, _mm256_cmp_ps(T, _mm256_setzero_ps(), _CMP_GT_OQ))
+#define BatchMin(A, B)              _mm256_min_ps(A, B)
+#define BatchNonNegativeMask(V)     (uint32_t)_mm256_movemask_ps(_mm256_cmp_ps(V, _mm256_setzero_ps(), _CMP_GE_OQ))
+
+#include "vector_batch_kernels.h"
+
+#undef BATCH_ISA
+#undef BATCH_TARGET
+#undef BATCH_WIDTH
+#undef batch_lane
+#undef BatchLoad
+#undef BatchStore
+#undef BatchSet1
+#undef BatchAdd
+#undef BatchSub
+#undef BatchMul
+#undef BatchMulAdd
+#undef BatchDiv
+#undef BatchSqrt
+#undef BatchSelectPositive
+#undef BatchMin
+#undef BatchNonNegativeMask
+
+
+#define BATCH_ISA                   AVX512
+#define BATCH_TARGET                BatchTarget("avx512f")
+#define BATCH_WIDTH                 16
+#define batch_lane                  __m512
+#define BatchLoad(At)               _mm512_loadu_ps(At)
+#define BatchStore(At, V)           _mm512_storeu_ps(At, V)
+#define BatchSet1(V)                _mm512_set1_ps(V)
+#define BatchAdd(A, B)              _mm512_add_ps(A, B)
+#define BatchSub(A, B)              _mm512_sub_ps(A, B)
+#define BatchMul(A, B)              _mm512_mul_ps(A, B)
+#define BatchMulAdd(A, B, C)        _mm512_fmadd_ps(A, B, C)
+#define BatchDiv(A, B)              _mm512_div_ps(A, B)
+#define BatchSqrt(A)                _mm512_sqrt_ps(A)
+#define BatchSelectPositive(T, P, O) _mm512_mask_blend_ps(_mm512_cmp_ps_mask(T, _mm512_setzero_ps(), _CMP_GT_OQ), O, P)
+#define BatchMin(A, B)              _mm512_min_ps(A, B)
+#define BatchNonNegativeMask(V)     (uint32_t)_mm512_cmp_ps_mask(V, _mm512_setzero_ps(), _CMP_GE_OQ)
+
+#include "vector_batch_kernels.h"
+
+#undef BATCH_ISA
+#undef BATCH_TARGET
+#undef BATCH_WIDTH
+#undef batch_lane
+#undef BatchLoad
+#undef BatchStore
+#undef BatchSet1
+#undef BatchAdd
+#undef BatchSub
+#undef BatchMul
+#undef BatchMulAdd
+#undef BatchDiv
+#undef BatchSqrt
+#undef BatchSelectPositive
+#undef BatchMin
+#undef BatchNonNegativeMask
+
+// =====================================================
+// [SECTION] Dispatch
+// =====================================================
+
+typedef void vec3_batch_binary    (vec3_soa A, vec3_soa B, vec3_soa Out, uint64_t Count);
+typedef void vec3_batch_offset    (vec3_soa A, vec3 Offset, vec3_soa Out, uint64_t Count);
+typedef void vec3_batch_scale     (vec3_soa A, float Scale, vec3_soa Out, uint64_t Count);
+typedef void vec3_batch_dot       (vec3_soa A, vec3_soa B, float *Out, uint64_t Count);
+typedef void vec3_batch_unary     (vec3_soa A, vec3_soa Out, uint64_t Count);
+typedef void vec3_batch_transform (mat4x4 *M, vec3_soa A, vec3_soa Out, uint64_t Count);
+typedef uint64_t vec3_batch_cull  (vec3_soa Centers, vec3_soa Extents, plane *Planes, uint32_t PlaneCount, uint32_t *Visible, uint64_t Count);
+
+typedef struct
+{
+    vec3_batch_binary    *Add;
+    vec3_batch_offset    *Offset;
+    vec3_batch_scale     *Scale;
+    vec3_batch_dot       *Dot;
+    vec3_batch_binary    *Cross;
+    vec3_batch_unary     *Normalize;
+    vec3_batch_transform *Transform;
+    vec3_batch_cull      *CullBoxes;
+} vec3_batch_kernels;
+
+#define Vec3BatchKernelTable(ISA)                                                   \
+    {                                                                               \
+        Vec3BatchAdd_##ISA, Vec3BatchOffset_##ISA, Vec3BatchScale_##ISA,            \
+        Vec3BatchDot_##ISA, Vec3BatchCross_##ISA, Vec3BatchNormalize_##ISA,         \
+        Vec3BatchTransform_##ISA, Vec3BatchCullBoxes_##ISA,                         \
+    }
+
+static vec3_batch_kernels Vec3BatchKernels[] =
+{
+    [VectorISA_SSE2]   = Vec3BatchKernelTable(SSE2),
+    [VectorISA_AVX2]   = Vec3BatchKernelTable(AVX2),
+    [VectorISA_AVX512] = Vec3BatchKernelTable(AVX512),
+};
+
+static VectorISA_Type      SupportedISA;
+static vec3_batch_kernels *ActiveKernels;
+
+
+// Both the CPU flags and the OS (XCR0) must agree: an OS that does not save the
+// wider registers on context switches makes the instructions unusable.
+static VectorISA_Type
+DetectVectorISA(void)
+{
+#if defined(_MSC_VER)
+    int Info[4];
+
+    __cpuid(Info, 0);
+    int MaxLeaf = Info[0];
+
+    __cpuid(Info, 1);
+    bool HasOSXSave = (Info[2] & (1 << 27)) != 0;
+    bool HasAVX     = (Info[2] & (1 << 28)) != 0;
+    bool HasFMA     = (Info[2] & (1 << 12)) != 0;
+
+    if (MaxLeaf < 7 || !HasOSXSave || !HasAVX)
+    {
+        return VectorISA_SSE2;
+    }
+
+    uint64_t EnabledState = _xgetbv(0);
+    if ((EnabledState & 0x6) != 0x6)
+    {
+        return VectorISA_SSE2;
+    }
+
+    __cpuidex(Info, 7, 0);
+    bool HasAVX2    = (Info[1] & (1 << 5))  != 0;
+    bool HasAVX512F = (Info[1] & (1 << 16)) != 0;
+
+    if (HasAVX512F && (EnabledState & 0xE6) == 0xE6)
+    {
+        return VectorISA_AVX512;
+    }
+
+    if (HasAVX2 && HasFMA)
+    {
+        return VectorISA_AVX2;
+    }
+
+    return VectorISA_SSE2;
+#else
+    __builtin_cpu_init();
+
+    if (__builtin_cpu_supports("avx512f"))
+    {
+        return VectorISA_AVX512;
+    }
+
+    if (__builtin_cpu_supports("avx2") && __builtin_cpu_supports("fma"))
+    {
+        return VectorISA_AVX2;
+    }
+
+    return VectorISA_SSE2;
+#endif
+}
+
+
+// Racing first calls compute the same answer, so no synchronization is needed.
+static vec3_batch_kernels *
+GetVec3BatchKernels(void)
+{
+    if (!ActiveKernels)
+    {
+        SupportedISA  = DetectVectorISA();
+        ActiveKernels = Vec3BatchKernels + SupportedISA;
+    }
+
+    return ActiveKernels;
+}
+
+
+VectorISA_Type
+GetVectorBatchISA(void)
+{
+    VectorISA_Type Result = (VectorISA_Type)(GetVec3BatchKernels() - Vec3BatchKernels);
+    return Result;
+}
+
+
+VectorISA_Type
+SetVectorBatchISA(VectorISA_Type ISA)
+{
+    GetVec3BatchKernels();
+
+    VectorISA_Type Result = Minimum(ISA, SupportedISA);
+    ActiveKernels = Vec3BatchKernels + Result;
+
+    return Result;
+}
+
+// =====================================================
+// [SECTION] Public API
+// =====================================================
+
+vec3_soa
+PushVec3SoA(memory_arena *Arena, uint64_t Count)
+{
+    uint64_t Padded = AlignPow2(Count, 16);
+
+    vec3_soa Result =
+    {
+        .X = PushArrayAligned(Arena, float, Padded, 64),
+        .Y = PushArrayAligned(Arena, float, Padded, 64),
+        .Z = PushArrayAligned(Arena, float, Padded, 64),
+    };
+
+    return Result;
+}
+
+
+// Strided conversions stay scalar: they are bound by the interleaved side, and
+// hardware gathers/scatters are not faster for three floats per element.
+
+void
+Vec3GatherSoA(void *Source, uint64_t Stride, vec3_soa Out, uint64_t Count)
+{
+    uint8_t *At = (uint8_t *)Source;
+
+    for (uint64_t Idx = 0; Idx < Count; ++Idx, At += Stride)
+    {
+        vec3 *V = (vec3 *)At;
+        Out.X[Idx] = V->X;
+        Out.Y[Idx] = V->Y;
+        Out.Z[Idx] = V->Z;
+    }
+}
+
+
+void
+Vec3ScatterSoA(vec3_soa In, void *Dest, uint64_t Stride, uint64_t Count)
+{
+    uint8_t *At = (uint8_t *)Dest;
+
+    for (uint64_t Idx = 0; Idx < Count; ++Idx, At += Stride)
+    {
+        vec3 *V = (vec3 *)At;
+        V->X = In.X[Idx];
+        V->Y = In.Y[Idx];
+        V->Z = In.Z[Idx];
+    }
+}
+
+
+void Vec3BatchAdd(vec3_soa A, vec3_soa B, vec3_soa Out, uint64_t Count)
+{
+    GetVec3BatchKernels()->Add(A, B, Out, Count);
+}
+
+void Vec3BatchOffset(vec3_soa A, vec3 Offset, vec3_soa Out, uint64_t Count)
+{
+    GetVec3BatchKernels()->Offset(A, Offset, Out, Count);
+}
+
+void Vec3BatchScale(vec3_soa A, float Scale, vec3_soa Out, uint64_t Count)
+{
+    GetVec3BatchKernels()->Scale(A, Scale, Out, Count);
+}
+
+void Vec3BatchDot(vec3_soa A, vec3_soa B, float *Out, uint64_t Count)
+{
+    GetVec3BatchKernels()->Dot(A, B, Out, Count);
+}
+
+void Vec3BatchCross(vec3_soa A, vec3_soa B, vec3_soa Out, uint64_t Count)
+{
+    GetVec3BatchKernels()->Cross(A, B, Out, Count);
+}
+
+void Vec3BatchNormalize(vec3_soa A, vec3_soa Out, uint64_t Count)
+{
+    GetVec3BatchKernels()->Normalize(A, Out, Count);
+}
+
+void Vec3BatchTransform(mat4x4 *M, vec3_soa A, vec3_soa Out, uint64_t Count)
+{
+    GetVec3BatchKernels()->Transform(M, A, Out, Count);
+}
+
+
+uint64_t
+Vec3BatchCullBoxes(vec3_soa Centers, vec3_soa Extents, plane *Planes, uint32_t PlaneCount, uint32_t *Visible, uint64_t Count)
+{
+    assert(PlaneCount <= VEC3_BATCH_MAX_PLANES);
+    assert(Count <= UINT32_MAX);
+
+    uint64_t Result = GetVec3BatchKernels()->CullBoxes(Centers, Extents, Planes, PlaneCount, Visible, Count);
+    return Result;
+}
@@ -0,0 +1,78 @@
+#pragma once
+
+#include <stdint.h>
+
+#include "vector.h"
+#include "matrix.h"
+
+typedef struct memory_arena memory_arena;
+
+// =====================================================
+// [SECTION] Structure Of Arrays
+// [DESCRIP]
+//   Batch kernels work on separate X/Y/Z arrays so every
+//   register holds the same component of 4, 8 or 16
+//   points. Arrays from PushVec3SoA are 64-byte aligned
+//   and padded to a multiple of 16 elements, but kernels
+//   accept any pointers and any count.
+//
+//   Outputs may alias inputs element for element (A and
+//   Out being the same arrays), not with an offset.
+// =====================================================
+
+typedef struct vec3_soa
+{
+    float *X;
+    float *Y;
+    float *Z;
+} vec3_soa;
+
+vec3_soa PushVec3SoA            (memory_arena *Arena, uint64_t Count);
+
+// Conversion from/to interleaved vertex formats. 'Source' points at the vec3 member
+// of the first vertex and 'Stride' is the vertex size, e.g.
+// Vec3ScatterSoA(Positions, &Vertices[0].Position, sizeof(tile_vertex_data), Count).
+
+void     Vec3GatherSoA          (void *Source, uint64_t Stride, vec3_soa Out, uint64_t Count);
+void     Vec3ScatterSoA         (vec3_soa In, void *Dest, uint64_t Stride, uint64_t Count);
+
+void     Vec3BatchAdd           (vec3_soa A, vec3_soa B, vec3_soa Out, uint64_t Count);
+void     Vec3BatchOffset        (vec3_soa A, vec3 Offset, vec3_soa Out, uint64_t Count);
+void     Vec3BatchScale         (vec3_soa A, float Scale, vec3_soa Out, uint64_t Count);
+void     Vec3BatchDot           (vec3_soa A, vec3_soa B, float *Out, uint64_t Count);
+void     Vec3BatchCross         (vec3_soa A, vec3_soa B, vec3_soa Out, uint64_t Count);
+void     Vec3BatchNormalize     (vec3_soa A, vec3_soa Out, uint64_t Count);
+void     Vec3BatchTransform     (mat4x4 *M, vec3_soa A, vec3_soa Out, uint64_t Count);
+
+// =====================================================
+// [SECTION] Box Culling
+// [DESCRIP]
+//   Axis-aligned boxes given as centers and half extents
+//   are tested against up to VEC3_BATCH_MAX_PLANES planes
+//   (normals pointing inside). Indices of the boxes kept
+//   are written in increasing order to 'Visible', which
+//   must hold 'Count' entries, and their count returned.
+// =====================================================
+
+#define VEC3_BATCH_MAX_PLANES 8
+
+uint64_t Vec3BatchCullBoxes     (vec3_soa Centers, vec3_soa Extents, plane *Planes, uint32_t PlaneCount, uint32_t *Visible, uint64_t Count);
+
+// =====================================================
+// [SECTION] Dispatch
+// [DESCRIP]
+//   The widest instruction set supported by both the CPU
+//   and the OS is picked on first use. Forcing a narrower
+//   one is meant for comparisons; requests for an
+//   unsupported set fall back to the best available.
+// =====================================================
+
+typedef enum VectorISA_Type
+{
+    VectorISA_SSE2   = 0,
+    VectorISA_AVX2   = 1,
+    VectorISA_AVX512 = 2,
+} VectorISA_Type;
+
+VectorISA_Type GetVectorBatchISA (void);
+VectorISA_Type SetVectorBatchISA (VectorISA_Type ISA);
@@ -0,0 +1,292 @@
+// Kernel bodies shared by every instruction set. Only vector_batch.c includes this
+// file, once per set, after defining:
+//
+//   BATCH_ISA            suffix of the generated functions (SSE2, AVX2...)
+//   BATCH_TARGET         function attribute enabling the set (empty on MSVC)
+//   BATCH_WIDTH          floats per register
+//   batch_lane           register type
+//   BatchLoad/BatchStore unaligned load and store
+//   BatchSet1, BatchAdd, BatchSub, BatchMul, BatchMulAdd (A * B + C),
+//   BatchSqrt, BatchDiv
+//   BatchSelectPositive(Test, IfPositive, Otherwise), per lane on Test > 0
+//   BatchMin
+//   BatchNonNegativeMask(V), one bit per lane with V >= 0, lane 0 in bit 0
+//
+// Tails shorter than a register run the scalar version of the same math.
+
+#define BatchKernelName(Name, ISA)   Vec3Batch##Name##_##ISA
+#define BatchKernelExpand(Name, ISA) BatchKernelName(Name, ISA)
+#define BatchKernel(Name)            BatchKernelExpand(Name, BATCH_ISA)
+
+
+BATCH_TARGET static void
+BatchKernel(Add)(vec3_soa A, vec3_soa B, vec3_soa Out, uint64_t Count)
+{
+    uint64_t Idx = 0;
+
+    for (; Idx + BATCH_WIDTH <= Count; Idx += BATCH_WIDTH)
+    {
+        BatchStore(Out.X + Idx, BatchAdd(BatchLoad(A.X + Idx), BatchLoad(B.X + Idx)));
+        BatchStore(Out.Y + Idx, BatchAdd(BatchLoad(A.Y + Idx), BatchLoad(B.Y + Idx)));
+        BatchStore(Out.Z + Idx, BatchAdd(BatchLoad(A.Z + Idx), BatchLoad(B.Z + Idx)));
+    }
+
+    for (; Idx < Count; ++Idx)
+    {
+        Out.X[Idx] = A.X[Idx] + B.X[Idx];
+        Out.Y[Idx] = A.Y[Idx] + B.Y[Idx];
+        Out.Z[Idx] = A.Z[Idx] + B.Z[Idx];
+    }
+}
+
+
+BATCH_TARGET static void
+BatchKernel(Offset)(vec3_soa A, vec3 Offset, vec3_soa Out, uint64_t Count)
+{
+    batch_lane OffsetX = BatchSet1(Offset.X);
+    batch_lane OffsetY = BatchSet1(Offset.Y);
+    batch_lane OffsetZ = BatchSet1(Offset.Z);
+
+    uint64_t Idx = 0;
+
+    for (; Idx + BATCH_WIDTH <= Count; Idx += BATCH_WIDTH)
+    {
+        BatchStore(Out.X + Idx, BatchAdd(BatchLoad(A.X + Idx), OffsetX));
+        BatchStore(Out.Y + Idx, BatchAdd(BatchLoad(A.Y + Idx), OffsetY));
+        BatchStore(Out.Z + Idx, BatchAdd(BatchLoad(A.Z + Idx), OffsetZ));
+    }
+
+    for (; Idx < Count; ++Idx)
+    {
+        Out.X[Idx] = A.X[Idx] + Offset.X;
+        Out.Y[Idx] = A.Y[Idx] + Offset.Y;
+        Out.Z[Idx] = A.Z[Idx] + Offset.Z;
+    }
+}
+
+
+BATCH_TARGET static void
+BatchKernel(Scale)(vec3_soa A, float Scale, vec3_soa Out, uint64_t Count)
+{
+    batch_lane Factor = BatchSet1(Scale);
+
+    uint64_t Idx = 0;
+
+    for (; Idx + BATCH_WIDTH <= Count; Idx += BATCH_WIDTH)
+    {
+        BatchStore(Out.X + Idx, BatchMul(BatchLoad(A.X + Idx), Factor));
+        BatchStore(Out.Y + Idx, BatchMul(BatchLoad(A.Y + Idx), Factor));
+        BatchStore(Out.Z + Idx, BatchMul(BatchLoad(A.Z + Idx), Factor));
+    }
+
+    for (; Idx < Count; ++Idx)
+    {
+        Out.X[Idx] = A.X[Idx] * Scale;
+        Out.Y[Idx] = A.Y[Idx] * Scale;
+        Out.Z[Idx] = A.Z[Idx] * Scale;
+    }
+}
+
+
+BATCH_TARGET static void
+BatchKernel(Dot)(vec3_soa A, vec3_soa B, float *Out, uint64_t Count)
+{
+    uint64_t Idx = 0;
+
+    for (; Idx + BATCH_WIDTH <= Count; Idx += BATCH_WIDTH)
+    {
+        batch_lane Result = BatchMul(BatchLoad(A.X + Idx), BatchLoad(B.X + Idx));
+        Result = BatchMulAdd(BatchLoad(A.Y + Idx), BatchLoad(B.Y + Idx), Result);
+        Result = BatchMulAdd(BatchLoad(A.Z + Idx), BatchLoad(B.Z + Idx), Result);
+
+        BatchStore(Out + Idx, Result);
+    }
+
+    for (; Idx < Count; ++Idx)
+    {
+        Out[Idx] = A.X[Idx] * B.X[Idx] + A.Y[Idx] * B.Y[Idx] + A.Z[Idx] * B.Z[Idx];
+    }
+}
+
+
+BATCH_TARGET static void
+BatchKernel(Cross)(vec3_soa A, vec3_soa B, vec3_soa Out, uint64_t Count)
+{
+    uint64_t Idx = 0;
+
+    for (; Idx + BATCH_WIDTH <= Count; Idx += BATCH_WIDTH)
+    {
+        batch_lane AX = BatchLoad(A.X + Idx), AY = BatchLoad(A.Y + Idx), AZ = BatchLoad(A.Z + Idx);
+        batch_lane BX = BatchLoad(B.X + Idx), BY = BatchLoad(B.Y + Idx), BZ = BatchLoad(B.Z + Idx);
+
+        BatchStore(Out.X + Idx, BatchSub(BatchMul(AY, BZ), BatchMul(AZ, BY)));
+        BatchStore(Out.Y + Idx, BatchSub(BatchMul(AZ, BX), BatchMul(AX, BZ)));
+        BatchStore(Out.Z + Idx, BatchSub(BatchMul(AX, BY), BatchMul(AY, BX)));
+    }
+
+    for (; Idx < Count; ++Idx)
+    {
+        float AX = A.X[Idx], AY = A.Y[Idx], AZ = A.Z[Idx];
+        float BX = B.X[Idx], BY = B.Y[Idx], BZ = B.Z[Idx];
+
+        Out.X[Idx] = AY * BZ - AZ * BY;
+        Out.Y[Idx] = AZ * BX - AX * BZ;
+        Out.Z[Idx] = AX * BY - AY * BX;
+    }
+}
+
+
+// Zero-length vectors are left untouched, like Vec3Normalize.
+BATCH_TARGET static void
+BatchKernel(Normalize)(vec3_soa A, vec3_soa Out, uint64_t Count)
+{
+    batch_lane One = BatchSet1(1.f);
+
+    uint64_t Idx = 0;
+
+    for (; Idx + BATCH_WIDTH <= Count; Idx += BATCH_WIDTH)
+    {
+        batch_lane X = BatchLoad(A.X + Idx);
+        batch_lane Y = BatchLoad(A.Y + Idx);
+        batch_lane Z = BatchLoad(A.Z + Idx);
+
+        batch_lane LengthSquared = BatchMulAdd(Z, Z, BatchMulAdd(Y, Y, BatchMul(X, X)));
+        batch_lane Inverse       = BatchDiv(One, BatchSqrt(LengthSquared));
+        batch_lane Factor        = BatchSelectPositive(LengthSquared, Inverse, One);
+
+        BatchStore(Out.X + Idx, BatchMul(X, Factor));
+        BatchStore(Out.Y + Idx, BatchMul(Y, Factor));
+        BatchStore(Out.Z + Idx, BatchMul(Z, Factor));
+    }
+
+    for (; Idx < Count; ++Idx)
+    {
+        float X             = A.X[Idx];
+        float Y             = A.Y[Idx];
+        float Z             = A.Z[Idx];
+        float LengthSquared = X * X + Y * Y + Z * Z;
+        float Factor        = LengthSquared > 0.f ? 1.f / sqrtf(LengthSquared) : 1.f;
+
+        Out.X[Idx] = X * Factor;
+        Out.Y[Idx] = Y * Factor;
+        Out.Z[Idx] = Z * Factor;
+    }
+}
+
+
+// Points (w = 1), without the divide by w.
+BATCH_TARGET static void
+BatchKernel(Transform)(mat4x4 *M, vec3_soa A, vec3_soa Out, uint64_t Count)
+{
+    batch_lane M00 = BatchSet1(M->c0r0), M01 = BatchSet1(M->c1r0), M02 = BatchSet1(M->c2r0), M03 = BatchSet1(M->c3r0);
+    batch_lane M10 = BatchSet1(M->c0r1), M11 = BatchSet1(M->c1r1), M12 = BatchSet1(M->c2r1), M13 = BatchSet1(M->c3r1);
+    batch_lane M20 = BatchSet1(M->c0r2), M21 = BatchSet1(M->c1r2), M22 = BatchSet1(M->c2r2), M23 = BatchSet1(M->c3r2);
+
+    uint64_t Idx = 0;
+
+    for (; Idx + BATCH_WIDTH <= Count; Idx += BATCH_WIDTH)
+    {
+        batch_lane X = BatchLoad(A.X + Idx);
+        batch_lane Y = BatchLoad(A.Y + Idx);
+        batch_lane Z = BatchLoad(A.Z + Idx);
+
+        BatchStore(Out.X + Idx, BatchMulAdd(M02, Z, BatchMulAdd(M01, Y, BatchMulAdd(M00, X, M03))));
+        BatchStore(Out.Y + Idx, BatchMulAdd(M12, Z, BatchMulAdd(M11, Y, BatchMulAdd(M10, X, M13))));
+        BatchStore(Out.Z + Idx, BatchMulAdd(M22, Z, BatchMulAdd(M21, Y, BatchMulAdd(M20, X, M23))));
+    }
+
+    for (; Idx < Count; ++Idx)
+    {
+        float X = A.X[Idx];
+        float Y = A.Y[Idx];
+        float Z = A.Z[Idx];
+
+        Out.X[Idx] = M->c0r0 * X + M->c1r0 * Y + M->c2r0 * Z + M->c3r0;
+        Out.Y[Idx] = M->c0r1 * X + M->c1r1 * Y + M->c2r1 * Z + M->c3r1;
+        Out.Z[Idx] = M->c0r2 * X + M->c1r2 * Y + M->c2r2 * Z + M->c3r2;
+    }
+}
+
+
+// Boxes are kept when, for every plane, the corner furthest along the normal is on
+// the positive side. This is conservative: boxes near a frustum corner can pass
+// while being outside, which costs a draw and never drops a visible box.
+BATCH_TARGET static uint64_t
+BatchKernel(CullBoxes)(vec3_soa Centers, vec3_soa Extents, plane *Planes, uint32_t PlaneCount, uint32_t *Visible, uint64_t Count)
+{
+    batch_lane NormalX[VEC3_BATCH_MAX_PLANES], AbsNormalX[VEC3_BATCH_MAX_PLANES];
+    batch_lane NormalY[VEC3_BATCH_MAX_PLANES], AbsNormalY[VEC3_BATCH_MAX_PLANES];
+    batch_lane NormalZ[VEC3_BATCH_MAX_PLANES], AbsNormalZ[VEC3_BATCH_MAX_PLANES];
+    batch_lane Offset[VEC3_BATCH_MAX_PLANES];
+
+    for (uint32_t Plane = 0; Plane < PlaneCount; ++Plane)
+    {
+        NormalX[Plane]    = BatchSet1(Planes[Plane].Normal.X);
+        NormalY[Plane]    = BatchSet1(Planes[Plane].Normal.Y);
+        NormalZ[Plane]    = BatchSet1(Planes[Plane].Normal.Z);
+        AbsNormalX[Plane] = BatchSet1(fabsf(Planes[Plane].Normal.X));
+        AbsNormalY[Plane] = BatchSet1(fabsf(Planes[Plane].Normal.Y));
+        AbsNormalZ[Plane] = BatchSet1(fabsf(Planes[Plane].Normal.Z));
+        Offset[Plane]     = BatchSet1(Planes[Plane].Offset);
+    }
+
+    uint64_t VisibleCount = 0;
+    uint64_t Idx          = 0;
+
+    for (; Idx + BATCH_WIDTH <= Count; Idx += BATCH_WIDTH)
+    {
+        batch_lane CenterX = BatchLoad(Centers.X + Idx);
+        batch_lane CenterY = BatchLoad(Centers.Y + Idx);
+        batch_lane CenterZ = BatchLoad(Centers.Z + Idx);
+        batch_lane ExtentX = BatchLoad(Extents.X + Idx);
+        batch_lane ExtentY = BatchLoad(Extents.Y + Idx);
+        batch_lane ExtentZ = BatchLoad(Extents.Z + Idx);
+
+        batch_lane Nearest = BatchSet1(INFINITY);
+
+        for (uint32_t Plane = 0; Plane < PlaneCount; ++Plane)
+        {
+            batch_lane Distance = BatchMulAdd(NormalZ[Plane], CenterZ, BatchMulAdd(NormalY[Plane], CenterY, BatchMulAdd(NormalX[Plane], CenterX, Offset[Plane])));
+            batch_lane Radius   = BatchMulAdd(AbsNormalZ[Plane], ExtentZ, BatchMulAdd(AbsNormalY[Plane], ExtentY, BatchMul(AbsNormalX[Plane], ExtentX)));
+
+            Nearest = BatchMin(Nearest, BatchAdd(Distance, Radius));
+        }
+
+        // Branchless compaction: every lane writes its index, only visible ones advance.
+        uint32_t Mask = BatchNonNegativeMask(Nearest);
+        if (Mask)
+        {
+            for (uint32_t Lane = 0; Lane < BATCH_WIDTH; ++Lane)
+            {
+                Visible[VisibleCount] = (uint32_t)(Idx + Lane);
+                VisibleCount         += (Mask >> Lane) & 1;
+            }
+        }
+    }
+
+    for (; Idx < Count; ++Idx)
+    {
+        float Nearest = INFINITY;
+
+        for (uint32_t Plane = 0; Plane < PlaneCount; ++Plane)
+        {
+            vec3  Normal   = Planes[Plane].Normal;
+            float Distance = Normal.X * Centers.X[Idx] + Normal.Y * Centers.Y[Idx] + Normal.Z * Centers.Z[Idx] + Planes[Plane].Offset;
+            float Radius   = fabsf(Normal.X) * Extents.X[Idx] + fabsf(Normal.Y) * Extents.Y[Idx] + fabsf(Normal.Z) * Extents.Z[Idx];
+
+            Nearest = fminf(Nearest, Distance + Radius);
+        }
+
+        if (Nearest >= 0.f)
+        {
+            Visible[VisibleCount++] = (uint32_t)Idx;
+        }
+    }
+
+    return VisibleCount;
+}
+
+
+#undef BatchKernel
+#undef BatchKernelExpand
+#undef BatchKernelName
@@ -0,0 +1,293 @@
+#include "profiler.h"
+
+#if ENGINE_PROFILER
+
+#include <stdint.h>
+#include <stdbool.h>
+#include <stdio.h>
+
+#if defined(_MSC_VER)
+#include <intrin.h>
+#else
+#include <x86intrin.h>
+#endif
+
+#include "utilities.h"
+#include "platform/platform.h"
+
+
+// =====================================================
+// [SECTION] Internal Types
+// =====================================================
+
+
+#if defined(_MSC_VER)
+#define ProfilerThreadLocal __declspec(thread)
+#else
+#define ProfilerThreadLocal __thread
+#endif
+
+
+typedef enum
+{
+    ProfilerEvent_Zone    = 0,
+    ProfilerEvent_Counter = 1,
+    ProfilerEvent_Frame   = 2,
+} ProfilerEvent_Type;
+
+
+typedef struct
+{
+    const char        *Name;
+    uint64_t           Begin;
+    uint64_t           End;
+    int64_t            Value;
+    ProfilerEvent_Type Type;
+} profiler_event;
+
+
+typedef struct
+{
+    uint64_t volatile  WriteCount;
+    profiler_event    *Events;
+    uint32_t           ThreadID;
+    bool volatile      Ready;
+    char               Name[32];
+} profiler_thread;
+
+
+typedef struct
+{
+    uint32_t volatile  ThreadCount;
+    uint64_t           BaseTicks;
+    uint64_t           BaseNanoseconds;
+    profiler_thread    Threads[PROFILER_MAX_THREADS];
+} profiler_state;
+
+
+static profiler_state                       GlobalProfiler;
+static ProfilerThreadLocal profiler_thread *ThreadProfiler;
+static ProfilerThreadLocal bool             ThreadProfilerFailed;
+
+
+// =====================================================
+// [SECTION] Recording
+// =====================================================
+
+
+void
+ProfilerInitialize(void)
+{
+    GlobalProfiler.BaseNanoseconds = OSGetTimeNanoseconds();
+    GlobalProfiler.BaseTicks       = __rdtsc();
+}
+
+
+uint64_t
+ProfilerGetTimestamp(void)
+{
+    uint64_t Result = __rdtsc();
+    return Result;
+}
+
+
+void
+ProfilerRegisterThread(const char *Name, uint32_t Index)
+{
+    if (ThreadProfiler || ThreadProfilerFailed)
+    {
+        return;
+    }
+
+    uint32_t Slot = AtomicIncrementU32(&GlobalProfiler.ThreadCount) - 1;
+    if (Slot >= PROFILER_MAX_THREADS)
+    {
+        ThreadProfilerFailed = true;
+        return;
+    }
+
+    size_t          Size   = PROFILER_EVENTS_PER_THREAD * sizeof(profiler_event);
+    profiler_event *Events = (profiler_event *)OSReserve(Size);
+    if (!Events || !OSCommit(Events, Size))
+    {
+        ThreadProfilerFailed = true;
+        return;
+    }
+
+    profiler_thread *Thread = GlobalProfiler.Threads + Slot;
+    Thread->Events   = Events;
+    Thread->ThreadID = OSGetThreadID();
+    snprintf(Thread->Name, sizeof(Thread->Name), "%s %u", Name ? Name : "Thread", Index);
+
+    Thread->Ready  = true;
+    ThreadProfiler = Thread;
+}
+
+
+static void
+ProfilerPushEvent(profiler_event Event)
+{
+    // Threads that never registered get a generic name on their first event.
+    if (!ThreadProfiler)
+    {
+        ProfilerRegisterThread(0, OSGetThreadID());
+
+        if (!ThreadProfiler)
+        {
+            return;
+        }
+    }
+
+    profiler_thread *Thread = ThreadProfiler;
+    uint64_t         Slot   = Thread->WriteCount & (PROFILER_EVENTS_PER_THREAD - 1);
+
+    Thread->Events[Slot] = Event;
+    Thread->WriteCount  += 1;
+}
+
+
+void
+ProfilerRecordZone(const char *Name, uint64_t Begin)
+{
+    profiler_event Event =
+    {
+        .Name  = Name,
+        .Begin = Begin,
+        .End   = __rdtsc(),
+        .Type  = ProfilerEvent_Zone,
+    };
+
+    ProfilerPushEvent(Event);
+}
+
+
+void
+ProfilerRecordCounter(const char *Name, int64_t Value)
+{
+    profiler_event Event =
+    {
+        .Name  = Name,
+        .Begin = __rdtsc(),
+        .Value = Value,
+        .Type  = ProfilerEvent_Counter,
+    };
+
+    ProfilerPushEvent(Event);
+}
+
+
+void
+ProfilerRecordFrame(void)
+{
+    profiler_event Event =
+    {
+        .Name  = "Frame",
+        .Begin = __rdtsc(),
+        .Type  = ProfilerEvent_Frame,
+    };
+
+    ProfilerPushEvent(Event);
+}
+
+
+// =====================================================
+// [SECTION] Trace Export
+// [DESCRIP]
+//   Writes the Chrome trace event format, which loads in
+//   chrome://tracing and ui.perfetto.dev. Timestamps are
+//   converted from TSC ticks using the monotonic clock
+//   sampled at initialization and at export. Call it once
+//   the workers are idle: buffers are read without locks.
+// =====================================================
+
+
+// Records are separated by ",\n"; the first one has nothing in front of it.
+static const char *
+ProfilerGetTraceSeparator(bool *First)
+{
+    const char *Result = *First ? "" : ",\n";
+    *First = false;
+
+    return Result;
+}
+
+
+void
+ProfilerWriteTrace(const char *Path)
+{
+    uint64_t ElapsedTicks       = __rdtsc() - GlobalProfiler.BaseTicks;
+    uint64_t ElapsedNanoseconds = OSGetTimeNanoseconds() - GlobalProfiler.BaseNanoseconds;
+
+    if (!Path || !ElapsedTicks || !ElapsedNanoseconds)
+    {
+        return;
+    }
+
+    double MicrosecondsPerTick = ((double)ElapsedNanoseconds / 1000.0) / (double)ElapsedTicks;
+
+    FILE *File = fopen(Path, "wb");
+    if (!File)
+    {
+        return;
+    }
+
+    fprintf(File, "{\"displayTimeUnit\":\"ns\",\"traceEvents\":[\n");
+
+    bool     First       = true;
+    uint32_t ThreadCount = Minimum(GlobalProfiler.ThreadCount, PROFILER_MAX_THREADS);
+
+    for (uint32_t ThreadIdx = 0; ThreadIdx < ThreadCount; ++ThreadIdx)
+    {
+        profiler_thread *Thread = GlobalProfiler.Threads + ThreadIdx;
+        if (!Thread->Ready)
+        {
+            continue;
+        }
+
+        fprintf(File, "%s{\"name\":\"thread_name\",\"ph\":\"M\",\"pid\":1,\"tid\":%u,\"args\":{\"name\":\"%s\"}}",
+                ProfilerGetTraceSeparator(&First), Thread->ThreadID, Thread->Name);
+
+        uint64_t WriteCount = Thread->WriteCount;
+        uint64_t FirstEvent = WriteCount > PROFILER_EVENTS_PER_THREAD ? WriteCount - PROFILER_EVENTS_PER_THREAD : 0;
+
+        for (uint64_t EventIdx = FirstEvent; EventIdx < WriteCount; ++EventIdx)
+        {
+            profiler_event *Event = Thread->Events + (EventIdx & (PROFILER_EVENTS_PER_THREAD - 1));
+            if (Event->Begin < GlobalProfiler.BaseTicks)
+            {
+                continue;
+            }
+
+            double Timestamp = (double)(Event->Begin - GlobalProfiler.BaseTicks) * MicrosecondsPerTick;
+
+            switch (Event->Type)
+            {
+
+            case ProfilerEvent_Zone:
+            {
+                double Duration = (double)(Event->End - Event->Begin) * MicrosecondsPerTick;
+                fprintf(File, "%s{\"name\":\"%s\",\"ph\":\"X\",\"pid\":1,\"tid\":%u,\"ts\":%.3f,\"dur\":%.3f}",
+                        ProfilerGetTraceSeparator(&First), Event->Name, Thread->ThreadID, Timestamp, Duration);
+            } break;
+
+            case ProfilerEvent_Counter:
+            {
+                fprintf(File, "%s{\"name\":\"%s\",\"ph\":\"C\",\"pid\":1,\"tid\":%u,\"ts\":%.3f,\"args\":{\"%s\":%lld}}",
+                        ProfilerGetTraceSeparator(&First), Event->Name, Thread->ThreadID, Timestamp, Event->Name, (long long)Event->Value);
+            } break;
+
+            case ProfilerEvent_Frame:
+            {
+                fprintf(File, "%s{\"name\":\"%s\",\"ph\":\"i\",\"s\":\"g\",\"pid\":1,\"tid\":%u,\"ts\":%.3f}",
+                        ProfilerGetTraceSeparator(&First), Event->Name, Thread->ThreadID, Timestamp);
+            } break;
+
+            }
+        }
+    }
+
+    fprintf(File, "\n]}\n");
+    fclose(File);
+}
+
+#endif // ENGINE_PROFILER
@@ -0,0 +1,72 @@
+#pragma once
+
+#include <stdint.h>
+
+
+// =====================================================
+// [SECTION] Configuration
+// [DESCRIP]
+//   The profiler is on in debug builds and compiles out
+//   entirely when NDEBUG is defined. Define ENGINE_PROFILER
+//   to 0 or 1 to override either way.
+// =====================================================
+
+
+#ifndef ENGINE_PROFILER
+#ifdef NDEBUG
+#define ENGINE_PROFILER 0
+#else
+#define ENGINE_PROFILER 1
+#endif
+#endif
+
+#define PROFILER_MAX_THREADS        64
+#define PROFILER_EVENTS_PER_THREAD  32768
+
+
+// =====================================================
+// [SECTION] Profiler API
+// [DESCRIP]
+//   Every thread writes into its own ring buffer, so
+//   recording never takes a lock. Zones keep their begin
+//   timestamp in a local of the calling function instead
+//   of a per-thread stack: a job that suspends inside a
+//   zone may end it on another worker (see fibers).
+//
+//   ProfileBegin(UpdateEngine);
+//   ...
+//   ProfileEnd(UpdateEngine);
+//
+//   Names must be identifiers and begin/end must appear
+//   in the same scope. Older events are overwritten once a
+//   thread's buffer wraps.
+// =====================================================
+
+
+#if ENGINE_PROFILER
+
+void      ProfilerInitialize     (void);
+void      ProfilerRegisterThread (const char *Name, uint32_t Index);
+uint64_t  ProfilerGetTimestamp   (void);
+void      ProfilerRecordZone     (const char *Name, uint64_t Begin);
+void      ProfilerRecordCounter  (const char *Name, int64_t Value);
+void      ProfilerRecordFrame    (void);
+void      ProfilerWriteTrace     (const char *Path);
+
+#define ProfileBegin(Name)          uint64_t ProfileZone_##Name = ProfilerGetTimestamp()
+#define ProfileEnd(Name)            ProfilerRecordZone(#Name, ProfileZone_##Name)
+#define ProfileCounter(Name, Value) ProfilerRecordCounter(#Name, (int64_t)(Value))
+#define ProfileFrame()              ProfilerRecordFrame()
+
+#else
+
+#define ProfilerInitialize()
+#define ProfilerRegisterThread(Name, Index)
+#define ProfilerWriteTrace(Path)
+
+#define ProfileBegin(Name)
+#define ProfileEnd(Name)
+#define ProfileCounter(Name, Value)
+#define ProfileFrame()
+
+#endif
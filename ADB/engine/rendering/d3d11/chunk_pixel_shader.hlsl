@@ -0,0 +1,3 @@
+// Pixel stage of chunk_shader.hlsl. FxCompile builds one entry point per file, so this
+// is compiled with /E PS into chunk_pixel_shader.h (ChunkPixelShaderBytes).
+#include "chunk_shader.hlsl"
@@ -1,7 +1,8 @@
+// tile_vertex_packed: chunk-local integer position, UV in tiles (wrapped by the sampler).
 struct VS_INPUT
 {
-    float3 Position : POSITION;
-    float2 TexCoord : TEXCOORD0;
+    uint4 Position : POSITION;
+    uint2 TexCoord : TEXCOORD0;
 };
 
 struct PS_INPUT
@@ -19,14 +20,23 @@ cbuffer TransformBuffer : register(b0)
 };
 
 
+cbuffer ChunkBuffer : register(b1)
+{
+    float3 Origin;
+    float  _Padding0;
+};
+
+
 PS_INPUT VS(VS_INPUT Input)
 {
     PS_INPUT Output;
     
-    float4 WorldPos = mul(World, float4(Input.Position, 1.0));
+    float3 Position = Origin + float3(Input.Position.xyz);
+
+    float4 WorldPos = mul(World, float4(Position, 1.0));
     float4 ViewPos  = mul(View, WorldPos);
     Output.Position = mul(Projection, ViewPos);
-    Output.TexCoord = Input.TexCoord;
+    Output.TexCoord = float2(Input.TexCoord);
     
     return Output;
 }
@@ -0,0 +1,3 @@
+// Vertex stage of chunk_shader.hlsl. FxCompile builds one entry point per file, so this
+// is compiled with /E VS into chunk_vertex_shader.h (ChunkVertexShaderBytes).
+#include "chunk_shader.hlsl"
@@ -19,6 +19,7 @@
 #include "engine/rendering/renderer.h"
 #include "engine/rendering/renderer_internal.h"
 #include <engine/math/matrix.h>
+#include "engine/profiler/profiler.h"
 
 #include "ui_vertex_shader.h"
 #include "ui_pixel_shader.h"
@@ -26,6 +27,8 @@
 #include "gizmo_pixel_shader.h"
 #include "chunk_vertex_shader.h"
 #include "chunk_pixel_shader.h"
+#include "tile_vertex_shader.h"
+#include "tile_pixel_shader.h"
 
 
 #define MAX_MATERIAL_COUNT 64
@@ -68,8 +71,19 @@ typedef struct
     ID3D11VertexShader    *ChunkVertexShader;
     ID3D11PixelShader     *ChunkPixelShader;
     ID3D11Buffer          *ChunkBatchUniformBuffer;
+    ID3D11Buffer          *ChunkOriginUniformBuffer;
+    ID3D11Buffer          *QuadIndexBuffer;
     ID3D11SamplerState    *ChunkSamplerState;
     ID3D11RasterizerState *ChunkRasterizerState;
+
+    // Tile Objects
+
+    ID3D11InputLayout     *TileInputLayout;
+    ID3D11VertexShader    *TileVertexShader;
+    ID3D11PixelShader     *TilePixelShader;
+    ID3D11Buffer          *TileBatchUniformBuffer;
+    ID3D11Buffer          *TileIndexBuffer;
+    ID3D11SamplerState    *TileSamplerState;
 } d3d11_renderer;
 
 
@@ -104,6 +118,23 @@ typedef struct
 } d3d11_chunk_batch_data;
 
 
+typedef struct
+{
+    vec3  Origin;
+    float _Padding0;
+} d3d11_chunk_origin_data;
+
+
+// Materials do not describe their atlas layout yet: every tile samples the whole texture.
+#define TILE_ATLAS_COLUMNS 1
+
+typedef struct
+{
+    vec3     Origin;
+    uint32_t AtlasColumns;
+} d3d11_tile_batch_data;
+
+
 d3d11_renderer *
 D3D11Initialize(HWND HWindow, memory_arena *Arena)
 {
@@ -194,7 +225,7 @@ D3D11Initialize(HWND HWindow, memory_arena *Arena)
             D3D11_INPUT_ELEMENT_DESC InputLayout[] =
             {
                 {"POSITION", 0, DXGI_FORMAT_R32G32B32_FLOAT, 0, D3D11_APPEND_ALIGNED_ELEMENT, D3D11_INPUT_PER_VERTEX_DATA, 0},
-                {"COLOR"   , 0, DXGI_FORMAT_R32G32B32_FLOAT, 0, D3D11_APPEND_ALIGNED_ELEMENT, D3D11_INPUT_PER_VERTEX_DATA, 0},
+                {"COLOR"   , 0, DXGI_FORMAT_R8G8B8A8_UNORM , 0, D3D11_APPEND_ALIGNED_ELEMENT, D3D11_INPUT_PER_VERTEX_DATA, 0},
             };
 
             Result->Device->lpVtbl->CreateVertexShader(Result->Device, GizmoVertexShaderBytes, sizeof(GizmoVertexShaderBytes), 0, &Result->GizmoVertexShader);
@@ -205,13 +236,29 @@ D3D11Initialize(HWND HWindow, memory_arena *Arena)
         {
             D3D11_INPUT_ELEMENT_DESC InputLayout[] =
             {
-                {"POSITION", 0, DXGI_FORMAT_R32G32B32_FLOAT, 0, D3D11_APPEND_ALIGNED_ELEMENT, D3D11_INPUT_PER_VERTEX_DATA, 0},
-                {"TEXCOORD", 0, DXGI_FORMAT_R32G32_FLOAT   , 0, D3D11_APPEND_ALIGNED_ELEMENT, D3D11_INPUT_PER_VERTEX_DATA, 0},
+                {"POSITION", 0, DXGI_FORMAT_R8G8B8A8_UINT, 0, D3D11_APPEND_ALIGNED_ELEMENT, D3D11_INPUT_PER_VERTEX_DATA, 0},
+                {"TEXCOORD", 0, DXGI_FORMAT_R16G16_UINT  , 0, D3D11_APPEND_ALIGNED_ELEMENT, D3D11_INPUT_PER_VERTEX_DATA, 0},
             };
 
             Result->Device->lpVtbl->CreateVertexShader(Result->Device, ChunkVertexShaderBytes, sizeof(ChunkVertexShaderBytes), 0, &Result->ChunkVertexShader);
             Result->Device->lpVtbl->CreatePixelShader(Result->Device, ChunkPixelShaderBytes, sizeof(ChunkPixelShaderBytes), 0, &Result->ChunkPixelShader);
-            Result->Device->lpVtbl->CreateInputLayout(Result->Device, InputLayout, ARRAYSIZE(InputLayout), ChunkVertexShaderBytes, sizeof(ChunkVertexShaderBytes), &Result->ChunkInputLayout);
+            // Fails when the integer formats do not match the shader's input signature.
+            HRESULT Error = Result->Device->lpVtbl->CreateInputLayout(Result->Device, InputLayout, ARRAYSIZE(InputLayout), ChunkVertexShaderBytes, sizeof(ChunkVertexShaderBytes), &Result->ChunkInputLayout);
+            assert(SUCCEEDED(Error));
+        }
+
+        {
+            // One tile_instance per tile; the quad corners come from SV_VertexID.
+            D3D11_INPUT_ELEMENT_DESC InputLayout[] =
+            {
+                {"TILE"  , 0, DXGI_FORMAT_R8G8_UINT, 0, 0, D3D11_INPUT_PER_INSTANCE_DATA, 1},
+                {"TILEID", 0, DXGI_FORMAT_R16_UINT , 0, 2, D3D11_INPUT_PER_INSTANCE_DATA, 1},
+            };
+
+            Result->Device->lpVtbl->CreateVertexShader(Result->Device, TileVertexShaderBytes, sizeof(TileVertexShaderBytes), 0, &Result->TileVertexShader);
+            Result->Device->lpVtbl->CreatePixelShader(Result->Device, TilePixelShaderBytes, sizeof(TilePixelShaderBytes), 0, &Result->TilePixelShader);
+            HRESULT Error = Result->Device->lpVtbl->CreateInputLayout(Result->Device, InputLayout, ARRAYSIZE(InputLayout), TileVertexShaderBytes, sizeof(TileVertexShaderBytes), &Result->TileInputLayout);
+            assert(SUCCEEDED(Error));
         }
     }
 
@@ -249,6 +296,74 @@ D3D11Initialize(HWND HWindow, memory_arena *Arena)
             
             Result->Device->lpVtbl->CreateBuffer(Result->Device, &Desc, 0, &Result->ChunkBatchUniformBuffer);
         }
+
+        {
+            D3D11_BUFFER_DESC Desc = {0};
+            Desc.ByteWidth      = sizeof(d3d11_chunk_origin_data);
+            Desc.Usage          = D3D11_USAGE_DYNAMIC;
+            Desc.BindFlags      = D3D11_BIND_CONSTANT_BUFFER;
+            Desc.CPUAccessFlags = D3D11_CPU_ACCESS_WRITE;
+
+            Result->Device->lpVtbl->CreateBuffer(Result->Device, &Desc, 0, &Result->ChunkOriginUniformBuffer);
+        }
+
+        {
+            D3D11_BUFFER_DESC Desc = {0};
+            Desc.ByteWidth      = sizeof(d3d11_tile_batch_data);
+            Desc.Usage          = D3D11_USAGE_DYNAMIC;
+            Desc.BindFlags      = D3D11_BIND_CONSTANT_BUFFER;
+            Desc.CPUAccessFlags = D3D11_CPU_ACCESS_WRITE;
+
+            Result->Device->lpVtbl->CreateBuffer(Result->Device, &Desc, 0, &Result->TileBatchUniformBuffer);
+        }
+    }
+
+    // Shared by every tile instance: the vertex shader expands the four corners from SV_VertexID.
+    {
+        static const uint16_t TileIndices[6] = { 0, 1, 2, 0, 2, 3 };
+
+        D3D11_BUFFER_DESC Desc =
+        {
+            .ByteWidth = sizeof(TileIndices),
+            .Usage     = D3D11_USAGE_IMMUTABLE,
+            .BindFlags = D3D11_BIND_INDEX_BUFFER,
+        };
+
+        D3D11_SUBRESOURCE_DATA InitialData = { .pSysMem = TileIndices };
+
+        Result->Device->lpVtbl->CreateBuffer(Result->Device, &Desc, &InitialData, &Result->TileIndexBuffer);
+    }
+
+    // Shared by every RenderIndex_Quads draw, so quad meshes only upload vertices.
+    {
+        memory_region Region  = EnterMemoryRegion(Arena);
+        uint32_t      Count   = RENDER_MAX_SHARED_QUADS * 6;
+        uint16_t     *Indices = PushArray(Arena, uint16_t, Count);
+
+        for (uint32_t Quad = 0; Quad < RENDER_MAX_SHARED_QUADS; ++Quad)
+        {
+            uint16_t First = (uint16_t)(Quad * 4);
+
+            Indices[Quad * 6 + 0] = First + 0;
+            Indices[Quad * 6 + 1] = First + 1;
+            Indices[Quad * 6 + 2] = First + 2;
+            Indices[Quad * 6 + 3] = First + 0;
+            Indices[Quad * 6 + 4] = First + 2;
+            Indices[Quad * 6 + 5] = First + 3;
+        }
+
+        D3D11_BUFFER_DESC Desc =
+        {
+            .ByteWidth = Count * sizeof(uint16_t),
+            .Usage     = D3D11_USAGE_IMMUTABLE,
+            .BindFlags = D3D11_BIND_INDEX_BUFFER,
+        };
+
+        D3D11_SUBRESOURCE_DATA InitialData = { .pSysMem = Indices };
+
+        Result->Device->lpVtbl->CreateBuffer(Result->Device, &Desc, &InitialData, &Result->QuadIndexBuffer);
+
+        LeaveMemoryRegion(Region);
     }
 
     {
@@ -292,6 +407,20 @@ D3D11Initialize(HWND HWindow, memory_arena *Arena)
 
     // Samplers
     {
+        // Chunk UVs count tiles: merged quads repeat the texture.
+        {
+            D3D11_SAMPLER_DESC Desc = {0};
+            Desc.Filter         = D3D11_FILTER_MIN_MAG_MIP_LINEAR;
+            Desc.AddressU       = D3D11_TEXTURE_ADDRESS_WRAP;
+            Desc.AddressV       = D3D11_TEXTURE_ADDRESS_WRAP;
+            Desc.AddressW       = D3D11_TEXTURE_ADDRESS_WRAP;
+            Desc.MaxAnisotropy  = 1;
+            Desc.ComparisonFunc = D3D11_COMPARISON_NEVER;
+            Desc.MaxLOD         = D3D11_FLOAT32_MAX;
+
+            Result->Device->lpVtbl->CreateSamplerState(Result->Device, &Desc, &Result->ChunkSamplerState);
+        }
+
         {
             D3D11_SAMPLER_DESC Desc = {0};
             Desc.Filter         = D3D11_FILTER_MIN_MAG_MIP_LINEAR;
@@ -302,7 +431,7 @@ D3D11Initialize(HWND HWindow, memory_arena *Arena)
             Desc.ComparisonFunc = D3D11_COMPARISON_NEVER;
             Desc.MaxLOD         = D3D11_FLOAT32_MAX;
 
-            Result->Device->lpVtbl->CreateSamplerState(Result->Device, &Desc, &Result->ChunkSamplerState);
+            Result->Device->lpVtbl->CreateSamplerState(Result->Device, &Desc, &Result->TileSamplerState);
         }
 
         {
@@ -362,7 +491,7 @@ RendererCreateVertexBuffer(void *Data, uint64_t Size, renderer *Renderer)
 {
     ID3D11Buffer *Result = 0;
 
-    if (Data && Size && Renderer)
+    if (Size && Renderer)
     {
         d3d11_renderer *D3D11 = (d3d11_renderer *)Renderer->Backend;
         ID3D11Device   *Device = D3D11->Device;
@@ -384,12 +513,78 @@ RendererCreateVertexBuffer(void *Data, uint64_t Size, renderer *Renderer)
             .SysMemSlicePitch = 0,
         };
 
-        Device->lpVtbl->CreateBuffer(Device, &Desc, &InitialData, &Result);
+        Device->lpVtbl->CreateBuffer(Device, &Desc, Data ? &InitialData : 0, &Result);
+    }
+
+    return Result;
+}
+
+void *
+RendererCreateIndexBuffer(void *Data, uint64_t Size, renderer *Renderer)
+{
+    ID3D11Buffer *Result = 0;
+
+    if (Size && Renderer)
+    {
+        d3d11_renderer *D3D11 = (d3d11_renderer *)Renderer->Backend;
+        ID3D11Device   *Device = D3D11->Device;
+
+        D3D11_BUFFER_DESC Desc =
+        {
+            .ByteWidth           = Size,
+            .Usage               = D3D11_USAGE_DEFAULT,
+            .BindFlags           = D3D11_BIND_INDEX_BUFFER,
+            .CPUAccessFlags      = 0,
+            .MiscFlags           = 0,
+            .StructureByteStride = 0,
+        };
+
+        D3D11_SUBRESOURCE_DATA InitialData =
+        {
+            .pSysMem          = Data,
+            .SysMemPitch      = 0,
+            .SysMemSlicePitch = 0,
+        };
+
+        Device->lpVtbl->CreateBuffer(Device, &Desc, Data ? &InitialData : 0, &Result);
     }
 
     return Result;
 }
 
+void
+RendererUpdateBuffer(void *Buffer, uint64_t Offset, void *Data, uint64_t Size, renderer *Renderer)
+{
+    if (Buffer && Data && Size && Renderer)
+    {
+        d3d11_renderer      *D3D11   = (d3d11_renderer *)Renderer->Backend;
+        ID3D11DeviceContext *Context = D3D11->DeviceContext;
+
+        D3D11_BOX Box =
+        {
+            .left   = (UINT)Offset,
+            .right  = (UINT)(Offset + Size),
+            .top    = 0,
+            .bottom = 1,
+            .front  = 0,
+            .back   = 1,
+        };
+
+        Context->lpVtbl->UpdateSubresource(Context, (ID3D11Resource *)Buffer, 0, &Box, Data, 0, 0);
+    }
+}
+
+void
+RendererReleaseBuffer(void *Buffer, renderer *Renderer)
+{
+    (void)Renderer;
+
+    if (Buffer)
+    {
+        ((ID3D11Buffer *)Buffer)->lpVtbl->Release((ID3D11Buffer *)Buffer);
+    }
+}
+
 void *
 RendererCreateTexture(loaded_texture LoadedTexture, renderer *Renderer)
 {
@@ -464,6 +659,8 @@ RendererEnterFrame(clear_color Color, renderer *Renderer)
 void
 RendererLeaveFrame(int Width, int Height, engine_memory *EngineMemory, renderer *Renderer)
 {
+    ProfileBegin(RendererLeaveFrame);
+
     d3d11_renderer      *D3D11   = (d3d11_renderer *)Renderer->Backend;
     ID3D11DeviceContext *Context = D3D11->DeviceContext;
 
@@ -474,7 +671,10 @@ RendererLeaveFrame(int Width, int Height, engine_memory *EngineMemory, renderer
         Context->lpVtbl->OMSetRenderTargets(Context, 1, &D3D11->RenderView, 0);
     }
 
-    for (render_pass_node *PassNode = Renderer->PassList.First; PassNode != 0; PassNode = PassNode->Next)
+    render_pass_list PassList = BuildRenderPassList(Renderer->Contexts, RENDER_MAX_CONTEXTS, &Renderer->Stats, EngineMemory->FrameMemory);
+    LinkRetainedLists(&PassList, Renderer, EngineMemory->FrameMemory);
+
+    for (render_pass_node *PassNode = PassList.First; PassNode != 0; PassNode = PassNode->Next)
     {
         render_pass *Pass = &PassNode->Value;
 
@@ -612,18 +812,140 @@ RendererLeaveFrame(int Width, int Height, engine_memory *EngineMemory, renderer
                         Context->lpVtbl->PSSetShaderResources(Context, 0, 1, &ColorView);
                     }
 
+                    {
+                        d3d11_chunk_origin_data OriginData = { .Origin = BatchParams->Origin };
+
+                        ID3D11Buffer *OriginBuffer = D3D11->ChunkOriginUniformBuffer;
+
+                        D3D11_MAPPED_SUBRESOURCE Mapped;
+                        Context->lpVtbl->Map(Context, (ID3D11Resource *)OriginBuffer, 0, D3D11_MAP_WRITE_DISCARD, 0, &Mapped);
+                        if (Mapped.pData)
+                        {
+                            memcpy(Mapped.pData, &OriginData, sizeof(d3d11_chunk_origin_data));
+                            Context->lpVtbl->Unmap(Context, (ID3D11Resource *)OriginBuffer, 0);
+                        }
+
+                        Context->lpVtbl->VSSetConstantBuffers(Context, 1, 1, &OriginBuffer);
+                    }
+
                     {
                         renderer_buffer *RendererBuffer = GetRendererBufferFromHandle(BatchParams->VertexBuffer, Renderer->Resources);
                         assert(RendererBuffer); // Maybe change this to a hard check.
 
                         ID3D11Buffer *VertexBuffer = (ID3D11Buffer *)RendererBuffer->Backend;
 
-                        UINT32 Stride = sizeof(tile_vertex_data);
+                        UINT32 Stride = sizeof(tile_vertex_packed);
                         UINT32 Offset = 0;
                         Context->lpVtbl->IASetVertexBuffers(Context, 0, 1, &VertexBuffer, &Stride, &Offset);
                     }
 
-                    Context->lpVtbl->Draw(Context, BatchParams->VertexCount, 0);
+                    if (BatchParams->IndexType == RenderIndex_Quads)
+                    {
+                        assert(BatchParams->IndexCount <= RENDER_MAX_SHARED_QUADS * 6);
+
+                        Context->lpVtbl->IASetIndexBuffer(Context, D3D11->QuadIndexBuffer, DXGI_FORMAT_R16_UINT, 0);
+                        Context->lpVtbl->DrawIndexed(Context, BatchParams->IndexCount, 0, 0);
+                    }
+                    else if (BatchParams->IndexType != RenderIndex_None)
+                    {
+                        renderer_buffer *RendererBuffer = GetRendererBufferFromHandle(BatchParams->IndexBuffer, Renderer->Resources);
+                        assert(RendererBuffer);
+
+                        ID3D11Buffer *IndexBuffer = (ID3D11Buffer *)RendererBuffer->Backend;
+                        DXGI_FORMAT   IndexFormat = BatchParams->IndexType == RenderIndex_U32 ? DXGI_FORMAT_R32_UINT : DXGI_FORMAT_R16_UINT;
+
+                        Context->lpVtbl->IASetIndexBuffer(Context, IndexBuffer, IndexFormat, 0);
+                        Context->lpVtbl->DrawIndexed(Context, BatchParams->IndexCount, 0, 0);
+                    }
+                    else
+                    {
+                        Context->lpVtbl->Draw(Context, BatchParams->VertexCount, 0);
+                    }
+                }
+            }
+        } break;
+
+        case RenderPass_Tile:
+        {
+            Context->lpVtbl->RSSetState(Context, D3D11->ChunkRasterizerState);
+            Context->lpVtbl->IASetPrimitiveTopology(Context, D3D11_PRIMITIVE_TOPOLOGY_TRIANGLELIST);
+            Context->lpVtbl->IASetInputLayout(Context, D3D11->TileInputLayout);
+            Context->lpVtbl->IASetIndexBuffer(Context, D3D11->TileIndexBuffer, DXGI_FORMAT_R16_UINT, 0);
+            Context->lpVtbl->VSSetShader(Context, D3D11->TileVertexShader, 0, 0);
+            Context->lpVtbl->PSSetShader(Context, D3D11->TilePixelShader, 0, 0);
+            Context->lpVtbl->PSSetSamplers(Context, 0, 1, &D3D11->TileSamplerState);
+
+            for (render_group_node *GroupNode = Pass->First; GroupNode != 0; GroupNode = GroupNode->Next)
+            {
+                tile_group_params *GroupParams = &GroupNode->Params.Tile;
+
+                // The transform block has the chunk layout.
+                d3d11_chunk_batch_data GroupData =
+                {
+                    .World      = GroupParams->WorldMatrix,
+                    .View       = GroupParams->ViewMatrix,
+                    .Projection = GroupParams->ProjectionMatrix,
+                };
+
+                ID3D11Buffer *GroupBuffer = D3D11->ChunkBatchUniformBuffer;
+                {
+                    D3D11_MAPPED_SUBRESOURCE Mapped;
+                    Context->lpVtbl->Map(Context, (ID3D11Resource *)GroupBuffer, 0, D3D11_MAP_WRITE_DISCARD, 0, &Mapped);
+                    if (Mapped.pData)
+                    {
+                        memcpy(Mapped.pData, &GroupData, sizeof(d3d11_chunk_batch_data));
+                        Context->lpVtbl->Unmap(Context, (ID3D11Resource *)GroupBuffer, 0);
+                    }
+                }
+
+                Context->lpVtbl->VSSetConstantBuffers(Context, 0, 1, &GroupBuffer);
+
+                for (render_batch_node *BatchNode = GroupNode->BatchList.First; BatchNode != 0; BatchNode = BatchNode->Next)
+                {
+                    tile_batch_params *BatchParams = &BatchNode->Params.Tile;
+
+                    {
+                        renderer_material *Material = AccessUnderlyingResource(BatchParams->Material, Renderer->Resources);
+                        assert(Material);
+
+                        renderer_backend_resource *ColorResource = AccessUnderlyingResource(Material->Maps[MaterialMap_Albedo], Renderer->Resources);
+                        ID3D11ShaderResourceView  *ColorView     = ColorResource ? (ID3D11ShaderResourceView *)ColorResource->Data : 0;
+
+                        Context->lpVtbl->PSSetShaderResources(Context, 0, 1, &ColorView);
+                    }
+
+                    {
+                        d3d11_tile_batch_data BatchData =
+                        {
+                            .Origin       = BatchParams->Origin,
+                            .AtlasColumns = TILE_ATLAS_COLUMNS,
+                        };
+
+                        ID3D11Buffer *UniformBuffer = D3D11->TileBatchUniformBuffer;
+
+                        D3D11_MAPPED_SUBRESOURCE Mapped;
+                        Context->lpVtbl->Map(Context, (ID3D11Resource *)UniformBuffer, 0, D3D11_MAP_WRITE_DISCARD, 0, &Mapped);
+                        if (Mapped.pData)
+                        {
+                            memcpy(Mapped.pData, &BatchData, sizeof(d3d11_tile_batch_data));
+                            Context->lpVtbl->Unmap(Context, (ID3D11Resource *)UniformBuffer, 0);
+                        }
+
+                        Context->lpVtbl->VSSetConstantBuffers(Context, 1, 1, &UniformBuffer);
+                    }
+
+                    {
+                        renderer_buffer *RendererBuffer = GetRendererBufferFromHandle(BatchParams->InstanceBuffer, Renderer->Resources);
+                        assert(RendererBuffer);
+
+                        ID3D11Buffer *InstanceBuffer = (ID3D11Buffer *)RendererBuffer->Backend;
+
+                        UINT32 Stride = sizeof(tile_instance);
+                        UINT32 Offset = 0;
+                        Context->lpVtbl->IASetVertexBuffers(Context, 0, 1, &InstanceBuffer, &Stride, &Offset);
+                    }
+
+                    Context->lpVtbl->DrawIndexedInstanced(Context, 6, (UINT)BatchParams->InstanceCount, 0, 0, 0);
                 }
             }
         } break;
@@ -712,8 +1034,9 @@ RendererLeaveFrame(int Width, int Height, engine_memory *EngineMemory, renderer
         }
     }
 
+    ProfileBegin(Present);
     D3D11->SwapChain->lpVtbl->Present(D3D11->SwapChain, 0, 0);
+    ProfileEnd(Present);
 
-    Renderer->PassList.First = 0;
-    Renderer->PassList.Last  = 0;
+    ProfileEnd(RendererLeaveFrame);
 }
\ No newline at end of file
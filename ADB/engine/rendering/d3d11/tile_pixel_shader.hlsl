@@ -0,0 +1,3 @@
+// Pixel stage of tile_shader.hlsl. FxCompile builds one entry point per file, so this
+// is compiled with /E PS into tile_pixel_shader.h (TilePixelShaderBytes).
+#include "tile_shader.hlsl"
@@ -0,0 +1,65 @@
+struct VS_INPUT
+{
+    uint2 Tile   : TILE;
+    uint  TileID : TILEID;
+    uint  Vertex : SV_VertexID;
+};
+
+struct PS_INPUT
+{
+    float4 Position : SV_POSITION;
+    float2 TexCoord : TEXCOORD0;
+};
+
+
+cbuffer TransformBuffer : register(b0)
+{
+    float4x4 World;
+    float4x4 View;
+    float4x4 Projection;
+};
+
+
+cbuffer TileBuffer : register(b1)
+{
+    float3 Origin;
+    uint   AtlasColumns;
+};
+
+
+// Indexed by the shared quad index buffer {0, 1, 2, 0, 2, 3}, same winding as the
+// CPU-built chunk quads.
+static const float2 TileQuad[4] =
+{
+    float2(0, 0), float2(1, 0), float2(1, 1), float2(0, 1),
+};
+
+
+PS_INPUT VS(VS_INPUT Input)
+{
+    PS_INPUT Output;
+
+    float2 Corner   = TileQuad[Input.Vertex];
+    float3 Position = Origin + float3(float2(Input.Tile) + Corner, 0.0);
+
+    float4 WorldPos = mul(World, float4(Position, 1.0));
+    float4 ViewPos  = mul(View, WorldPos);
+    Output.Position = mul(Projection, ViewPos);
+
+    // The atlas is square: AtlasColumns x AtlasColumns cells, row-major.
+    uint2 Cell = uint2(Input.TileID % AtlasColumns, (Input.TileID / AtlasColumns) % AtlasColumns);
+    Output.TexCoord = (float2(Cell) + Corner) / float(AtlasColumns);
+
+    return Output;
+}
+
+
+Texture2D    AlbedoTexture :  register(t0);
+SamplerState TextureSampler : register(s0);
+
+
+float4 PS(PS_INPUT Input) : SV_TARGET
+{
+    float3 Albedo = AlbedoTexture.Sample(TextureSampler, Input.TexCoord).rgb;
+    return float4(Albedo, 1.f);
+}
@@ -0,0 +1,3 @@
+// Vertex stage of tile_shader.hlsl. FxCompile builds one entry point per file, so this
+// is compiled with /E VS into tile_vertex_shader.h (TileVertexShaderBytes).
+#include "tile_shader.hlsl"
@@ -55,33 +55,28 @@ static gizmo_vertex_data CellTemplate[24] =
 // =====================================================
 
 
-void DrawGizmoCell(vec3 Center, vec3 Color, camera *Camera, renderer *Renderer, memory_arena *Arena)
+void DrawGizmoCell(vec3 Center, vec3 Color, camera *Camera, render_context *Context)
 {
-    if (!Camera || !Renderer || !Arena)
+    if (!Camera || !Context)
     {
         return;
     }
 
-    gizmo_group_params Params =
-    {
-    	.WorldMatrix      = GetCameraWorldMatrix(Camera),
-    	.ViewMatrix       = GetCameraViewMatrix(Camera),
-    	.ProjectionMatrix = GetCameraProjectionMatrix(Camera),
-    };
-
-	render_batch_list *BatchList = PushGizmoGroupParams(&Params, Arena, &Renderer->PassList);
-    if (BatchList)
+    render_group *Group = PushCameraGroupParams(RenderPass_Gizmo, Camera, Context->Arena, &Context->ItemList);
+    if (Group)
     {
         // TODO: Just don't have errors bro. Maybe return some buffer struct?
-        gizmo_vertex_data *Vertices = PushDataInBatchList(Arena, BatchList, ArrayCount(CellTemplate), GIZMO_INSTANCE_PER_BATCH);
-        if (Vertices)
+        gizmo_vertex_packed *Vertices = PushArray(Context->Arena, gizmo_vertex_packed, ArrayCount(CellTemplate));
+        render_item         *Item     = PushRenderItem(RenderPass_Gizmo, Group, 0, RENDER_LAYER_DEFAULT, 0.f, Context->Arena, &Context->ItemList);
+        if (Vertices && Item)
         {
             for (uint32_t Idx = 0; Idx < ArrayCount(CellTemplate); ++Idx)
             {
-                gizmo_vertex_data *Vertex = &Vertices[Idx];
-                Vertex->Color    = Color;
-                Vertex->Position = Vec3Add(CellTemplate[Idx].Position, Center);
+                Vertices[Idx] = PackGizmoVertex(Vec3Add(CellTemplate[Idx].Position, Center), Color);
             }
+
+            Item->Instances     = Vertices;
+            Item->InstanceCount = ArrayCount(CellTemplate);
         }
     }
 }
@@ -93,30 +88,90 @@ void DrawGizmoCell(vec3 Center, vec3 Color, camera *Camera, renderer *Renderer,
 
 
 void
-DrawChunkIntance(resource_handle VertexBuffer, uint32_t VertexCount, resource_handle Material, camera *Camera, renderer *Renderer, memory_arena *Arena)
+DrawChunkIntance(resource_handle VertexBuffer, uint32_t VertexCount, resource_handle IndexBuffer, uint32_t IndexCount, RenderIndex_Type IndexType,
+                 resource_handle Material, vec3 Origin, float Depth, camera *Camera, render_context *Context)
 {
-    if (!Camera || !Renderer || !Arena)
+    if (!Camera || !Context)
     {
         return;
     }
 
-    chunk_group_params Params =
+    render_group *Group = PushCameraGroupParams(RenderPass_Chunk, Camera, Context->Arena, &Context->ItemList);
+    if (Group)
     {
-        .WorldMatrix      = GetCameraWorldMatrix(Camera),
-        .ViewMatrix       = GetCameraViewMatrix(Camera),
-        .ProjectionMatrix = GetCameraProjectionMatrix(Camera),
-    };
+        render_batch_params Batch =
+        {
+            .Chunk.Material     = Material,
+            .Chunk.VertexBuffer = VertexBuffer,
+            .Chunk.VertexCount  = VertexCount,
+            .Chunk.IndexBuffer  = IndexBuffer,
+            .Chunk.IndexCount   = IndexCount,
+            .Chunk.IndexType    = IndexType,
+            .Chunk.Origin       = Origin,
+        };
+
+        PushRenderItem(RenderPass_Chunk, Group, &Batch, RENDER_LAYER_DEFAULT, Depth, Context->Arena, &Context->ItemList);
+    }
+}
+
 
-    render_batch_list *BatchList = PushChunkGroupParams(&Params, Arena, &Renderer->PassList);
-    if(BatchList)
+// 'InstanceBuffer' holds 'InstanceCount' tile_instance records. Tile coordinates are
+// relative to 'Origin'.
+void
+DrawChunkTiles(resource_handle InstanceBuffer, uint32_t InstanceCount, resource_handle Material, vec3 Origin, float Depth, camera *Camera, render_context *Context)
+{
+    if (!Camera || !Context)
+    {
+        return;
+    }
+
+    render_group *Group = PushCameraGroupParams(RenderPass_Tile, Camera, Context->Arena, &Context->ItemList);
+    if (Group)
     {
-        chunk_batch_params BatchParams =
+        render_batch_params Batch =
         {
-            .Material     = Material,
-            .VertexBuffer = VertexBuffer,
-            .VertexCount  = VertexCount,
+            .Tile.InstanceCount  = InstanceCount,
+            .Tile.InstanceBuffer = InstanceBuffer,
+            .Tile.Material       = Material,
+            .Tile.Origin         = Origin,
         };
 
-        PushChunkBatchParams(&BatchParams, CHUNK_INSTANCE_PER_BATCH, Arena, BatchList);
+        PushRenderItem(RenderPass_Tile, Group, &Batch, RENDER_LAYER_DEFAULT, Depth, Context->Arena, &Context->ItemList);
     }
-}
\ No newline at end of file
+}
+
+
+void
+DrawMeshInstance(resource_handle VertexBuffer, resource_handle IndexBuffer, uint32_t IndexCount, RenderIndex_Type IndexType,
+                 resource_handle Material, mat4x4 *World, float Depth, camera *Camera, render_context *Context)
+{
+    if (!Camera || !Context || !World)
+    {
+        return;
+    }
+
+    render_group *Group = PushCameraGroupParams(RenderPass_Mesh, Camera, Context->Arena, &Context->ItemList);
+    if (Group)
+    {
+        render_batch_params Batch =
+        {
+            .Mesh.Material     = Material,
+            .Mesh.VertexBuffer = VertexBuffer,
+            .Mesh.IndexBuffer  = IndexBuffer,
+            .Mesh.IndexCount   = IndexCount,
+            .Mesh.IndexType    = IndexType,
+        };
+
+        mesh_instance *Instance = PushStruct(Context->Arena, mesh_instance);
+        render_item   *Item     = PushRenderItem(RenderPass_Mesh, Group, &Batch, RENDER_LAYER_DEFAULT, Depth, Context->Arena, &Context->ItemList);
+        if (Instance && Item)
+        {
+            Instance->MeshHandle   = VertexBuffer;
+            Instance->SubmeshIndex = 0;
+            Instance->World        = *World;
+
+            Item->Instances     = Instance;
+            Item->InstanceCount = 1;
+        }
+    }
+}
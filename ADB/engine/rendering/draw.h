@@ -4,6 +4,7 @@
 
 #include "resources.h"
 #include <engine/math/vector.h>
+#include <engine/math/matrix.h>
 
 
 // =====================================================
@@ -14,7 +15,7 @@
 typedef struct tile_vertex_data tile_vertex_data;
 typedef struct memory_arena     memory_arena;
 typedef struct camera           camera;
-typedef struct renderer         renderer;
+typedef struct render_context   render_context;
 
 
 // =====================================================
@@ -22,7 +23,7 @@ typedef struct renderer         renderer;
 // =====================================================
 
 
-void DrawGizmoCell  (vec3 Center, vec3 Color, camera *Camera, renderer *Renderer, memory_arena *Arena);
+void DrawGizmoCell  (vec3 Center, vec3 Color, camera *Camera, render_context *Context);
 
 
 // =====================================================
@@ -30,4 +31,21 @@ void DrawGizmoCell  (vec3 Center, vec3 Color, camera *Camera, renderer *Renderer
 // =====================================================
 
 
-void     DrawChunkIntance    (resource_handle VertexBuffer, uint32_t VertexCount, resource_handle Material, camera *Camera, renderer *Renderer, memory_arena *Arena);
\ No newline at end of file
+// 'VertexBuffer' holds tile_vertex_packed relative to 'Origin'. An invalid 'IndexBuffer'
+// (RenderIndex_None) draws 'VertexCount' vertices in order; RenderIndex_Quads needs no
+// index buffer at all.
+void     DrawChunkIntance    (resource_handle VertexBuffer, uint32_t VertexCount, resource_handle IndexBuffer, uint32_t IndexCount, RenderIndex_Type IndexType,
+                              resource_handle Material, vec3 Origin, float Depth, camera *Camera, render_context *Context);
+void     DrawChunkTiles      (resource_handle InstanceBuffer, uint32_t InstanceCount, resource_handle Material, vec3 Origin, float Depth, camera *Camera, render_context *Context);
+
+
+// =====================================================
+// [SECTION] Mesh Draw API
+// =====================================================
+
+
+// 'World' is copied into the instance, so the world matrix of a transform hierarchy
+// node (GetTransformWorldMatrix) can be passed as is. Instances of the same mesh and
+// material drawn with one camera share a batch.
+void     DrawMeshInstance    (resource_handle VertexBuffer, resource_handle IndexBuffer, uint32_t IndexCount, RenderIndex_Type IndexType,
+                              resource_handle Material, mat4x4 *World, float Depth, camera *Camera, render_context *Context);
@@ -15,87 +15,201 @@
 // ==============================================
 
 
+// Ids only need to differ between cameras alive in the same frame. Cameras are
+// created on the main thread, so a plain counter is enough.
+static uint32_t NextCameraId = 1;
+
+
 camera
 CreateCamera(vec3 Position, float FovY, float AspectRatio)
 {
     camera Result =
     {
-        .Position    = Position,
-        .Forward     = Vec3(0.f, 0.f, 1.f),
-        .Up          = Vec3(0.f, 1.f, 0.f),
-        .AspectRatio = AspectRatio,
-        .NearPlane   = 0.1f,
-        .FarPlane    = 1000.f,
-        .FovY        = FovY,
+        .Position      = Position,
+        .Forward       = Vec3(0.f, 0.f, 1.f),
+        .Up            = Vec3(0.f, 1.f, 0.f),
+        .Parent        = Mat4Identity(),
+        .AspectRatio   = AspectRatio,
+        .NearPlane     = 0.1f,
+        .FarPlane      = 1000.f,
+        .FovY          = FovY,
+        .Id            = NextCameraId++,
+        .Version       = 1,
+        .CachedVersion = 0,
     };
 
     return Result;
 }
 
 
-mat4x4
-GetCameraWorldMatrix(camera *Camera)
+void
+MarkCameraDirty(camera *Camera)
 {
-    (void)Camera;
+    ++Camera->Version;
 
-    mat4x4 World = {0};
-    World.c0r0 = 1.f;
-    World.c1r1 = 1.f;
-    World.c2r2 = 1.f;
-    World.c3r3 = 1.f;
+    // Never let the version wrap onto the cached one.
+    if (Camera->Version == Camera->CachedVersion)
+    {
+        ++Camera->Version;
+    }
+}
 
-    return World;
+
+void
+SetCameraPosition(vec3 Position, camera *Camera)
+{
+    if (memcmp(&Camera->Position, &Position, sizeof(vec3)) != 0)
+    {
+        Camera->Position = Position;
+        MarkCameraDirty(Camera);
+    }
 }
 
 
-mat4x4
-GetCameraViewMatrix(camera *Camera)
+void
+SetCameraOrientation(vec3 Forward, vec3 Up, camera *Camera)
+{
+    if (memcmp(&Camera->Forward, &Forward, sizeof(vec3)) != 0 || memcmp(&Camera->Up, &Up, sizeof(vec3)) != 0)
+    {
+        Camera->Forward = Forward;
+        Camera->Up      = Up;
+        MarkCameraDirty(Camera);
+    }
+}
+
+
+void
+SetCameraAspectRatio(float AspectRatio, camera *Camera)
 {
-    mat4x4 View = { 0 };
+    if (Camera->AspectRatio != AspectRatio)
+    {
+        Camera->AspectRatio = AspectRatio;
+        MarkCameraDirty(Camera);
+    }
+}
 
-    vec3 Forward = Vec3Normalize(Camera->Forward);
-    vec3 Right   = Vec3Normalize(Vec3Cross(Camera->Up, Forward));
-    vec3 Up      = Vec3Cross(Forward, Right);
 
-    Camera->Up = Up;
+// Called every frame with the world matrix of a moving node, so an unchanged parent
+// must keep the version, and the groups recorded with it.
+void
+SetCameraParent(mat4x4 Parent, camera *Camera)
+{
+    if (memcmp(&Camera->Parent, &Parent, sizeof(mat4x4)) != 0)
+    {
+        Camera->Parent = Parent;
+        MarkCameraDirty(Camera);
+    }
+}
 
-    View.c0r0 = Right.X;
-    View.c0r1 = Right.Y;
-    View.c0r2 = Right.Z;
-    View.c0r3 = 0.f;
 
-    View.c1r0 = Up.X;
-    View.c1r1 = Up.Y;
-    View.c1r2 = Up.Z;
-    View.c1r3 = 0.f;
+uint64_t
+GetCameraKey(camera *Camera)
+{
+    uint64_t Key = ((uint64_t)Camera->Id << 32) | Camera->Version;
+    return Key;
+}
+
 
-    View.c2r0 = Forward.X;
-    View.c2r1 = Forward.Y;
-    View.c2r2 = Forward.Z;
-    View.c2r3 = 0.f;
+// Gribb-Hartmann: each plane is a sum or difference of the fourth row of the
+// view-projection and one of the others, matching the [-1, 1] clip ranges of
+// Mat4Perspective. Planes are normalized so Offset is a distance.
+static void
+ExtractFrustumPlanes(mat4x4 *M, plane *Planes)
+{
+    float Row0[4] = { M->c0r0, M->c1r0, M->c2r0, M->c3r0 };
+    float Row1[4] = { M->c0r1, M->c1r1, M->c2r1, M->c3r1 };
+    float Row2[4] = { M->c0r2, M->c1r2, M->c2r2, M->c3r2 };
+    float Row3[4] = { M->c0r3, M->c1r3, M->c2r3, M->c3r3 };
 
-    View.c3r0 = -Vec3Dot(Right, Camera->Position);
-    View.c3r1 = -Vec3Dot(Up, Camera->Position);
-    View.c3r2 = -Vec3Dot(Forward, Camera->Position);
-    View.c3r3 = 1.f;
+    float *Rows[3]  = { Row0, Row1, Row2 };
 
-    return View;
+    for (uint32_t Idx = 0; Idx < FrustumPlane_Count; ++Idx)
+    {
+        float *Row  = Rows[Idx / 2];
+        float  Sign = (Idx & 1) ? -1.f : 1.f;
+
+        vec3  Normal = Vec3(Row3[0] + Sign * Row[0], Row3[1] + Sign * Row[1], Row3[2] + Sign * Row[2]);
+        float Offset = Row3[3] + Sign * Row[3];
+        float Length = Vec3Length(Normal);
+
+        if (Length > 0.f)
+        {
+            Normal  = Vec3Scale(Normal, 1.f / Length);
+            Offset /= Length;
+        }
+
+        Planes[Idx].Normal = Normal;
+        Planes[Idx].Offset = Offset;
+    }
+}
+
+
+camera_cache *
+GetCameraCache(camera *Camera)
+{
+    if (Camera->CachedVersion != Camera->Version)
+    {
+        camera_cache *Cache = &Camera->Cache;
+
+        // The orthonormal up stays local: SetCameraOrientation compares against the
+        // caller's up, which must not change behind its back. A scaled parent only
+        // moves the camera, its axes are normalized again.
+        vec3 Position = Mat4TransformPoint(Camera->Parent, Camera->Position);
+        vec3 Forward  = Vec3Normalize(Mat4TransformVector(Camera->Parent, Camera->Forward));
+        vec3 Right    = Vec3Normalize(Vec3Cross(Mat4TransformVector(Camera->Parent, Camera->Up), Forward));
+        vec3 Up       = Vec3Cross(Forward, Right);
+
+        float FovYRadians = Camera->FovY * (3.1416f / 180.0f);
+
+        mat4x4 World =
+        {
+            Right.X,    Right.Y,    Right.Z,    0.f,
+            Up.X,       Up.Y,       Up.Z,       0.f,
+            Forward.X,  Forward.Y,  Forward.Z,  0.f,
+            Position.X, Position.Y, Position.Z, 1.f,
+        };
+
+        Cache->World          = World;
+        Cache->View           = Mat4LookTo(Position, Forward, Up);
+        Cache->Projection     = Mat4Perspective(FovYRadians, Camera->AspectRatio, Camera->NearPlane, Camera->FarPlane);
+        Cache->ViewProjection = Mat4Multiply(Cache->Projection, Cache->View);
+
+        ExtractFrustumPlanes(&Cache->ViewProjection, Cache->Planes);
+
+        Camera->CachedVersion = Camera->Version;
+    }
+
+    return &Camera->Cache;
 }
 
 
 mat4x4
-GetCameraProjectionMatrix(camera *Camera)
+GetCameraWorldMatrix(camera *Camera)
 {
-    mat4x4 Projection = {0};
+    mat4x4 World = GetCameraCache(Camera)->World;
+    return World;
+}
 
-    float FovYRadians = Camera->FovY * (3.1416 / 180.0f);
-    float F           = 1.f / tanf(FovYRadians * 0.5f);
 
-    Projection.c0r0 = F / Camera->AspectRatio;
-    Projection.c1r1 = F;
-    Projection.c2r2 = (Camera->FarPlane + Camera->NearPlane) / (Camera->FarPlane - Camera->NearPlane);
-    Projection.c2r3 = 1.f;
-    Projection.c3r2 = (-2.f * Camera->FarPlane * Camera->NearPlane) / (Camera->FarPlane - Camera->NearPlane);
+mat4x4
+GetCameraViewMatrix(camera *Camera)
+{
+    mat4x4 View = GetCameraCache(Camera)->View;
+    return View;
+}
 
+
+mat4x4
+GetCameraProjectionMatrix(camera *Camera)
+{
+    mat4x4 Projection = GetCameraCache(Camera)->Projection;
     return Projection;
-}
\ No newline at end of file
+}
+
+
+mat4x4
+GetCameraViewProjectionMatrix(camera *Camera)
+{
+    mat4x4 ViewProjection = GetCameraCache(Camera)->ViewProjection;
+    return ViewProjection;
+}
@@ -1,5 +1,7 @@
 #pragma once
 
+#include <stdint.h>
+
 #include "engine/math/matrix.h"
 #include "engine/math/vector.h"
 #include "resources.h"
@@ -10,31 +12,83 @@
 // =====================================================
 
 
-typedef struct renderer      renderer;
-typedef struct engine_memory engine_memory;
+typedef struct renderer             renderer;
+typedef struct render_context       render_context;
+typedef struct render_retained_list render_retained_list;
+typedef struct engine_memory        engine_memory;
+typedef struct memory_arena         memory_arena;
 
 
 // =====================================================
 // Camera (likely scene-level later)
 // =====================================================
 
+// Matrices and frustum planes are cached and only rebuilt when the version changes.
+// The setters bump the version; code writing the fields directly must call
+// MarkCameraDirty. Draws identify a camera state by its key (Id and Version), so two
+// draws share a group exactly when their keys are equal.
+//
+// Position, Forward and Up are relative to Parent, identity unless the camera is
+// attached to a node of a transform hierarchy with SetCameraParent after
+// UpdateTransforms. The cached World is the camera's own frame in world space:
+// right, up, forward and position as its columns.
+
+typedef enum FrustumPlane_Type
+{
+    FrustumPlane_Left   = 0,
+    FrustumPlane_Right  = 1,
+    FrustumPlane_Bottom = 2,
+    FrustumPlane_Top    = 3,
+    FrustumPlane_Near   = 4,
+    FrustumPlane_Far    = 5,
+    FrustumPlane_Count  = 6,
+} FrustumPlane_Type;
+
+typedef struct
+{
+    mat4x4 World;
+    mat4x4 View;
+    mat4x4 Projection;
+    mat4x4 ViewProjection;
+
+    // World space, normals pointing inside.
+    plane Planes[FrustumPlane_Count];
+} camera_cache;
+
 typedef struct camera
 {
     vec3 Position;
     vec3 Forward;
     vec3 Up;
 
+    mat4x4 Parent;
+
     float FovY;
     float AspectRatio;
     float NearPlane;
     float FarPlane;
+
+    uint32_t     Id;
+    uint32_t     Version;
+    uint32_t     CachedVersion;
+    camera_cache Cache;
 } camera;
 
 camera CreateCamera(vec3 Position, float FovY, float AspectRatio);
 
+void   SetCameraPosition        (vec3 Position, camera *Camera);
+void   SetCameraOrientation     (vec3 Forward, vec3 Up, camera *Camera);
+void   SetCameraAspectRatio     (float AspectRatio, camera *Camera);
+void   SetCameraParent          (mat4x4 Parent, camera *Camera);
+void   MarkCameraDirty          (camera *Camera);
+
+uint64_t       GetCameraKey     (camera *Camera);
+camera_cache * GetCameraCache   (camera *Camera);
+
 mat4x4 GetCameraWorldMatrix(camera *Camera);
 mat4x4 GetCameraViewMatrix(camera *Camera);
 mat4x4 GetCameraProjectionMatrix(camera *Camera);
+mat4x4 GetCameraViewProjectionMatrix(camera *Camera);
 
 
 // =====================================================
@@ -48,3 +102,51 @@ typedef struct
 
 void RendererEnterFrame  (clear_color Color, renderer *Renderer);
 void RendererLeaveFrame  (int Width, int Height, engine_memory *EngineMemory, renderer *Renderer);
+
+
+// =====================================================
+// Render Contexts
+// [DESCRIP]
+//   Draws are recorded into a context, each with its own
+//   item list and arena, so several threads can record
+//   at once. RendererLeaveFrame merges the contexts in
+//   slot order before sorting. Slot 0 belongs to the main
+//   thread; jobs should pick slots from their work index
+//   (not their thread) to keep frames deterministic.
+//
+//   A slot must be used by one thread at a time, and the
+//   cameras drawn with must be up to date (see
+//   GetCameraCache) before recording starts.
+// =====================================================
+
+#define RENDER_MAX_CONTEXTS 64
+
+render_context * GetRenderContext (uint32_t Slot, renderer *Renderer);
+
+
+// =====================================================
+// Retained Lists
+// [DESCRIP]
+//   Static draws are recorded once into a retained list
+//   and submitted by reference every frame: submitting
+//   costs a few pointer writes per pass, whatever the
+//   number of draws. The camera matrices come from the
+//   camera the list is submitted with; the camera used
+//   while recording only decides the depth order.
+//
+//   BeginRetainedList returns a context to record into
+//   when the list is empty, was invalidated, or 'Version'
+//   differs from the one it was built with (derive it
+//   from whatever the draws depend on). Otherwise it
+//   returns NULL and the list is kept as is.
+// =====================================================
+
+#define RENDER_MAX_RETAINED_LISTS 256
+
+render_retained_list * CreateRetainedList       (memory_arena *Arena);
+render_context       * BeginRetainedList        (uint64_t Version, render_retained_list *List);
+void                   EndRetainedList          (render_retained_list *List);
+void                   InvalidateRetainedList   (render_retained_list *List);
+
+// Once per frame and list, between RendererEnterFrame and RendererLeaveFrame.
+void                   SubmitRetainedList       (camera *Camera, render_retained_list *List, renderer *Renderer);
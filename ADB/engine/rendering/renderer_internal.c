@@ -1,9 +1,13 @@
 #include "renderer_internal.h"
+#include "renderer.h"
 
 #include <assert.h>
 #include <string.h>
 #include <stdbool.h>
 
+#include "utilities.h"
+#include "engine/profiler/profiler.h"
+
 // ==============================================
 // Drawing & Batching
 // ==============================================
@@ -200,7 +204,7 @@ AppendNewRenderBatch(memory_arena *Arena, render_batch_list *BatchList, uint64_t
 // TODO: I think we might need safeguards here. Because we could push an instance count higher than the instance per batch
 // which would be a OOB write.
 
-void *
+static void *
 PushDataInBatchList(memory_arena *Arena, render_batch_list *BatchList, uint32_t InstanceCount, uint64_t InstancePerBatch)
 {
     void *Result = 0;
@@ -214,7 +218,7 @@ PushDataInBatchList(memory_arena *Arena, render_batch_list *BatchList, uint32_t
 
         if (NewNode && Node)
         {
-            NewNode->Params.Mesh = Node->Params.Mesh;
+            NewNode->Params = Node->Params;
         }
 
         Node = NewNode;
@@ -230,18 +234,16 @@ PushDataInBatchList(memory_arena *Arena, render_batch_list *BatchList, uint32_t
     return Result;
 }
 
+
 static render_group_node *
-GetGroupNode(bool ParametersDoNotMatch, memory_arena *Arena, render_pass *Pass, render_pass_list *PassList)
+AppendNewRenderGroup(memory_arena *Arena, render_pass *Pass)
 {
     assert(Arena);
     assert(Pass);
-    assert(PassList);
-
-    render_group_node *Result = Pass->Last;
 
-    if (!Result || ParametersDoNotMatch)
+    render_group_node *Result = PushStruct(Arena, render_group_node);
+    if (Result)
     {
-        Result = PushStruct(Arena, render_group_node);
         Result->Next                 = 0;
         Result->BatchList.BatchCount = 0;
         Result->BatchList.First      = 0;
@@ -267,129 +269,955 @@ GetGroupNode(bool ParametersDoNotMatch, memory_arena *Arena, render_pass *Pass,
 }
 
 
-render_batch_list *
-PushMeshGroupParams(mesh_group_params *Params, memory_arena *Arena, render_pass_list *PassList)
+static void
+PushBatchParams(render_batch_params *Params, uint64_t ParamsSize, uint64_t InstancePerBatch, memory_arena *Arena, render_batch_list *BatchList)
+{
+    render_batch_node *Batch = BatchList->Last;
+
+    if (!Batch || memcmp(&Batch->Params, Params, ParamsSize) != 0)
+    {
+        Batch = AppendNewRenderBatch(Arena, BatchList, InstancePerBatch);
+        if (Batch)
+        {
+            Batch->Params = *Params;
+        }
+    }
+}
+
+// =====================================================
+// [SECTION] Packed Vertex Formats
+// =====================================================
+
+
+static float
+ClampUnit(float Value)
+{
+    float Result = Value < 0.f ? 0.f : (Value > 1.f ? 1.f : Value);
+    return Result;
+}
+
+
+// Round to nearest: the error is at most half a step, 1 / (2 * MaxValue).
+static uint32_t
+QuantizeUnorm(float Value, uint32_t MaxValue)
+{
+    uint32_t Result = (uint32_t)(ClampUnit(Value) * (float)MaxValue + 0.5f);
+    return Result;
+}
+
+
+static uint32_t
+QuantizeInteger(float Value, uint32_t MaxValue)
+{
+    float    Clamped = Value < 0.f ? 0.f : (Value > (float)MaxValue ? (float)MaxValue : Value);
+    uint32_t Result  = (uint32_t)(Clamped + 0.5f);
+
+    return Result;
+}
+
+
+tile_vertex_packed
+PackTileVertex(vec3 LocalPosition, vec2 UV, uint8_t TileID)
 {
-    render_batch_list *Result = 0;
+    tile_vertex_packed Result =
+    {
+        .X      = (uint8_t)QuantizeInteger(LocalPosition.X, 0xFF),
+        .Y      = (uint8_t)QuantizeInteger(LocalPosition.Y, 0xFF),
+        .Z      = (uint8_t)QuantizeInteger(LocalPosition.Z, 0xFF),
+        .TileID = TileID,
+        .U      = (uint16_t)QuantizeInteger(UV.X, 0xFFFF),
+        .V      = (uint16_t)QuantizeInteger(UV.Y, 0xFFFF),
+    };
+
+    return Result;
+}
+
 
-    render_pass *Pass = GetRenderPass(Arena, RenderPass_Mesh, PassList);
-    if (Pass)
+// Byte order R, G, B, A to match DXGI_FORMAT_R8G8B8A8_UNORM. Alpha is opaque.
+gizmo_vertex_packed
+PackGizmoVertex(vec3 Position, vec3 Color)
+{
+    gizmo_vertex_packed Result =
     {
-        bool               SameParameters = Pass->Last ? (memcmp(&Pass->Last->Params.Mesh, Params, sizeof(mesh_group_params)) == 0) : false;
-        render_group_node *GroupNode      = GetGroupNode(SameParameters, Arena, Pass, PassList);
+        .Position = Position,
+        .Color    = (QuantizeUnorm(Color.X, 0xFF) <<  0) |
+                    (QuantizeUnorm(Color.Y, 0xFF) <<  8) |
+                    (QuantizeUnorm(Color.Z, 0xFF) << 16) |
+                    (0xFFu                        << 24),
+    };
+
+    return Result;
+}
 
-        GroupNode->BatchList.BytesPerInstance = sizeof(mesh_instance);
 
-        Result = &GroupNode->BatchList;
+// =====================================================
+// [SECTION] Render Items
+// =====================================================
+
+
+typedef struct
+{
+    uint8_t  Order;
+    uint64_t BytesPerInstance;
+    uint64_t InstancePerBatch;
+    uint64_t BatchParamsSize;
+} render_pass_info;
+
+
+// Order is the drawing order: opaque world first, overlays last.
+static render_pass_info PassInfo[RenderPass_Count] =
+{
+    [RenderPass_Chunk] = { .Order = 1, .BytesPerInstance = 0,                           .InstancePerBatch = CHUNK_INSTANCE_PER_BATCH, .BatchParamsSize = sizeof(chunk_batch_params) },
+    [RenderPass_Tile]  = { .Order = 2, .BytesPerInstance = 0,                           .InstancePerBatch = TILE_INSTANCE_PER_BATCH,  .BatchParamsSize = sizeof(tile_batch_params)  },
+    [RenderPass_Mesh]  = { .Order = 3, .BytesPerInstance = sizeof(mesh_instance),       .InstancePerBatch = MESH_INSTANCE_PER_BATCH,  .BatchParamsSize = sizeof(mesh_batch_params)  },
+    [RenderPass_Gizmo] = { .Order = 4, .BytesPerInstance = sizeof(gizmo_vertex_packed), .InstancePerBatch = GIZMO_INSTANCE_PER_BATCH, .BatchParamsSize = 0                          },
+    [RenderPass_UI]    = { .Order = 5, .BytesPerInstance = sizeof(ui_vertex_data),      .InstancePerBatch = UI_INSTANCE_PER_BATCH,    .BatchParamsSize = sizeof(ui_batch_params)    },
+};
+
+
+// Passes whose groups only hold a camera block (mesh, gizmo, chunk and tile group
+// params share their layout).
+static bool
+IsCameraPass(RenderPass_Type Pass)
+{
+    bool Result = Pass == RenderPass_Mesh || Pass == RenderPass_Gizmo || Pass == RenderPass_Chunk || Pass == RenderPass_Tile;
+    return Result;
+}
+
+
+#define RENDER_PARAMS_TABLE_MIN_SIZE 256
+
+
+static uint64_t
+HashRenderParams(RenderPass_Type Pass, void *Params, uint64_t ParamsSize)
+{
+    uint64_t Result = HashByteString(ByteString((uint8_t *)Params, ParamsSize));
+    Result ^= (uint64_t)Pass * 0x9E3779B97F4A7C15ULL;
+
+    // FNV-1a leaves the low bits (the slot index) poorly mixed for parameters that
+    // only differ by a counter, like vertex buffer handles.
+    Result ^= Result >> 33;
+    Result *= 0xFF51AFD7ED558CCDULL;
+    Result ^= Result >> 33;
+
+    return Result ? Result : 1;
+}
+
+
+// Returns the slot holding matching parameters, or the empty slot where they belong.
+// The table is grown first so it stays at most half full.
+static render_params_slot *
+FindRenderParamsSlot(render_params_table *Table, uint64_t Hash, RenderPass_Type Pass, void *Params, uint64_t ParamsSize, memory_arena *Arena)
+{
+    uint32_t Capacity = Table->Slots ? Table->Mask + 1 : 0;
+
+    if ((Table->Count + 1) * 2 > Capacity)
+    {
+        uint32_t            NewCapacity = Capacity ? Capacity * 2 : RENDER_PARAMS_TABLE_MIN_SIZE;
+        render_params_slot *NewSlots    = PushArray(Arena, render_params_slot, NewCapacity);
+        if (!NewSlots)
+        {
+            return NULL;
+        }
+
+        memset(NewSlots, 0, NewCapacity * sizeof(render_params_slot));
+
+        for (uint32_t Idx = 0; Idx < Capacity; ++Idx)
+        {
+            render_params_slot *Old = &Table->Slots[Idx];
+            if (Old->Hash)
+            {
+                uint32_t Target = (uint32_t)Old->Hash & (NewCapacity - 1);
+                while (NewSlots[Target].Hash)
+                {
+                    Target = (Target + 1) & (NewCapacity - 1);
+                }
+
+                NewSlots[Target] = *Old;
+            }
+        }
+
+        Table->Slots = NewSlots;
+        Table->Mask  = NewCapacity - 1;
+    }
+
+    uint32_t Index = (uint32_t)Hash & Table->Mask;
+
+    while (true)
+    {
+        render_params_slot *Slot = &Table->Slots[Index];
+
+        if (!Slot->Hash || (Slot->Hash == Hash && Slot->Pass == Pass && memcmp(Slot->Value, Params, ParamsSize) == 0))
+        {
+            return Slot;
+        }
+
+        Index = (Index + 1) & Table->Mask;
+    }
+}
+
+
+static render_group *
+AllocateRenderGroup(RenderPass_Type Pass, memory_arena *Arena, render_item_list *ItemList)
+{
+    render_group *Result = PushStruct(Arena, render_group);
+    if (Result)
+    {
+        Result->Pass              = Pass;
+        Result->Index             = ItemList->GroupCount++;
+        Result->Canonical         = 0;
+        ItemList->LastGroup[Pass] = Result;
     }
 
     return Result;
 }
 
 
-void
-PushMeshBatchParams(mesh_batch_params *Params, uint64_t InstancePerBatch, memory_arena *Arena, render_batch_list *BatchList)
+static render_group *
+FindOrAddRenderGroup(RenderPass_Type Pass, render_group_params *Params, uint64_t ParamsSize, memory_arena *Arena, render_item_list *ItemList)
 {
-    render_batch_node *Batch = BatchList->Last;
-    if (!Batch || memcmp(&Batch->Params.Mesh, Params, sizeof(mesh_batch_params) != 0))
+    uint64_t            Hash = HashRenderParams(Pass, Params, ParamsSize);
+    render_params_slot *Slot = FindRenderParamsSlot(&ItemList->Groups, Hash, Pass, Params, ParamsSize, Arena);
+    if (!Slot)
     {
-        Batch = AppendNewRenderBatch(Arena, BatchList, InstancePerBatch);
-        if (Batch)
+        return NULL;
+    }
+
+    if (!Slot->Hash)
+    {
+        render_group *Group = AllocateRenderGroup(Pass, Arena, ItemList);
+        if (!Group)
         {
-            Batch->Params.Mesh = *Params;
+            return NULL;
         }
+
+        Group->Params = *Params;
+
+        Slot->Hash  = Hash;
+        Slot->Pass  = Pass;
+        Slot->Value = Group;
+
+        ItemList->Groups.Count += 1;
     }
+
+    render_group *Result = Slot->Value;
+    ItemList->LastGroup[Pass] = Result;
+
+    return Result;
 }
 
 
-render_batch_list *
-PushUIGroupParams(ui_group_params *Params, memory_arena *Arena, render_pass_list *PassList)
+// Batch indices start at 1; 0 is left to items without batch parameters.
+struct render_batch_entry
+{
+    render_batch_params  Params;
+    uint32_t             Index;
+    render_batch_entry  *Canonical;
+};
+
+
+static render_batch_entry *
+FindOrAddRenderBatch(RenderPass_Type Pass, render_batch_params *Params, uint64_t ParamsSize, memory_arena *Arena, render_item_list *ItemList)
 {
-    render_batch_list *Result = 0;
+    uint64_t            Hash = HashRenderParams(Pass, Params, ParamsSize);
+    render_params_slot *Slot = FindRenderParamsSlot(&ItemList->Batches, Hash, Pass, Params, ParamsSize, Arena);
+    if (!Slot)
+    {
+        return NULL;
+    }
 
-    render_pass *Pass = GetRenderPass(Arena, RenderPass_UI, PassList);
-    if (Pass)
+    if (!Slot->Hash)
     {
-        bool               SameParameters = Pass->Last ? (memcmp(&Pass->Last->Params.UI, Params, sizeof(ui_group_params)) == 0) : false;
-        render_group_node *GroupNode      = GetGroupNode(SameParameters, Arena, Pass, PassList);
+        render_batch_entry *Entry = PushStruct(Arena, render_batch_entry);
+        if (!Entry)
+        {
+            return NULL;
+        }
+
+        Entry->Params    = *Params;
+        Entry->Index     = ++ItemList->BatchCount;
+        Entry->Canonical = 0;
 
-        GroupNode->BatchList.BytesPerInstance = sizeof(ui_vertex_data);
-        GroupNode->Params.UI                  = *Params;
+        Slot->Hash  = Hash;
+        Slot->Pass  = Pass;
+        Slot->Value = Entry;
 
-        Result = &GroupNode->BatchList;
+        ItemList->Batches.Count += 1;
     }
 
+    render_batch_entry *Result = Slot->Value;
+
     return Result;
 }
 
-void
-PushUIBatchParams(ui_batch_params *Params, uint64_t InstancePerBatch, memory_arena *Arena, render_batch_list *BatchList)
+
+render_group *
+PushCameraGroupParams(RenderPass_Type Pass, camera *Camera, memory_arena *Arena, render_item_list *ItemList)
 {
-    render_batch_node *Batch = BatchList->Last;
+    assert(IsCameraPass(Pass));
+
+    // Camera group params share their layout, so any member can be used to read and
+    // write the camera block.
+    uint64_t      CameraKey = GetCameraKey(Camera);
+    render_group *Result    = ItemList->LastGroup[Pass];
 
-    if (!Batch || memcmp(&Batch->Params.UI, Params, sizeof(mesh_batch_params) != 0))
+    if (!Result || Result->Params.Chunk.CameraKey != CameraKey)
     {
-        Batch = AppendNewRenderBatch(Arena, BatchList, InstancePerBatch);
-        if (Batch)
+        camera_cache        *Cache  = GetCameraCache(Camera);
+        render_group_params  Params = {0};
+
+        // Chunks and tiles are built in world space, and mesh instances carry their
+        // own world matrix, so the group's model matrix is left at identity. The
+        // camera's own frame (Cache->World) is not a model matrix.
+        Params.Chunk.CameraKey        = CameraKey;
+        Params.Chunk.WorldMatrix      = Mat4Identity();
+        Params.Chunk.ViewMatrix       = Cache->View;
+        Params.Chunk.ProjectionMatrix = Cache->Projection;
+
+        Result = FindOrAddRenderGroup(Pass, &Params, sizeof(chunk_group_params), Arena, ItemList);
+    }
+
+    return Result;
+}
+
+
+render_group *
+PushUIGroupParams(ui_group_params *Params, memory_arena *Arena, render_item_list *ItemList)
+{
+    render_group *Result = ItemList->LastGroup[RenderPass_UI];
+
+    if (!Result || memcmp(&Result->Params.UI, Params, sizeof(ui_group_params)) != 0)
+    {
+        Result = AllocateRenderGroup(RenderPass_UI, Arena, ItemList);
+        if (Result)
         {
-            Batch->Params.UI = *Params;
+            Result->Params.UI = *Params;
         }
     }
+
+    return Result;
+}
+
+
+#define RENDER_KEY_GROUP_SHIFT 44
+#define RENDER_KEY_GROUP_MASK  0xFFFull
+#define RENDER_KEY_BATCH_MASK  0xFFFFull
+
+
+// Group and batch indices wrap in the key. Wrapped indices still draw correctly, they
+// only stop sorting apart from the indices sharing their low bits.
+static uint64_t
+MakeRenderKey(RenderPass_Type Pass, uint32_t Layer, uint32_t Group, uint32_t Material, float Depth, uint32_t Batch)
+{
+    float    Clamped        = Depth < 0.f ? 0.f : (Depth > 1.f ? 1.f : Depth);
+    uint64_t QuantizedDepth = (uint64_t)(Clamped * 65535.f);
+
+    uint64_t Result = ((uint64_t)(PassInfo[Pass].Order & 0xF) << 60) |
+                      ((uint64_t)(Layer            & 0xF) << 56) |
+                      ((Group & RENDER_KEY_GROUP_MASK) << RENDER_KEY_GROUP_SHIFT) |
+                      ((uint64_t)(Material       & 0xFFF) << 32) |
+                      (QuantizedDepth                     << 16) |
+                      (Batch & RENDER_KEY_BATCH_MASK);
+
+    return Result;
+}
+
+
+// Only the order-independent passes put batch state into the key.
+static render_batch_entry *
+GetRenderBatchEntry(RenderPass_Type Pass, render_batch_params *Batch, memory_arena *Arena, render_item_list *ItemList)
+{
+    render_batch_entry *Result = 0;
+
+    if (Pass == RenderPass_Chunk)
+    {
+        Result = FindOrAddRenderBatch(Pass, Batch, sizeof(chunk_batch_params), Arena, ItemList);
+    }
+    else if (Pass == RenderPass_Tile)
+    {
+        Result = FindOrAddRenderBatch(Pass, Batch, sizeof(tile_batch_params), Arena, ItemList);
+    }
+    else if (Pass == RenderPass_Mesh)
+    {
+        Result = FindOrAddRenderBatch(Pass, Batch, sizeof(mesh_batch_params), Arena, ItemList);
+    }
+
+    return Result;
 }
 
 
-render_batch_list *
-PushGizmoGroupParams(gizmo_group_params *Params, memory_arena *Arena, render_pass_list *PassList)
+render_item *
+PushRenderItem(RenderPass_Type Pass, render_group *Group, render_batch_params *Batch, uint32_t Layer, float Depth,
+               memory_arena *Arena, render_item_list *ItemList)
 {
-    render_batch_list *Result = 0;
+    assert(Pass > RenderPass_None && Pass < RenderPass_Count);
+    assert(Group);
 
-    render_pass *Pass = GetRenderPass(Arena, RenderPass_Gizmo, PassList);
-    if (Pass)
+    render_item_block *Block = ItemList->Last;
+    if (!Block || Block->Count == RENDER_ITEMS_PER_BLOCK)
     {
-        bool               SameParameters = Pass->Last ? (memcmp(&Pass->Last->Params.Gizmo, Params, sizeof(gizmo_group_params)) == 0) : false;
-        render_group_node *GroupNode      = GetGroupNode(SameParameters, Arena, Pass, PassList);
+        Block = PushStruct(Arena, render_item_block);
+        if (!Block)
+        {
+            return NULL;
+        }
+
+        Block->Next  = 0;
+        Block->Count = 0;
 
-        GroupNode->BatchList.BytesPerInstance = sizeof(gizmo_vertex_data);
-        GroupNode->Params.Gizmo               = *Params;
+        if (ItemList->Last)
+        {
+            ItemList->Last->Next = Block;
+        }
+        else
+        {
+            ItemList->First = Block;
+        }
 
-        Result = &GroupNode->BatchList;
+        ItemList->Last = Block;
     }
 
+    uint32_t Material   = 0;
+    render_batch_entry *BatchEntry = Batch ? GetRenderBatchEntry(Pass, Batch, Arena, ItemList) : 0;
+
+    if (Batch && Pass == RenderPass_Chunk)
+    {
+        Material = Batch->Chunk.Material.Value;
+    }
+    else if (Batch && Pass == RenderPass_Tile)
+    {
+        Material = Batch->Tile.Material.Value;
+    }
+    else if (Batch && Pass == RenderPass_Mesh)
+    {
+        Material = Batch->Mesh.Material.Value;
+    }
+
+    // Instances of one batch go out in a single draw, so depth cannot order them: for
+    // the instanced passes it would only split batches apart.
+    if (PassInfo[Pass].BatchParamsSize && PassInfo[Pass].BytesPerInstance)
+    {
+        Depth = 0.f;
+    }
+
+    render_item *Result = &Block->Items[Block->Count++];
+    Result->Key           = MakeRenderKey(Pass, Layer, Group->Index, Material, Depth, BatchEntry ? BatchEntry->Index : 0);
+    Result->Pass          = Pass;
+    Result->InstanceCount = 0;
+    Result->Group         = Group;
+    Result->BatchEntry    = BatchEntry;
+    Result->Instances     = 0;
+
+    if (Batch)
+    {
+        Result->Batch = *Batch;
+    }
+    else
+    {
+        memset(&Result->Batch, 0, sizeof(render_batch_params));
+    }
+
+    // What merging with the previous draw of the pass would have cost.
+    render_item *Previous = ItemList->LastItem[Pass];
+    if (!Previous || Previous->Group != Group)
+    {
+        ItemList->Stats.GroupsSubmitted  += 1;
+        ItemList->Stats.BatchesSubmitted += 1;
+    }
+    else if (PassInfo[Pass].BatchParamsSize && memcmp(&Previous->Batch, &Result->Batch, PassInfo[Pass].BatchParamsSize) != 0)
+    {
+        ItemList->Stats.BatchesSubmitted += 1;
+    }
+
+    ItemList->LastItem[Pass]  = Result;
+    ItemList->Count          += 1;
+    ItemList->Stats.Items    += 1;
+
     return Result;
 }
 
 
-render_batch_list *
-PushChunkGroupParams(chunk_group_params *Params, memory_arena *Arena, render_pass_list *PassList)
+// Items keep their submission order, after the items already in 'Into'. Groups and
+// batch entries are resolved once each through 'Canonical': camera groups and batches
+// against the frame tables, UI groups as new groups so they keep their relative order.
+static void
+MergeRenderItemList(render_item_list *Into, render_item_list *From, memory_arena *Arena)
 {
-    render_batch_list *Result = 0;
+    for (render_item_block *Block = From->First; Block != 0; Block = Block->Next)
+    {
+        for (uint32_t Idx = 0; Idx < Block->Count; ++Idx)
+        {
+            render_item  *Item  = &Block->Items[Idx];
+            render_group *Group = Item->Group;
 
-    render_pass *Pass = GetRenderPass(Arena, RenderPass_Chunk, PassList);
-    if (Pass)
+            if (!Group->Canonical)
+            {
+                if (!IsCameraPass(Group->Pass))
+                {
+                    Group->Canonical = AllocateRenderGroup(Group->Pass, Arena, Into);
+                    if (Group->Canonical)
+                    {
+                        Group->Canonical->Params = Group->Params;
+                    }
+                }
+                else
+                {
+                    Group->Canonical = FindOrAddRenderGroup(Group->Pass, &Group->Params, sizeof(chunk_group_params), Arena, Into);
+                }
+
+                if (!Group->Canonical)
+                {
+                    Group->Canonical = Group;
+                }
+            }
+
+            uint32_t BatchIndex = 0;
+
+            if (Item->BatchEntry)
+            {
+                render_batch_entry *Entry = Item->BatchEntry;
+                if (!Entry->Canonical)
+                {
+                    Entry->Canonical = GetRenderBatchEntry(Item->Pass, &Entry->Params, Arena, Into);
+                    if (!Entry->Canonical)
+                    {
+                        Entry->Canonical = Entry;
+                    }
+                }
+
+                Item->BatchEntry = Entry->Canonical;
+                BatchIndex       = Item->BatchEntry->Index;
+            }
+
+            Item->Group = Group->Canonical;
+            Item->Key   = (Item->Key & ~((RENDER_KEY_GROUP_MASK << RENDER_KEY_GROUP_SHIFT) | RENDER_KEY_BATCH_MASK)) |
+                          (((uint64_t)Item->Group->Index & RENDER_KEY_GROUP_MASK) << RENDER_KEY_GROUP_SHIFT) |
+                          (BatchIndex & RENDER_KEY_BATCH_MASK);
+        }
+    }
+
+    if (From->First)
+    {
+        if (Into->Last)
+        {
+            Into->Last->Next = From->First;
+        }
+        else
+        {
+            Into->First = From->First;
+        }
+
+        Into->Last = From->Last;
+    }
+
+    Into->Count                  += From->Count;
+    Into->Stats.Items            += From->Stats.Items;
+    Into->Stats.GroupsSubmitted  += From->Stats.GroupsSubmitted;
+    Into->Stats.BatchesSubmitted += From->Stats.BatchesSubmitted;
+}
+
+
+render_context *
+GetRenderContext(uint32_t Slot, renderer *Renderer)
+{
+    assert(Slot < RENDER_MAX_CONTEXTS);
+
+    render_context *Result = &Renderer->Contexts[Slot];
+
+    if (!Result->Arena)
+    {
+        memory_arena_params Params =
+        {
+            .AllocatedFromFile = __FILE__,
+            .AllocatedFromLine = __LINE__,
+            .ReserveSize       = MiB(64),
+            .CommitSize        = MiB(1),
+        };
+
+        Result->Arena = AllocateArena(Params);
+    }
+
+    return Result;
+}
+
+
+// LSD radix sort on 8-bit digits, carrying the item pointers along. All eight
+// histograms come from one read of the keys, and digits where every key lands in
+// the same bucket are skipped: with few passes, layers and groups per frame, most of
+// the high digits are.
+static void
+RadixSortRenderItems(uint64_t *Keys, render_item **Items, uint32_t Count, memory_arena *Arena)
+{
+    uint64_t     *KeysTemp  = PushArray(Arena, uint64_t, Count);
+    render_item **ItemsTemp = PushArray(Arena, render_item *, Count);
+    if (!KeysTemp || !ItemsTemp)
+    {
+        return;
+    }
+
+    uint32_t Histogram[8][256];
+    memset(Histogram, 0, sizeof(Histogram));
+
+    for (uint32_t Idx = 0; Idx < Count; ++Idx)
+    {
+        uint64_t Key = Keys[Idx];
+
+        for (uint32_t Digit = 0; Digit < 8; ++Digit)
+        {
+            Histogram[Digit][(Key >> (8 * Digit)) & 0xFF] += 1;
+        }
+    }
+
+    uint64_t     *SourceKeys  = Keys;
+    render_item **SourceItems = Items;
+    uint64_t     *DestKeys    = KeysTemp;
+    render_item **DestItems   = ItemsTemp;
+
+    for (uint32_t Digit = 0; Digit < 8; ++Digit)
+    {
+        uint32_t *Counts = Histogram[Digit];
+        uint32_t  Shift  = 8 * Digit;
+
+        if (Counts[(SourceKeys[0] >> Shift) & 0xFF] == Count)
+        {
+            continue;
+        }
+
+        uint32_t Offsets[256];
+        uint32_t Total = 0;
+        for (uint32_t Bucket = 0; Bucket < 256; ++Bucket)
+        {
+            Offsets[Bucket] = Total;
+            Total          += Counts[Bucket];
+        }
+
+        for (uint32_t Idx = 0; Idx < Count; ++Idx)
+        {
+            uint64_t Key    = SourceKeys[Idx];
+            uint32_t Target = Offsets[(Key >> Shift) & 0xFF]++;
+
+            DestKeys[Target]  = Key;
+            DestItems[Target] = SourceItems[Idx];
+        }
+
+        uint64_t     *SwapKeys  = SourceKeys;
+        render_item **SwapItems = SourceItems;
+
+        SourceKeys  = DestKeys;
+        SourceItems = DestItems;
+        DestKeys    = SwapKeys;
+        DestItems   = SwapItems;
+    }
+
+    if (SourceKeys != Keys)
+    {
+        memcpy(Keys, SourceKeys, Count * sizeof(uint64_t));
+        memcpy(Items, SourceItems, Count * sizeof(render_item *));
+    }
+}
+
+
+render_pass_list
+BuildRenderPassList(render_context *Contexts, uint32_t ContextCount, render_stats *Stats, memory_arena *Arena)
+{
+    ProfileBegin(BuildRenderPassList);
+
+    assert(ContextCount > 0);
+
+    render_item_list *ItemList = &Contexts[0].ItemList;
+    for (uint32_t Idx = 1; Idx < ContextCount; ++Idx)
+    {
+        MergeRenderItemList(ItemList, &Contexts[Idx].ItemList, Arena);
+    }
+
+    render_pass_list Result = {0};
+    uint32_t         Count  = ItemList->Count;
+
+    uint64_t     *Keys  = Count ? PushArray(Arena, uint64_t, Count) : 0;
+    render_item **Items = Count ? PushArray(Arena, render_item *, Count) : 0;
+
+    if (Keys && Items)
+    {
+        uint32_t Gathered = 0;
+        for (render_item_block *Block = ItemList->First; Block != 0; Block = Block->Next)
+        {
+            for (uint32_t Idx = 0; Idx < Block->Count; ++Idx, ++Gathered)
+            {
+                Keys[Gathered]  = Block->Items[Idx].Key;
+                Items[Gathered] = &Block->Items[Idx];
+            }
+        }
+
+        assert(Gathered == Count);
+
+        RadixSortRenderItems(Keys, Items, Count, Arena);
+
+        render_pass       *Pass         = 0;
+        render_group      *CurrentGroup = 0;
+        render_group_node *GroupNode    = 0;
+
+        for (uint32_t Idx = 0; Idx < Count; ++Idx)
+        {
+            render_item      *Item = Items[Idx];
+            render_pass_info *Info = &PassInfo[Item->Pass];
+
+            if (!Pass || Pass->Type != Item->Pass)
+            {
+                Pass         = GetRenderPass(Arena, Item->Pass, &Result);
+                CurrentGroup = 0;
+            }
+
+            if (!Pass)
+            {
+                break;
+            }
+
+            if (Item->Group != CurrentGroup)
+            {
+                GroupNode = AppendNewRenderGroup(Arena, Pass);
+                if (!GroupNode)
+                {
+                    break;
+                }
+
+                GroupNode->Params                     = Item->Group->Params;
+                GroupNode->BatchList.BytesPerInstance = Info->BytesPerInstance;
+
+                CurrentGroup = Item->Group;
+
+                ItemList->Stats.Groups += 1;
+            }
+
+            render_batch_node *LastBatch = GroupNode->BatchList.Last;
+
+            if (Info->BatchParamsSize)
+            {
+                PushBatchParams(&Item->Batch, Info->BatchParamsSize, Info->InstancePerBatch, Arena, &GroupNode->BatchList);
+            }
+
+            if (Item->InstanceCount)
+            {
+                void *Instances = PushDataInBatchList(Arena, &GroupNode->BatchList, Item->InstanceCount, Info->InstancePerBatch);
+                if (Instances)
+                {
+                    memcpy(Instances, Item->Instances, Item->InstanceCount * Info->BytesPerInstance);
+                }
+            }
+
+            if (GroupNode->BatchList.Last != LastBatch)
+            {
+                ItemList->Stats.Batches += 1;
+            }
+        }
+    }
+
+    if (Stats)
+    {
+        *Stats = ItemList->Stats;
+    }
+
+    // Everything the backend needs was copied into the pass list.
+    for (uint32_t Idx = 0; Idx < ContextCount; ++Idx)
+    {
+        memset(&Contexts[Idx].ItemList, 0, sizeof(render_item_list));
+
+        if (Contexts[Idx].Arena)
+        {
+            ClearArena(Contexts[Idx].Arena);
+        }
+    }
+
+    ProfileEnd(BuildRenderPassList);
+
+    return Result;
+}
+
+
+// =====================================================
+// [SECTION] Retained Lists
+// =====================================================
+
+
+render_retained_list *
+CreateRetainedList(memory_arena *Arena)
+{
+    render_retained_list *Result = PushStruct(Arena, render_retained_list);
+    if (Result)
     {
-        bool               SameParameters = Pass->Last ? (memcmp(&Pass->Last->Params.Chunk, Params, sizeof(chunk_group_params) == 0)) : false;
-        render_group_node *GroupNode      = GetGroupNode(SameParameters, Arena, Pass, PassList);
+        memset(Result, 0, sizeof(render_retained_list));
 
-        GroupNode->BatchList.BytesPerInstance = 0;
-        GroupNode->Params.Chunk               = *Params;
+        memory_arena_params Params =
+        {
+            .AllocatedFromFile = __FILE__,
+            .AllocatedFromLine = __LINE__,
+            .ReserveSize       = MiB(64),
+            .CommitSize        = MiB(1),
+        };
 
-        Result = &GroupNode->BatchList;
+        Result->Context.Arena = AllocateArena(Params);
+        Result->Arena         = AllocateArena(Params);
     }
 
     return Result;
 }
 
+
+render_context *
+BeginRetainedList(uint64_t Version, render_retained_list *List)
+{
+    if (List->Built && List->Version == Version)
+    {
+        return NULL;
+    }
+
+    ClearArena(List->Arena);
+
+    List->PassList.First = 0;
+    List->PassList.Last  = 0;
+    List->Version        = Version;
+    List->Built          = false;
+
+    return &List->Context;
+}
+
+
 void
-PushChunkBatchParams(chunk_batch_params *Params, uint64_t InstancePerBatch, memory_arena *Arena, render_batch_list *BatchList)
+EndRetainedList(render_retained_list *List)
 {
-    render_batch_node *Batch = BatchList->Last;
+    List->PassList = BuildRenderPassList(&List->Context, 1, 0, List->Arena);
+    List->Built    = true;
+}
+
+
+void
+InvalidateRetainedList(render_retained_list *List)
+{
+    List->Built = false;
+}
+
 
-    if (!Batch || memcmp(&Batch->Params.Chunk, Params, sizeof(chunk_batch_params) != 0))
+void
+SubmitRetainedList(camera *Camera, render_retained_list *List, renderer *Renderer)
+{
+    if (!List->Built || Renderer->RetainedCount == RENDER_MAX_RETAINED_LISTS)
     {
-        Batch = AppendNewRenderBatch(Arena, BatchList, InstancePerBatch);
-        if (Batch)
+        assert(List->Built);
+        return;
+    }
+
+    // A list linked twice would point back into itself.
+    for (uint32_t Idx = 0; Idx < Renderer->RetainedCount; ++Idx)
+    {
+        if (Renderer->Retained[Idx] == List)
+        {
+            return;
+        }
+    }
+
+    uint64_t      CameraKey = GetCameraKey(Camera);
+    camera_cache *Cache     = GetCameraCache(Camera);
+
+    for (render_pass_node *PassNode = List->PassList.First; PassNode != 0; PassNode = PassNode->Next)
+    {
+        RenderPass_Type Type = PassNode->Value.Type;
+        if (!IsCameraPass(Type))
+        {
+            continue;
+        }
+
+        for (render_group_node *GroupNode = PassNode->Value.First; GroupNode != 0; GroupNode = GroupNode->Next)
         {
-            Batch->Params.Chunk = *Params;
+            if (GroupNode->Params.Chunk.CameraKey != CameraKey)
+            {
+                GroupNode->Params.Chunk.CameraKey        = CameraKey;
+                GroupNode->Params.Chunk.WorldMatrix      = Mat4Identity();
+                GroupNode->Params.Chunk.ViewMatrix       = Cache->View;
+                GroupNode->Params.Chunk.ProjectionMatrix = Cache->Projection;
+            }
         }
     }
-}
\ No newline at end of file
+
+    Renderer->Retained[Renderer->RetainedCount++] = List;
+}
+
+
+static render_pass *
+FindOrInsertRenderPass(RenderPass_Type Type, render_pass_list *PassList, memory_arena *Arena)
+{
+    render_pass_node *Previous = 0;
+    render_pass_node *Node     = PassList->First;
+
+    while (Node && PassInfo[Node->Value.Type].Order < PassInfo[Type].Order)
+    {
+        Previous = Node;
+        Node     = Node->Next;
+    }
+
+    if (Node && Node->Value.Type == Type)
+    {
+        return &Node->Value;
+    }
+
+    render_pass_node *Result = PushStruct(Arena, render_pass_node);
+    if (!Result)
+    {
+        return NULL;
+    }
+
+    Result->Next        = Node;
+    Result->Value.Type  = Type;
+    Result->Value.First = 0;
+    Result->Value.Last  = 0;
+
+    if (Previous)
+    {
+        Previous->Next = Result;
+    }
+    else
+    {
+        PassList->First = Result;
+    }
+
+    if (!Node)
+    {
+        PassList->Last = Result;
+    }
+
+    return &Result->Value;
+}
+
+
+void
+LinkRetainedLists(render_pass_list *PassList, renderer *Renderer, memory_arena *Arena)
+{
+    for (uint32_t Idx = 0; Idx < Renderer->RetainedCount; ++Idx)
+    {
+        render_retained_list *List = Renderer->Retained[Idx];
+
+        for (render_pass_node *PassNode = List->PassList.First; PassNode != 0; PassNode = PassNode->Next)
+        {
+            render_pass *Retained = &PassNode->Value;
+            render_pass *Pass     = Retained->First ? FindOrInsertRenderPass(Retained->Type, PassList, Arena) : 0;
+            if (!Pass)
+            {
+                continue;
+            }
+
+            // Left over from the last frame this list was linked in.
+            Retained->Last->Next = 0;
+
+            if (Pass->Last)
+            {
+                Pass->Last->Next = Retained->First;
+            }
+            else
+            {
+                Pass->First = Retained->First;
+            }
+
+            Pass->Last = Retained->Last;
+        }
+    }
+
+    Renderer->RetainedCount = 0;
+}
@@ -1,17 +1,20 @@
 #pragma once
 
 #include <stdint.h>
+#include <stdbool.h>
 
 #include "engine/math/vector.h"
 #include "engine/math/matrix.h"
 
 #include "resources.h"
+#include "renderer.h"
 
 // =====================================================
 // Forward declaration
 // =====================================================
 
 typedef struct memory_arena memory_arena;
+typedef struct camera       camera;
 
 // =====================================================
 // [SECTION] Core Vertex Formats
@@ -51,6 +54,40 @@ typedef struct color
 } color;
 
 
+// =====================================================
+// [SECTION] Packed Vertex Formats
+// [DESCRIP]
+//   What the GPU actually reads. The float formats above
+//   are what meshing and authoring work with; they are
+//   converted once, when the vertex buffer is built.
+//
+//   Tile positions are chunk-local integers, the chunk
+//   origin travels with the batch. Tile UVs count tiles
+//   (a merged quad repeats the texture). Colors are RGBA8.
+// =====================================================
+
+// TileID is the tile's Data, so an edit changes the vertices even when the quads
+// stay the same.
+typedef struct tile_vertex_packed
+{
+    uint8_t  X, Y, Z, TileID;
+    uint16_t U, V;
+} tile_vertex_packed;
+
+
+typedef struct gizmo_vertex_packed
+{
+    vec3     Position;
+    uint32_t Color;
+} gizmo_vertex_packed;
+
+
+// Inputs are rounded and clamped: tile positions to [0, 255], tile UVs to [0, 65535]
+// and colors to [0, 1].
+tile_vertex_packed  PackTileVertex  (vec3 LocalPosition, vec2 UV, uint8_t TileID);
+gizmo_vertex_packed PackGizmoVertex (vec3 Position, vec3 Color);
+
+
 typedef struct
 {
     bounding_box Bounds;
@@ -75,17 +112,21 @@ typedef struct
 //   not a vertices, but represents a group of vertices.
 // =====================================================
 
-typedef struct
+// One tile of an instanced chunk: its coordinate inside the chunk and its index in
+// the material's tile atlas. The quad itself is generated by the vertex shader.
+typedef struct tile_instance
 {
-    tile_vertex_data Data[6];
-    vec2             UV;
+    uint8_t  X;
+    uint8_t  Y;
+    uint16_t TileID;
 } tile_instance;
 
+// 'World' places the mesh in world space; the group's model matrix stays identity.
 typedef struct
 {
     resource_handle MeshHandle;
     uint32_t        SubmeshIndex;
-    vec3            Transform;
+    mat4x4          World;
 } mesh_instance;
 
 
@@ -101,6 +142,8 @@ typedef enum RenderPass_Type
     RenderPass_UI = 2,
     RenderPass_Gizmo = 3,
     RenderPass_Chunk = 4,
+    RenderPass_Tile  = 5,
+    RenderPass_Count = 6,
 } RenderPass_Type;
 
 
@@ -114,7 +157,11 @@ typedef struct
 
 typedef struct
 {
-    resource_handle Material;
+    resource_handle  Material;
+    resource_handle  VertexBuffer;
+    resource_handle  IndexBuffer;
+    uint32_t         IndexCount;
+    RenderIndex_Type IndexType;
 } mesh_batch_params;
 
 
@@ -124,26 +171,45 @@ typedef struct
 } ui_batch_params;
 
 
+// The vertices are tile_vertex_packed, relative to 'Origin'.
 typedef struct
 {
-    uint64_t        VertexCount;
-    resource_handle VertexBuffer;
-    resource_handle Material;
+    uint64_t         VertexCount;
+    resource_handle  VertexBuffer;
+    resource_handle  Material;
+    resource_handle  IndexBuffer;
+    uint32_t         IndexCount;
+    RenderIndex_Type IndexType;
+    vec3             Origin;
+    uint32_t         _Padding0;
 } chunk_batch_params;
 
 
+typedef struct
+{
+    uint64_t        InstanceCount;
+    resource_handle InstanceBuffer;
+    resource_handle Material;
+    vec3            Origin;
+    uint32_t        _Padding0;
+} tile_batch_params;
+
+
+typedef union
+{
+    mesh_batch_params  Mesh;
+    ui_batch_params    UI;
+    chunk_batch_params Chunk;
+    tile_batch_params  Tile;
+} render_batch_params;
+
+
 typedef struct render_batch_node render_batch_node;
 struct render_batch_node
 {
-    render_batch_node *Next;
-    render_batch       Value;
-
-    union
-    {
-        mesh_batch_params  Mesh;
-        ui_batch_params    UI;
-        chunk_batch_params Chunk;
-    } Params;
+    render_batch_node  *Next;
+    render_batch        Value;
+    render_batch_params Params;
 };
 
 
@@ -158,9 +224,10 @@ typedef struct render_batch_list
 
 typedef struct
 {
-    mat4x4 WorldMatrix;
-    mat4x4 ViewMatrix;
-    mat4x4 ProjectionMatrix;
+    uint64_t CameraKey;
+    mat4x4   WorldMatrix;
+    mat4x4   ViewMatrix;
+    mat4x4   ProjectionMatrix;
 } mesh_group_params;
 
 
@@ -172,33 +239,47 @@ typedef struct
 
 typedef struct
 {
-    mat4x4 WorldMatrix;
-    mat4x4 ViewMatrix;
-    mat4x4 ProjectionMatrix;
+    uint64_t CameraKey;
+    mat4x4   WorldMatrix;
+    mat4x4   ViewMatrix;
+    mat4x4   ProjectionMatrix;
 } gizmo_group_params;
 
 
 typedef struct
 {
-    mat4x4 WorldMatrix;
-    mat4x4 ViewMatrix;
-    mat4x4 ProjectionMatrix;
+    uint64_t CameraKey;
+    mat4x4   WorldMatrix;
+    mat4x4   ViewMatrix;
+    mat4x4   ProjectionMatrix;
 } chunk_group_params;
 
 
+typedef struct
+{
+    uint64_t CameraKey;
+    mat4x4   WorldMatrix;
+    mat4x4   ViewMatrix;
+    mat4x4   ProjectionMatrix;
+} tile_group_params;
+
+
+typedef union
+{
+    mesh_group_params  Mesh;
+    ui_group_params    UI;
+    gizmo_group_params Gizmo;
+    chunk_group_params Chunk;
+    tile_group_params  Tile;
+} render_group_params;
+
+
 typedef struct render_group_node render_group_node;
 struct render_group_node
 {
-    render_group_node *Next;
-    render_batch_list  BatchList;
-
-    union
-    {
-        mesh_group_params  Mesh;
-        ui_group_params    UI;
-        gizmo_group_params Gizmo;
-        chunk_group_params Chunk;
-    } Params;
+    render_group_node  *Next;
+    render_batch_list   BatchList;
+    render_group_params Params;
 };
 
 
@@ -229,18 +310,173 @@ typedef struct render_pass_list
 #define UI_INSTANCE_PER_BATCH    50
 #define GIZMO_INSTANCE_PER_BATCH 1024
 #define CHUNK_INSTANCE_PER_BATCH 32
+#define TILE_INSTANCE_PER_BATCH  32
+
+
+// =====================================================
+// [SECTION] Render Items
+// [DESCRIP]
+//   Draws append items to a per-frame list in any order.
+//   RendererLeaveFrame sorts them by key and rebuilds
+//   the pass/group/batch lists from the sorted stream,
+//   so the backend sees each state change once.
+//
+//   Key, from the most significant bits:
+//     4  pass (in PassOrder, not enum order)
+//     4  layer
+//     12 group (camera/uniform block)
+//     12 material
+//     16 depth (view distance, front to back)
+//     16 batch (canonical batch parameters)
+//   The sort is stable: items with equal keys keep
+//   their submission order, which the UI pass relies on.
+//
+//   Camera-bound groups and the batch parameters of the
+//   mesh, chunk and tile passes are deduplicated through
+//   per-frame hash tables, so identical parameters map
+//   to one group or batch index wherever they were
+//   submitted. UI and gizmo draws only merge with the
+//   previous draw of their pass: their order matters.
+// =====================================================
+
+
+#define RENDER_ITEMS_PER_BLOCK 4096
+#define RENDER_LAYER_DEFAULT   0
+
+
+typedef struct render_group render_group;
+struct render_group
+{
+    render_group_params  Params;
+    RenderPass_Type      Pass;
+    uint32_t             Index;
+    render_group        *Canonical;
+};
 
 
-void              * PushDataInBatchList   (memory_arena *Arena, render_batch_list *BatchList, uint32_t InstanceCount, uint64_t InstancePerBatch);
-                    
-render_batch_list * PushUIGroupParams     (ui_group_params *Params, memory_arena *Arena, render_pass_list *PassList);
-render_batch_list * PushMeshGroupParams   (mesh_group_params *Params, memory_arena *Arena, render_pass_list *PassList);
-render_batch_list * PushGizmoGroupParams  (gizmo_group_params *Params, memory_arena *Arena, render_pass_list *PassList);
-render_batch_list * PushChunkGroupParams  (chunk_group_params *Params, memory_arena *Arena, render_pass_list *PassList);
-                    
-void                PushMeshBatchParams   (mesh_batch_params *Params, uint64_t InstancePerBatch, memory_arena *Arena, render_batch_list *BatchList);
-void                PushUIBatchParams     (ui_batch_params *Params, uint64_t InstancePerBatch, memory_arena *Arena, render_batch_list *BatchList);
-void                PushChunkBatchParams  (chunk_batch_params *Params, uint64_t InstancePerBatch, memory_arena *Arena, render_batch_list *BatchList);
+// Open addressing, linear probing. Values start with the parameter block they were
+// hashed from. A zero hash marks an empty slot.
+
+typedef struct
+{
+    uint64_t         Hash;
+    RenderPass_Type  Pass;
+    void            *Value;
+} render_params_slot;
+
+
+typedef struct
+{
+    render_params_slot *Slots;
+    uint32_t            Mask;
+    uint32_t            Count;
+} render_params_table;
+
+
+// 'Submitted' counts what merging with the previous draw of the pass alone would
+// produce, for comparison with what the backend actually walks.
+
+typedef struct render_stats
+{
+    uint32_t Items;
+    uint32_t GroupsSubmitted;
+    uint32_t Groups;
+    uint32_t BatchesSubmitted;
+    uint32_t Batches;
+} render_stats;
+
+
+typedef struct render_batch_entry render_batch_entry;
+
+
+typedef struct render_item
+{
+    uint64_t             Key;
+    RenderPass_Type      Pass;
+    uint32_t             InstanceCount;
+    render_group        *Group;
+    render_batch_entry  *BatchEntry;
+    render_batch_params  Batch;
+    void                *Instances;
+} render_item;
+
+
+typedef struct render_item_block render_item_block;
+struct render_item_block
+{
+    render_item_block *Next;
+    uint32_t           Count;
+    render_item        Items[RENDER_ITEMS_PER_BLOCK];
+};
+
+
+typedef struct render_item_list
+{
+    render_item_block   *First;
+    render_item_block   *Last;
+    uint32_t             Count;
+    uint32_t             GroupCount;
+    uint32_t             BatchCount;
+    render_group        *LastGroup[RenderPass_Count];
+    render_item         *LastItem[RenderPass_Count];
+    render_params_table  Groups;
+    render_params_table  Batches;
+    render_stats         Stats;
+} render_item_list;
+
+
+// Camera-bound groups are found by camera key, first against the last group of the
+// pass and then in the frame table. The matrices are copied from the camera cache
+// only for new groups.
+
+render_group        * PushCameraGroupParams  (RenderPass_Type Pass, camera *Camera, memory_arena *Arena, render_item_list *ItemList);
+render_group        * PushUIGroupParams      (ui_group_params *Params, memory_arena *Arena, render_item_list *ItemList);
+
+// Instance data (if any) is pushed by the caller into 'Arena' and referenced by the
+// item. Depth is a view distance in [0, 1] of the far plane.
+
+render_item         * PushRenderItem         (RenderPass_Type Pass, render_group *Group, render_batch_params *Batch, uint32_t Layer, float Depth,
+                                              memory_arena *Arena, render_item_list *ItemList);
+
+struct render_context
+{
+    render_item_list  ItemList;
+    memory_arena     *Arena;
+};
+
+
+// Merges the contexts in order, sorts the items and builds the pass list the backend
+// walks. Groups and batches recorded by different contexts are resolved against the
+// first context's tables. Every context is emptied and its arena cleared; the counters
+// go to 'Stats' (optional).
+render_pass_list      BuildRenderPassList    (render_context *Contexts, uint32_t ContextCount, render_stats *Stats, memory_arena *Arena);
+
+
+// =====================================================
+// [SECTION] Retained Lists
+// [DESCRIP]
+//   A retained list keeps the pass list built from its
+//   items in its own arena. Submitted lists are linked
+//   at the end of the matching frame passes, so their
+//   group nodes are shared by every frame and only
+//   their camera blocks and the last Next pointer are
+//   rewritten.
+// =====================================================
+
+
+struct render_retained_list
+{
+    render_context    Context;
+    memory_arena     *Arena;
+    render_pass_list  PassList;
+    uint64_t          Version;
+    bool              Built;
+};
+
+
+// Links the lists submitted this frame into 'PassList' (in pass order) and clears
+// the submissions.
+void                  LinkRetainedLists      (render_pass_list *PassList, renderer *Renderer, memory_arena *Arena);
 
 
 // =====================================================
@@ -250,17 +486,25 @@ void                PushChunkBatchParams  (chunk_batch_params *Params, uint64_t
 
 void *RendererCreateTexture(loaded_texture Texture, renderer *Renderer);
 void *RendererCreateVertexBuffer(void *Data, uint64_t Size, renderer *Renderer);
+void *RendererCreateIndexBuffer(void *Data, uint64_t Size, renderer *Renderer);
+
+// Buffers are created with 'Data' (which may be NULL) covering 'Size' bytes and can be
+// overwritten in place afterwards.
+void  RendererUpdateBuffer(void *Buffer, uint64_t Offset, void *Data, uint64_t Size, renderer *Renderer);
+void  RendererReleaseBuffer(void *Buffer, renderer *Renderer);
 
 
 // =====================================================
 // Core Structure
 // =====================================================
 
-typedef struct render_pass_list render_pass_list;
 typedef struct renderer
 {
     void                      *Backend;
-    render_pass_list           PassList;
+    render_context             Contexts[RENDER_MAX_CONTEXTS];
+    render_retained_list      *Retained[RENDER_MAX_RETAINED_LISTS];
+    uint32_t                   RetainedCount;
+    render_stats               Stats;
     renderer_resource_manager *Resources;
     resource_reference_table  *ReferenceTable;
 } renderer;
\ No newline at end of file
@@ -17,7 +17,8 @@
 #define INVALID_LINK_SENTINEL   0xFFFFFFFF
 #define INVALID_RESOURCE_ENTRY  0xFFFFFFFF
 #define INVALID_RESOURCE_HANDLE 0xFFFFFFFF
-#define MAX_RENDERER_RESOURCE   128
+#define MAX_RENDERER_RESOURCE   1024
+#define RESOURCE_HASH_SLOTS     256
 
 // =====================================================
 // Internal Only Types
@@ -37,7 +38,7 @@ typedef struct resource_reference_table
     uint32_t                 HashCount;
     uint32_t                 EntryCount;
 
-    uint32_t                 HashTable[32];
+    uint32_t                 HashTable[RESOURCE_HASH_SLOTS];
     resource_reference_entry Entries[MAX_RENDERER_RESOURCE];
     uint32_t                 FirstFreeEntry;
 } resource_reference_table;
@@ -162,7 +163,7 @@ GetRendererResource(uint32_t Id, renderer_resource_manager *ResourceManager)
 // =====================================================
 
 
-static resource_uuid
+resource_uuid
 MakeResourceUUID(byte_string PathToResource)
 {
     resource_uuid Result = { .Value = HashByteString(PathToResource) };
@@ -217,6 +218,34 @@ InsertResourceReference(resource_uuid UUID, resource_handle Handle, resource_ref
 }
 
 
+static void
+RemoveResourceReference(resource_uuid UUID, resource_reference_table *Table)
+{
+    if (Table)
+    {
+        uint32_t *Link = GetSlotPointer(UUID, Table);
+
+        while (*Link != INVALID_RESOURCE_ENTRY)
+        {
+            resource_reference_entry *Entry = GetEntry(*Link, Table);
+            if (ResourceUUIDAreEqual(Entry->UUID, UUID))
+            {
+                uint32_t EntryIndex = *Link;
+                *Link = Entry->NextSameHash;
+
+                Entry->Handle         = MakeInvalidResourceHandle();
+                Entry->UUID           = (resource_uuid){ .Value = 0 };
+                Entry->NextSameHash   = Table->FirstFreeEntry;
+                Table->FirstFreeEntry = EntryIndex;
+                break;
+            }
+
+            Link = &Entry->NextSameHash;
+        }
+    }
+}
+
+
 // Maybe expose this with params?? Same params as the resource_manager basically.
 
 resource_reference_table *
@@ -226,8 +255,8 @@ CreateResourceReferenceTable(memory_arena *Arena)
 
     if (Table)
     {
-        Table->HashCount = 32;
-        Table->HashMask = 32 - 1;
+        Table->HashCount = RESOURCE_HASH_SLOTS;
+        Table->HashMask = RESOURCE_HASH_SLOTS - 1;
         Table->EntryCount = MAX_RENDERER_RESOURCE;
         Table->FirstFreeEntry = 0;
 
@@ -254,6 +283,12 @@ CreateResourceHandle(resource_uuid UUID, RendererResource_Type Type, renderer_re
 {
     resource_handle Result = { 0 };
 
+    if (ResourceManager && ResourceManager->FirstFree == INVALID_LINK_SENTINEL)
+    {
+        assert(!"Out of renderer resources");
+        return MakeInvalidResourceHandle();
+    }
+
     if (Type != RendererResource_None && ResourceManager)
     {
         renderer_resource *Resource = ResourceManager->Resources + ResourceManager->FirstFree;
@@ -311,10 +346,8 @@ UnbindResourceHandle(resource_handle Handle, renderer_resource_manager *Resource
 
         --Resource->RefCount;
 
-        if (Resource->RefCount == 0)
-        {
-            // TODO: Free the resource...
-        }
+        // TODO: Free the other resource types. Buffers are freed by ReleaseBuffer, which
+        // has the renderer needed to release the backend object.
     }
 
     resource_handle InvalidHandle =
@@ -327,6 +360,30 @@ UnbindResourceHandle(resource_handle Handle, renderer_resource_manager *Resource
 }
 
 
+// Unlinks the slot from its type list and puts it back on the free list.
+static void
+FreeResourceHandle(resource_handle Handle, renderer_resource_manager *ResourceManager)
+{
+    renderer_resource *Resource = GetRendererResource(Handle.Value, ResourceManager);
+    assert(Resource->Type == Handle.Type && Resource->RefCount == 0);
+
+    uint32_t *Link = &ResourceManager->FirstByType[Handle.Type];
+    while (*Link != INVALID_LINK_SENTINEL && *Link != Handle.Value)
+    {
+        Link = &GetRendererResource(*Link, ResourceManager)->NextSameType;
+    }
+
+    assert(*Link == Handle.Value);
+    *Link = Resource->NextSameType;
+
+    ResourceManager->CountByType[Handle.Type] -= 1;
+
+    *Resource = (renderer_resource){ .Type = RendererResource_None, .NextFree = ResourceManager->FirstFree, .NextSameType = INVALID_LINK_SENTINEL };
+
+    ResourceManager->FirstFree = Handle.Value;
+}
+
+
 // TODO: Change this to specific queries?
 void *
 AccessUnderlyingResource(resource_handle Handle, renderer_resource_manager *ResourceManager)
@@ -348,6 +405,7 @@ AccessUnderlyingResource(resource_handle Handle, renderer_resource_manager *Reso
         } break;
 
         case RendererResource_VertexBuffer:
+        case RendererResource_IndexBuffer:
         {
             Result = &Resource->Buffer;
         } break;
@@ -488,25 +546,28 @@ GetDefaultMaterial(renderer *Renderer, memory_arena *Arena)
 // =====================================================
 
 
+// Vertex and index buffers of the same name are distinct resources.
 static resource_handle
-GetVertexBufferHandle(byte_string Name, memory_arena *Arena, renderer *Renderer)
+GetBufferHandle(byte_string Name, RendererResource_Type Type, memory_arena *Arena, renderer *Renderer)
 {
     if (!IsValidByteString(Name) || !Arena || !Renderer)
     {
         return MakeInvalidResourceHandle();
     }
 
-    byte_string     BufferNameParts[2] = { Name, ByteStringLiteral("geometry") };
+    byte_string     Suffix             = Type == RendererResource_IndexBuffer ? ByteStringLiteral("indices") : ByteStringLiteral("geometry");
+    byte_string     BufferNameParts[2] = { Name, Suffix };
     byte_string     BufferName = ConcatenateStrings(BufferNameParts, 2, ByteStringLiteral("::"), Arena);
     resource_uuid   BufferUUID = MakeResourceUUID(BufferName);
     resource_handle BufferHandle = SearchResourceByUUID(BufferUUID, Renderer->ReferenceTable);
 
     if (!IsValidResourceHandle(BufferHandle))
     {
-        BufferHandle = CreateResourceHandle(BufferUUID, RendererResource_VertexBuffer, Renderer->Resources);
-        assert(IsValidResourceHandle(BufferHandle));
-
-        InsertResourceReference(BufferUUID, BufferHandle, Renderer->ReferenceTable);
+        BufferHandle = CreateResourceHandle(BufferUUID, Type, Renderer->Resources);
+        if (IsValidResourceHandle(BufferHandle))
+        {
+            InsertResourceReference(BufferUUID, BufferHandle, Renderer->ReferenceTable);
+        }
     }
 
     return BufferHandle;
@@ -521,7 +582,7 @@ GetRendererBufferFromHandle(resource_handle Handle, renderer_resource_manager *R
     if (IsValidResourceHandle(Handle) && ResourceManager)
     {
         renderer_resource *Resource = GetRendererResource(Handle.Value, ResourceManager);
-        if (Resource && Resource->Type == RendererResource_VertexBuffer)
+        if (Resource && (Resource->Type == RendererResource_VertexBuffer || Resource->Type == RendererResource_IndexBuffer))
         {
             Result = &Resource->Buffer;
         }
@@ -531,6 +592,37 @@ GetRendererBufferFromHandle(resource_handle Handle, renderer_resource_manager *R
 }
 
 
+// Replaces the contents. A buffer only grows, by at least half its capacity, so a
+// mesh that keeps changing size settles on one allocation.
+static void
+WriteWholeBuffer(renderer_buffer *Buffer, RendererResource_Type Type, void *Data, uint64_t Size, renderer *Renderer)
+{
+    if (!Buffer->Backend)
+    {
+        Buffer->Backend  = Type == RendererResource_IndexBuffer ? RendererCreateIndexBuffer(Data, Size, Renderer) : RendererCreateVertexBuffer(Data, Size, Renderer);
+        Buffer->Size     = Size;
+        Buffer->Capacity = Size;
+    }
+    else if (Size > Buffer->Capacity)
+    {
+        uint64_t Capacity = Maximum(Size, Buffer->Capacity + Buffer->Capacity / 2);
+
+        RendererReleaseBuffer(Buffer->Backend, Renderer);
+
+        Buffer->Backend  = Type == RendererResource_IndexBuffer ? RendererCreateIndexBuffer(0, Capacity, Renderer) : RendererCreateVertexBuffer(0, Capacity, Renderer);
+        Buffer->Capacity = Capacity;
+
+        RendererUpdateBuffer(Buffer->Backend, 0, Data, Size, Renderer);
+        Buffer->Size = Size;
+    }
+    else
+    {
+        RendererUpdateBuffer(Buffer->Backend, 0, Data, Size, Renderer);
+        Buffer->Size = Size;
+    }
+}
+
+
 resource_handle
 UpdateVertexBuffer(byte_string BufferName, void *Data, uint64_t Size, memory_arena *Arena, renderer *Renderer)
 {
@@ -539,19 +631,99 @@ UpdateVertexBuffer(byte_string BufferName, void *Data, uint64_t Size, memory_are
         return MakeInvalidResourceHandle();
     }
 
-    resource_handle  BufferHandle = GetVertexBufferHandle(BufferName, Arena, Renderer);
+    resource_handle  BufferHandle = GetBufferHandle(BufferName, RendererResource_VertexBuffer, Arena, Renderer);
     renderer_buffer *VertexBuffer = AccessUnderlyingResource(BufferHandle, Renderer->Resources);
 
-    if (!VertexBuffer->Backend)
+    if (!VertexBuffer)
     {
-        VertexBuffer->Backend = RendererCreateVertexBuffer(Data, Size, Renderer);
-        VertexBuffer->Size    = Size;
+        return MakeInvalidResourceHandle();
     }
-    else
+
+    WriteWholeBuffer(VertexBuffer, RendererResource_VertexBuffer, Data, Size, Renderer);
+
+    return BufferHandle;
+}
+
+
+// 'Data' holds 16 or 32-bit indices; the format travels with the draw, not the buffer.
+resource_handle
+UpdateIndexBuffer(byte_string BufferName, void *Data, uint64_t Size, memory_arena *Arena, renderer *Renderer)
+{
+    if (!Arena || !Renderer || !IsValidByteString(BufferName))
     {
-        assert(!"NOT IMPLEMENTED");
-        // Otherwise we have to update the buffer. What if the size differs?
+        return MakeInvalidResourceHandle();
     }
 
+    resource_handle  BufferHandle = GetBufferHandle(BufferName, RendererResource_IndexBuffer, Arena, Renderer);
+    renderer_buffer *IndexBuffer  = AccessUnderlyingResource(BufferHandle, Renderer->Resources);
+
+    if (!IndexBuffer)
+    {
+        return MakeInvalidResourceHandle();
+    }
+
+    WriteWholeBuffer(IndexBuffer, RendererResource_IndexBuffer, Data, Size, Renderer);
+
     return BufferHandle;
-}
\ No newline at end of file
+}
+
+
+bool
+WriteBuffer(resource_handle Buffer, void *Data, uint64_t Size, renderer *Renderer)
+{
+    renderer_buffer *RendererBuffer = Renderer ? GetRendererBufferFromHandle(Buffer, Renderer->Resources) : 0;
+    if (!RendererBuffer || !Data || !Size)
+    {
+        return false;
+    }
+
+    WriteWholeBuffer(RendererBuffer, Buffer.Type, Data, Size, Renderer);
+
+    return true;
+}
+
+
+bool
+WriteBufferRange(resource_handle Buffer, uint64_t Offset, void *Data, uint64_t Size, renderer *Renderer)
+{
+    renderer_buffer *RendererBuffer = Renderer ? GetRendererBufferFromHandle(Buffer, Renderer->Resources) : 0;
+    if (!RendererBuffer || !RendererBuffer->Backend || !Data || !Size)
+    {
+        return false;
+    }
+
+    if (Offset + Size > RendererBuffer->Size)
+    {
+        assert(!"Buffer range out of bounds");
+        return false;
+    }
+
+    RendererUpdateBuffer(RendererBuffer->Backend, Offset, Data, Size, Renderer);
+
+    return true;
+}
+
+
+void
+ReleaseBuffer(resource_handle Buffer, renderer *Renderer)
+{
+    renderer_buffer *RendererBuffer = Renderer ? GetRendererBufferFromHandle(Buffer, Renderer->Resources) : 0;
+    if (!RendererBuffer)
+    {
+        return;
+    }
+
+    renderer_resource *Resource = GetRendererResource(Buffer.Value, Renderer->Resources);
+    UnbindResourceHandle(Buffer, Renderer->Resources);
+
+    if (Resource->RefCount == 0)
+    {
+        if (RendererBuffer->Backend)
+        {
+            RendererReleaseBuffer(RendererBuffer->Backend, Renderer);
+        }
+
+        RemoveResourceReference(Resource->UUID, Renderer->ReferenceTable);
+        FreeResourceHandle(Buffer, Renderer->Resources);
+    }
+}
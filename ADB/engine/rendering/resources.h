@@ -20,6 +20,7 @@ typedef enum
     RendererResource_Texture2D,
     RendererResource_TextureView,
     RendererResource_VertexBuffer,
+    RendererResource_IndexBuffer,
 
     // Composite
     RendererResource_Material,
@@ -28,6 +29,21 @@ typedef enum
 } RendererResource_Type;
 
 
+// Width of the indices in an index buffer. RenderIndex_None draws the vertices in order.
+// RenderIndex_Quads ignores the index buffer and draws groups of four vertices as two
+// triangles (0 1 2, 0 2 3) through the backend's shared 16-bit quad index buffer, up to
+// RENDER_MAX_SHARED_QUADS quads.
+typedef enum
+{
+    RenderIndex_None  = 0,
+    RenderIndex_U16   = 1,
+    RenderIndex_U32   = 2,
+    RenderIndex_Quads = 3,
+} RenderIndex_Type;
+
+#define RENDER_MAX_SHARED_QUADS (0x10000 / 4)
+
+
 typedef enum
 {
     MaterialMap_Albedo = 0,
@@ -67,10 +83,12 @@ typedef struct
 } renderer_backend_resource;
 
 
+// 'Size' bytes are in use out of 'Capacity'.
 typedef struct
 {
     void  *Backend;
     size_t Size;
+    size_t Capacity;
 } renderer_buffer;
 
 
@@ -108,4 +126,15 @@ resource_handle   GetDefaultMaterial           (renderer *Renderer, memory_arena
 
 renderer_buffer * GetRendererBufferFromHandle  (resource_handle Handle, renderer_resource_manager *ResourceManager);
 
-resource_handle   UpdateVertexBuffer           (byte_string BufferName, void *Data, uint64_t Size, memory_arena *Arena, renderer *Renderer);
\ No newline at end of file
+resource_handle   UpdateVertexBuffer           (byte_string BufferName, void *Data, uint64_t Size, memory_arena *Arena, renderer *Renderer);
+resource_handle   UpdateIndexBuffer            (byte_string BufferName, void *Data, uint64_t Size, memory_arena *Arena, renderer *Renderer);
+
+// Update* create the named buffer or replace its contents. WriteBuffer replaces the
+// contents of a vertex or index buffer and grows it if needed. WriteBufferRange
+// overwrites bytes in place and must stay within the current contents.
+// ReleaseBuffer drops a reference taken with BindResourceHandle. The last one releases
+// the backend buffer, and the handle and name can be reused.
+
+bool              WriteBuffer                  (resource_handle Buffer, void *Data, uint64_t Size, renderer *Renderer);
+bool              WriteBufferRange             (resource_handle Buffer, uint64_t Offset, void *Data, uint64_t Size, renderer *Renderer);
+void              ReleaseBuffer                (resource_handle Buffer, renderer *Renderer);
@@ -0,0 +1,437 @@
+#include "transform.h"
+
+#include <stdint.h>
+#include <stdbool.h>
+#include <string.h>
+#include <assert.h>
+
+#include <xmmintrin.h>
+#include <emmintrin.h>
+
+#include "utilities.h"
+#include "engine/jobs/parallel.h"
+#include "engine/profiler/profiler.h"
+
+
+// =====================================================
+// [SECTION] Internal Helpers
+// =====================================================
+
+
+#define TRANSFORM_NO_PARENT 0xFFFFFFFFu
+#define TRANSFORM_GRAIN     512
+
+
+typedef struct
+{
+    transform_hierarchy *Hierarchy;
+} transform_update_job;
+
+
+static float *
+PushTransformLanes(memory_arena *Arena, uint32_t Capacity)
+{
+    float *Result = PushArrayAligned(Arena, float, Capacity, 64);
+    if (Result)
+    {
+        memset(Result, 0, Capacity * sizeof(float));
+    }
+
+    return Result;
+}
+
+
+// P * V for an affine P given as its four columns. Only the W of 'V' is read from
+// 'PW': zero for the basis columns and one for the translation, as local matrices
+// have no projective row.
+static __m128
+TransformColumn(__m128 V, __m128 *P, __m128 PW)
+{
+    __m128 Result = _mm_mul_ps(_mm_shuffle_ps(V, V, _MM_SHUFFLE(0, 0, 0, 0)), P[0]);
+    Result = _mm_add_ps(Result, _mm_mul_ps(_mm_shuffle_ps(V, V, _MM_SHUFFLE(1, 1, 1, 1)), P[1]));
+    Result = _mm_add_ps(Result, _mm_mul_ps(_mm_shuffle_ps(V, V, _MM_SHUFFLE(2, 2, 2, 2)), P[2]));
+    Result = _mm_add_ps(Result, PW);
+
+    return Result;
+}
+
+
+// Local matrices of four consecutive slots are built component-wise (each register
+// holds one matrix entry of four nodes), then transposed into per-node columns.
+// Lanes past 'LaneCount' read neighbours or the lane padding and are never stored.
+static void
+UpdateTransformBlock(transform_hierarchy *Hierarchy, uint32_t Slot, uint32_t LaneCount)
+{
+    __m128 X  = _mm_loadu_ps(Hierarchy->RotationX + Slot);
+    __m128 Y  = _mm_loadu_ps(Hierarchy->RotationY + Slot);
+    __m128 Z  = _mm_loadu_ps(Hierarchy->RotationZ + Slot);
+    __m128 W  = _mm_loadu_ps(Hierarchy->RotationW + Slot);
+    __m128 SX = _mm_loadu_ps(Hierarchy->ScaleX + Slot);
+    __m128 SY = _mm_loadu_ps(Hierarchy->ScaleY + Slot);
+    __m128 SZ = _mm_loadu_ps(Hierarchy->ScaleZ + Slot);
+
+    __m128 One = _mm_set1_ps(1.f);
+    __m128 Two = _mm_set1_ps(2.f);
+
+    __m128 X2 = _mm_mul_ps(X, Two), Y2 = _mm_mul_ps(Y, Two), Z2 = _mm_mul_ps(Z, Two);
+    __m128 XX = _mm_mul_ps(X, X2),  YY = _mm_mul_ps(Y, Y2),  ZZ = _mm_mul_ps(Z, Z2);
+    __m128 XY = _mm_mul_ps(X, Y2),  XZ = _mm_mul_ps(X, Z2),  YZ = _mm_mul_ps(Y, Z2);
+    __m128 WX = _mm_mul_ps(W, X2),  WY = _mm_mul_ps(W, Y2),  WZ = _mm_mul_ps(W, Z2);
+
+    __m128 Columns[4][4] =
+    {
+        { _mm_mul_ps(_mm_sub_ps(One, _mm_add_ps(YY, ZZ)), SX), _mm_mul_ps(_mm_add_ps(XY, WZ), SX), _mm_mul_ps(_mm_sub_ps(XZ, WY), SX), _mm_setzero_ps() },
+        { _mm_mul_ps(_mm_sub_ps(XY, WZ), SY), _mm_mul_ps(_mm_sub_ps(One, _mm_add_ps(XX, ZZ)), SY), _mm_mul_ps(_mm_add_ps(YZ, WX), SY), _mm_setzero_ps() },
+        { _mm_mul_ps(_mm_add_ps(XZ, WY), SZ), _mm_mul_ps(_mm_sub_ps(YZ, WX), SZ), _mm_mul_ps(_mm_sub_ps(One, _mm_add_ps(XX, YY)), SZ), _mm_setzero_ps() },
+        { _mm_loadu_ps(Hierarchy->PositionX + Slot), _mm_loadu_ps(Hierarchy->PositionY + Slot), _mm_loadu_ps(Hierarchy->PositionZ + Slot), One },
+    };
+
+    // After the transpose Columns[Column][Lane] is that column of that node.
+    for (uint32_t Column = 0; Column < 4; ++Column)
+    {
+        _MM_TRANSPOSE4_PS(Columns[Column][0], Columns[Column][1], Columns[Column][2], Columns[Column][3]);
+    }
+
+    for (uint32_t Lane = 0; Lane < LaneCount; ++Lane)
+    {
+        uint32_t Node = Slot + Lane;
+        if (!Hierarchy->Dirty[Node])
+        {
+            continue;
+        }
+
+        float   *World  = &Hierarchy->World[Node].c0r0;
+        uint32_t Parent = Hierarchy->Parent[Node];
+
+        if (Parent == TRANSFORM_NO_PARENT)
+        {
+            for (uint32_t Column = 0; Column < 4; ++Column)
+            {
+                _mm_storeu_ps(World + 4 * Column, Columns[Column][Lane]);
+            }
+        }
+        else
+        {
+            float *ParentWorld      = &Hierarchy->World[Parent].c0r0;
+            __m128 ParentColumns[4] =
+            {
+                _mm_loadu_ps(ParentWorld +  0),
+                _mm_loadu_ps(ParentWorld +  4),
+                _mm_loadu_ps(ParentWorld +  8),
+                _mm_loadu_ps(ParentWorld + 12),
+            };
+
+            __m128 Zero = _mm_setzero_ps();
+
+            _mm_storeu_ps(World +  0, TransformColumn(Columns[0][Lane], ParentColumns, Zero));
+            _mm_storeu_ps(World +  4, TransformColumn(Columns[1][Lane], ParentColumns, Zero));
+            _mm_storeu_ps(World +  8, TransformColumn(Columns[2][Lane], ParentColumns, Zero));
+            _mm_storeu_ps(World + 12, TransformColumn(Columns[3][Lane], ParentColumns, ParentColumns[3]));
+        }
+    }
+}
+
+
+// Parents live in an earlier level, so their dirty flag and world matrix are final
+// by the time any slot of this range reads them.
+static void
+UpdateTransformRange(uint64_t Begin, uint64_t End, void *Context)
+{
+    transform_hierarchy *Hierarchy = ((transform_update_job *)Context)->Hierarchy;
+
+    for (uint32_t Node = (uint32_t)Begin; Node < End; ++Node)
+    {
+        uint32_t Parent = Hierarchy->Parent[Node];
+        if (Parent != TRANSFORM_NO_PARENT)
+        {
+            Hierarchy->Dirty[Node] |= Hierarchy->Dirty[Parent];
+        }
+    }
+
+    // Full blocks test their four dirty flags at once. The tail block stops at 'End',
+    // whose next slots belong to another range.
+    for (uint32_t Slot = (uint32_t)Begin; Slot < End; Slot += 4)
+    {
+        uint32_t LaneCount = (uint32_t)Minimum(4, End - Slot);
+        uint32_t AnyDirty  = 0;
+
+        if (LaneCount == 4)
+        {
+            memcpy(&AnyDirty, Hierarchy->Dirty + Slot, sizeof(AnyDirty));
+        }
+        else
+        {
+            for (uint32_t Lane = 0; Lane < LaneCount; ++Lane)
+            {
+                AnyDirty |= Hierarchy->Dirty[Slot + Lane];
+            }
+        }
+
+        if (AnyDirty)
+        {
+            UpdateTransformBlock(Hierarchy, Slot, LaneCount);
+        }
+    }
+}
+
+
+static void
+PermuteFloats(float *Values, uint32_t *NewSlot, uint32_t Count, float *Temporary)
+{
+    for (uint32_t Slot = 0; Slot < Count; ++Slot)
+    {
+        Temporary[NewSlot[Slot]] = Values[Slot];
+    }
+
+    memcpy(Values, Temporary, Count * sizeof(float));
+}
+
+
+// Stable counting sort by depth. World matrices are not moved: every node is marked
+// dirty instead, which costs one full update after a structural change.
+static void
+SortTransformsByDepth(transform_hierarchy *Hierarchy, memory_arena *Scratch)
+{
+    assert(Scratch);
+
+    uint32_t Count = Hierarchy->Count;
+
+    memory_region Region    = EnterMemoryRegion(Scratch);
+    uint32_t     *NewSlot   = PushArray(Scratch, uint32_t, Count);
+    uint32_t     *Temporary = PushArray(Scratch, uint32_t, Count);
+
+    uint32_t Cursor[TRANSFORM_MAX_DEPTH];
+    uint32_t Offset = 0;
+    for (uint32_t Depth = 0; Depth < TRANSFORM_MAX_DEPTH; ++Depth)
+    {
+        Cursor[Depth] = Offset;
+        Offset       += Hierarchy->LevelCount[Depth];
+    }
+
+    for (uint32_t Slot = 0; Slot < Count; ++Slot)
+    {
+        NewSlot[Slot] = Cursor[Hierarchy->Depth[Slot]]++;
+    }
+
+    float *Arrays[] =
+    {
+        Hierarchy->PositionX, Hierarchy->PositionY, Hierarchy->PositionZ,
+        Hierarchy->RotationX, Hierarchy->RotationY, Hierarchy->RotationZ, Hierarchy->RotationW,
+        Hierarchy->ScaleX,    Hierarchy->ScaleY,    Hierarchy->ScaleZ,
+    };
+
+    for (uint32_t Idx = 0; Idx < ArrayCount(Arrays); ++Idx)
+    {
+        PermuteFloats(Arrays[Idx], NewSlot, Count, (float *)Temporary);
+    }
+
+    for (uint32_t Slot = 0; Slot < Count; ++Slot)
+    {
+        uint32_t Parent = Hierarchy->Parent[Slot];
+        Temporary[NewSlot[Slot]] = Parent == TRANSFORM_NO_PARENT ? TRANSFORM_NO_PARENT : NewSlot[Parent];
+    }
+    memcpy(Hierarchy->Parent, Temporary, Count * sizeof(uint32_t));
+
+    for (uint32_t Slot = 0; Slot < Count; ++Slot)
+    {
+        Temporary[NewSlot[Slot]] = Hierarchy->SlotToHandle[Slot];
+    }
+    memcpy(Hierarchy->SlotToHandle, Temporary, Count * sizeof(uint32_t));
+
+    for (uint32_t Slot = 0; Slot < Count; ++Slot)
+    {
+        Hierarchy->HandleToSlot[Hierarchy->SlotToHandle[Slot]] = Slot;
+    }
+
+    for (uint32_t Depth = 0, Slot = 0; Depth < TRANSFORM_MAX_DEPTH; ++Depth)
+    {
+        for (uint32_t Idx = 0; Idx < Hierarchy->LevelCount[Depth]; ++Idx, ++Slot)
+        {
+            Hierarchy->Depth[Slot] = (uint8_t)Depth;
+        }
+    }
+
+    memset(Hierarchy->Dirty, 1, Count);
+
+    LeaveMemoryRegion(Region);
+
+    Hierarchy->NeedsSort = false;
+}
+
+
+static uint32_t
+GetTransformSlot(transform_handle Handle, transform_hierarchy *Hierarchy)
+{
+    assert(Handle.Value > 0 && Handle.Value <= Hierarchy->Count);
+
+    uint32_t Result = Hierarchy->HandleToSlot[Handle.Value - 1];
+    return Result;
+}
+
+
+// =====================================================
+// [SECTION] Public API
+// =====================================================
+
+
+transform_hierarchy *
+CreateTransformHierarchy(uint32_t Capacity, memory_arena *Arena)
+{
+    transform_hierarchy *Result = PushStruct(Arena, transform_hierarchy);
+    if (!Result)
+    {
+        return NULL;
+    }
+
+    memset(Result, 0, sizeof(transform_hierarchy));
+
+    // Level ranges start at any slot, so a block starting at the last slot loads
+    // three floats past it.
+    uint32_t Padded = Capacity + 3;
+
+    Result->Capacity     = Capacity;
+    Result->PositionX    = PushTransformLanes(Arena, Padded);
+    Result->PositionY    = PushTransformLanes(Arena, Padded);
+    Result->PositionZ    = PushTransformLanes(Arena, Padded);
+    Result->RotationX    = PushTransformLanes(Arena, Padded);
+    Result->RotationY    = PushTransformLanes(Arena, Padded);
+    Result->RotationZ    = PushTransformLanes(Arena, Padded);
+    Result->RotationW    = PushTransformLanes(Arena, Padded);
+    Result->ScaleX       = PushTransformLanes(Arena, Padded);
+    Result->ScaleY       = PushTransformLanes(Arena, Padded);
+    Result->ScaleZ       = PushTransformLanes(Arena, Padded);
+    Result->Parent       = PushArray(Arena, uint32_t, Capacity);
+    Result->Depth        = PushArray(Arena, uint8_t, Capacity);
+    Result->Dirty        = PushArray(Arena, uint8_t, Capacity);
+    Result->World        = PushArrayAligned(Arena, mat4x4, Capacity, 64);
+    Result->SlotToHandle = PushArray(Arena, uint32_t, Capacity);
+    Result->HandleToSlot = PushArray(Arena, uint32_t, Capacity);
+
+    return Result;
+}
+
+
+transform_handle
+CreateTransform(transform_handle Parent, vec3 Position, quat Rotation, vec3 Scale, transform_hierarchy *Hierarchy)
+{
+    transform_handle Result = {0};
+
+    if (Hierarchy->Count == Hierarchy->Capacity)
+    {
+        return Result;
+    }
+
+    uint32_t ParentSlot = TRANSFORM_NO_PARENT;
+    uint32_t Depth      = 0;
+
+    if (Parent.Value)
+    {
+        ParentSlot = GetTransformSlot(Parent, Hierarchy);
+        Depth      = Hierarchy->Depth[ParentSlot] + 1u;
+
+        assert(Depth < TRANSFORM_MAX_DEPTH);
+    }
+
+    uint32_t Slot = Hierarchy->Count++;
+
+    // Appending keeps slots sorted unless a shallower node follows a deeper one.
+    if (Slot > 0 && Hierarchy->Depth[Slot - 1] > Depth)
+    {
+        Hierarchy->NeedsSort = true;
+    }
+
+    Hierarchy->PositionX[Slot] = Position.X;
+    Hierarchy->PositionY[Slot] = Position.Y;
+    Hierarchy->PositionZ[Slot] = Position.Z;
+    Hierarchy->RotationX[Slot] = Rotation.X;
+    Hierarchy->RotationY[Slot] = Rotation.Y;
+    Hierarchy->RotationZ[Slot] = Rotation.Z;
+    Hierarchy->RotationW[Slot] = Rotation.W;
+    Hierarchy->ScaleX[Slot]    = Scale.X;
+    Hierarchy->ScaleY[Slot]    = Scale.Y;
+    Hierarchy->ScaleZ[Slot]    = Scale.Z;
+    Hierarchy->Parent[Slot]    = ParentSlot;
+    Hierarchy->Depth[Slot]     = (uint8_t)Depth;
+    Hierarchy->Dirty[Slot]     = 1;
+
+    // Handles are never recycled, so the handle index is the creation index.
+    Hierarchy->SlotToHandle[Slot] = Slot;
+    Hierarchy->HandleToSlot[Slot] = Slot;
+    Hierarchy->LevelCount[Depth] += 1;
+
+    Result.Value = Slot + 1;
+    return Result;
+}
+
+
+void
+SetTransformPosition(transform_handle Handle, vec3 Position, transform_hierarchy *Hierarchy)
+{
+    uint32_t Slot = GetTransformSlot(Handle, Hierarchy);
+
+    Hierarchy->PositionX[Slot] = Position.X;
+    Hierarchy->PositionY[Slot] = Position.Y;
+    Hierarchy->PositionZ[Slot] = Position.Z;
+    Hierarchy->Dirty[Slot]     = 1;
+}
+
+
+void
+SetTransformRotation(transform_handle Handle, quat Rotation, transform_hierarchy *Hierarchy)
+{
+    uint32_t Slot = GetTransformSlot(Handle, Hierarchy);
+
+    Hierarchy->RotationX[Slot] = Rotation.X;
+    Hierarchy->RotationY[Slot] = Rotation.Y;
+    Hierarchy->RotationZ[Slot] = Rotation.Z;
+    Hierarchy->RotationW[Slot] = Rotation.W;
+    Hierarchy->Dirty[Slot]     = 1;
+}
+
+
+void
+SetTransformScale(transform_handle Handle, vec3 Scale, transform_hierarchy *Hierarchy)
+{
+    uint32_t Slot = GetTransformSlot(Handle, Hierarchy);
+
+    Hierarchy->ScaleX[Slot] = Scale.X;
+    Hierarchy->ScaleY[Slot] = Scale.Y;
+    Hierarchy->ScaleZ[Slot] = Scale.Z;
+    Hierarchy->Dirty[Slot]  = 1;
+}
+
+
+mat4x4 *
+GetTransformWorldMatrix(transform_handle Handle, transform_hierarchy *Hierarchy)
+{
+    mat4x4 *Result = &Hierarchy->World[GetTransformSlot(Handle, Hierarchy)];
+    return Result;
+}
+
+
+void
+UpdateTransforms(transform_hierarchy *Hierarchy, memory_arena *Scratch, engine_memory *EngineMemory)
+{
+    ProfileBegin(UpdateTransforms);
+
+    if (Hierarchy->NeedsSort)
+    {
+        SortTransformsByDepth(Hierarchy, Scratch);
+    }
+
+    transform_update_job Job   = { .Hierarchy = Hierarchy };
+    uint64_t             Begin = 0;
+
+    for (uint32_t Depth = 0; Depth < TRANSFORM_MAX_DEPTH && Hierarchy->LevelCount[Depth]; ++Depth)
+    {
+        uint64_t End = Begin + Hierarchy->LevelCount[Depth];
+
+        ParallelFor(Begin, End, TRANSFORM_GRAIN, UpdateTransformRange, &Job, EngineMemory);
+
+        Begin = End;
+    }
+
+    memset(Hierarchy->Dirty, 0, Hierarchy->Count);
+
+    ProfileEnd(UpdateTransforms);
+}
@@ -0,0 +1,81 @@
+#pragma once
+
+#include <stdint.h>
+#include <stdbool.h>
+
+#include "engine/math/vector.h"
+#include "engine/math/matrix.h"
+
+
+// =====================================================
+// [SECTION] Forward Declarations
+// =====================================================
+
+
+typedef struct engine_memory engine_memory;
+typedef struct memory_arena  memory_arena;
+
+
+// =====================================================
+// [SECTION] Transform Hierarchy
+// [DESCRIP]
+//   Local translation, rotation and scale are stored as
+//   separate arrays with slots sorted by depth, so every
+//   parent is updated before its children and a whole
+//   level can be processed in parallel, four nodes per
+//   SSE iteration.
+//
+//   Handles stay valid while slots move. Changing a local
+//   transform marks the node dirty. UpdateTransforms
+//   propagates that to the subtree and only recomputes
+//   the world matrices of dirty blocks.
+// =====================================================
+
+
+#define TRANSFORM_MAX_DEPTH 32
+
+
+typedef struct
+{
+    uint32_t Value;
+} transform_handle;
+
+
+typedef struct transform_hierarchy
+{
+    uint32_t  Capacity;
+    uint32_t  Count;
+
+    // Indexed by slot.
+    float    *PositionX, *PositionY, *PositionZ;
+    float    *RotationX, *RotationY, *RotationZ, *RotationW;
+    float    *ScaleX,    *ScaleY,    *ScaleZ;
+    uint32_t *Parent;
+    uint8_t  *Depth;
+    uint8_t  *Dirty;
+    mat4x4   *World;
+    uint32_t *SlotToHandle;
+
+    // Indexed by handle value - 1.
+    uint32_t *HandleToSlot;
+
+    uint32_t  LevelCount[TRANSFORM_MAX_DEPTH];
+    bool      NeedsSort;
+} transform_hierarchy;
+
+
+// Root transforms pass a zero parent handle. Returns a zero handle when full.
+
+transform_hierarchy * CreateTransformHierarchy  (uint32_t Capacity, memory_arena *Arena);
+transform_handle      CreateTransform           (transform_handle Parent, vec3 Position, quat Rotation, vec3 Scale, transform_hierarchy *Hierarchy);
+
+void                  SetTransformPosition      (transform_handle Handle, vec3 Position, transform_hierarchy *Hierarchy);
+void                  SetTransformRotation      (transform_handle Handle, quat Rotation, transform_hierarchy *Hierarchy);
+void                  SetTransformScale         (transform_handle Handle, vec3 Scale, transform_hierarchy *Hierarchy);
+
+// Valid until the next UpdateTransforms.
+mat4x4              * GetTransformWorldMatrix   (transform_handle Handle, transform_hierarchy *Hierarchy);
+
+// 'Scratch' is only used when nodes were created out of depth order, and is released
+// before returning.
+void                  UpdateTransforms          (transform_hierarchy *Hierarchy, memory_arena *Scratch, engine_memory *EngineMemory);
@@ -1,94 +1,529 @@
 #include "chunk.h"
 
+#include <assert.h>
 #include <stdint.h>
+#include <string.h>
 
 #include "utilities.h"
 #include "engine/math/vector.h"
+#include "engine/math/vector_batch.h"
 #include "engine/rendering/draw.h"
+#include "engine/rendering/renderer.h"
 #include "engine/rendering/resources.h"
 #include "engine/rendering/renderer_internal.h"
+#include "engine/profiler/profiler.h"
+#include "engine/jobs/parallel.h"
+
+
+#define CHUNK_DRAWS_PER_BLOCK 256
 
 
 // TODO: This could be in the draw code, because I doubt we want to handle most of this code here.
 
-static const tile_vertex_data TileQuad[6] =
+static const tile_vertex_data TileQuad[4] =
 {
-	// Triangle 1
 	{.Position = {0, 0, 0}, .UV = {0, 0} },
 	{.Position = {1, 0, 0}, .UV = {1, 0} },
 	{.Position = {1, 1, 0}, .UV = {1, 1} },
-
-	// Triangle 2
-	{.Position = {0, 0, 0}, .UV = {0, 0} },
-	{.Position = {1, 1, 0}, .UV = {1, 1} },
 	{.Position = {0, 1, 0}, .UV = {0, 1} },
 };
 
 
+// Quads are drawn with RenderIndex_Quads: six indices per quad, same two triangles
+// (and winding) as the old six-vertex quad.
+#define TILE_QUAD_INDEX_COUNT 6
+
+static_assert(CHUNK_SIZE_X * CHUNK_SIZE_Y <= RENDER_MAX_SHARED_QUADS, "Chunk quads must fit in the shared quad index buffer");
+
+
 static tile *
 GetTile(uint32_t X, uint32_t Y, chunk *Chunk)
 {
-	tile    *Result = 0;
-	uint32_t Index  = Y * Chunk->SizeY + X;
+	tile *Result = 0;
 
-	if (Index < Chunk->SizeX * Chunk->SizeY)
+	if (X < Chunk->SizeX && Y < Chunk->SizeY)
 	{
-		Result = &Chunk->Tiles[Index];
+		Result = &Chunk->Tiles[Y * Chunk->SizeX + X];
 	}
 
 
 	return Result;
 }
 
-static tile_vertex_data *
+// Writes the four corners of a Width x Height tile rectangle. UVs are in tiles.
+static uint32_t
+EmitTileQuad(uint32_t X, uint32_t Y, uint32_t Width, uint32_t Height, uint8_t TileID, tile_vertex_packed *Vertices)
+{
+	for (uint32_t Vertex = 0; Vertex < ArrayCount(TileQuad); ++Vertex)
+	{
+		vec3 Corner = TileQuad[Vertex].Position;
+		vec3 Local  = Vec3(X + Corner.X * Width, Y + Corner.Y * Height, Corner.Z);
+		vec2 UV     = Vec2(TileQuad[Vertex].UV.X * Width, TileQuad[Vertex].UV.Y * Height);
+
+		Vertices[Vertex] = PackTileVertex(Local, UV, TileID);
+	}
+
+	return ArrayCount(TileQuad);
+}
+
+
+// Positions are chunk-local, the origin is applied by the vertex shader.
+static tile_vertex_packed *
 GetChunkMeshData(chunk *Chunk, memory_arena *Arena)
 {
-	uint32_t          Count    = 0;
-	tile_vertex_data *Vertices = PushArray(Arena, tile_vertex_data, Chunk->SizeX * Chunk->SizeY * 6);
+	static_assert(CHUNK_SIZE_X <= 255 && CHUNK_SIZE_Y <= 255, "Chunk coordinates must fit in 8 bits");
+
+	uint32_t            Count       = 0;
+	uint32_t            VertexCount = Chunk->SizeX * Chunk->SizeY * ArrayCount(TileQuad);
+	tile_vertex_packed *Vertices    = PushArray(Arena, tile_vertex_packed, VertexCount);
 
-	for (float Y = 0; Y < Chunk->SizeY; ++Y)
+	for (uint32_t Y = 0; Y < Chunk->SizeY; ++Y)
 	{
-		for (float X = 0; X < Chunk->SizeX; ++X)
+		for (uint32_t X = 0; X < Chunk->SizeX; ++X)
 		{
-			vec3 Offset = Vec3(X, Y, 0);
+			Count += EmitTileQuad(X, Y, 1, 1, GetTile(X, Y, Chunk)->Data, Vertices + Count);
+		}
+	}
 
-			for (uint32_t Vertex = 0; Vertex < 6; ++Vertex)
+	Chunk->VertexCount = Count;
+	Chunk->QuadCount   = Count / ArrayCount(TileQuad);
+	Chunk->IndexCount  = Chunk->QuadCount * TILE_QUAD_INDEX_COUNT;
+
+	return Vertices;
+}
+
+
+// Scans row by row. Each unmeshed tile starts a quad that grows right while the Data
+// matches, then up while the whole row segment matches. Worst case (no two neighbours
+// alike) is one quad per tile, like GetChunkMeshData.
+static tile_vertex_packed *
+GetChunkGreedyMeshData(chunk *Chunk, memory_arena *Arena)
+{
+	ProfileBegin(GreedyMeshChunk);
+
+	uint32_t            Count     = 0;
+	uint32_t            TileCount = Chunk->SizeX * Chunk->SizeY;
+	tile_vertex_packed *Vertices  = PushArray(Arena, tile_vertex_packed, TileCount * ArrayCount(TileQuad));
+
+	memory_region Region = EnterMemoryRegion(Arena);
+	uint8_t      *Meshed = PushArray(Arena, uint8_t, TileCount);
+	memset(Meshed, 0, TileCount);
+
+	for (uint32_t Y = 0; Y < Chunk->SizeY; ++Y)
+	{
+		for (uint32_t X = 0; X < Chunk->SizeX; ++X)
+		{
+			uint32_t Start = Y * Chunk->SizeX + X;
+			if (Meshed[Start])
 			{
-				Vertices[Count]          = TileQuad[Vertex];
-				Vertices[Count].Position = Vec3Add(Vertices[Count].Position, Offset);
+				continue;
+			}
+
+			uint8_t  Data  = Chunk->Tiles[Start].Data;
+			uint32_t Width = 1;
+
+			while (X + Width < Chunk->SizeX && !Meshed[Start + Width] && Chunk->Tiles[Start + Width].Data == Data)
+			{
+				++Width;
+			}
+
+			uint32_t Height = 1;
+			for (; Y + Height < Chunk->SizeY; ++Height)
+			{
+				uint32_t Row   = Start + Height * Chunk->SizeX;
+				bool     Match = true;
+
+				for (uint32_t Idx = 0; Idx < Width && Match; ++Idx)
+				{
+					Match = !Meshed[Row + Idx] && Chunk->Tiles[Row + Idx].Data == Data;
+				}
 
-				++Count;
+				if (!Match)
+				{
+					break;
+				}
 			}
+
+			for (uint32_t Row = 0; Row < Height; ++Row)
+			{
+				memset(Meshed + Start + Row * Chunk->SizeX, 1, Width);
+			}
+
+			Count += EmitTileQuad(X, Y, Width, Height, Data, Vertices + Count);
 		}
 	}
 
+	LeaveMemoryRegion(Region);
+
 	Chunk->VertexCount = Count;
+	Chunk->QuadCount   = Count / ArrayCount(TileQuad);
+	Chunk->IndexCount  = Chunk->QuadCount * TILE_QUAD_INDEX_COUNT;
+
+	ProfileEnd(GreedyMeshChunk);
 
 	return Vertices;
 }
 
 
-chunk CreateChunk(renderer *Renderer, memory_arena *Arena)
+static void
+FillTileInstances(uint32_t First, uint32_t Count, chunk *Chunk, tile_instance *Instances)
+{
+	for (uint32_t Idx = 0; Idx < Count; ++Idx)
+	{
+		uint32_t Tile = First + Idx;
+
+		Instances[Idx].X      = (uint8_t)(Tile % Chunk->SizeX);
+		Instances[Idx].Y      = (uint8_t)(Tile / Chunk->SizeX);
+		Instances[Idx].TileID = Chunk->Tiles[Tile].Data;
+	}
+}
+
+
+static tile_instance *
+GetChunkTileInstances(chunk *Chunk, memory_arena *Arena)
+{
+	uint32_t       Count     = Chunk->SizeX * Chunk->SizeY;
+	tile_instance *Instances = PushArray(Arena, tile_instance, Count);
+
+	FillTileInstances(0, Count, Chunk, Instances);
+
+	Chunk->InstanceCount = Count;
+
+	return Instances;
+}
+
+
+chunk MakeChunk(ChunkMesh_Type Mesh, vec3 Origin)
 {
 	chunk Chunk =
 	{
-		.SizeX    = CHUNK_SIZE_X,
-		.SizeY    = CHUNK_SIZE_Y,
-		.Material = GetDefaultMaterial(Renderer, Arena),
+		.SizeX       = CHUNK_SIZE_X,
+		.SizeY       = CHUNK_SIZE_Y,
+		.Mesh        = Mesh,
+		.MeshVersion = 1,
+		.Origin      = Origin,
 	};
 
+	return Chunk;
+}
+
+
+chunk_mesh_data BuildChunkMesh(chunk *Chunk, memory_arena *Arena)
+{
+	chunk_mesh_data Data = {0};
+
+	if (Chunk->Mesh == ChunkMesh_Tiles)
+	{
+		Data.Instances = GetChunkTileInstances(Chunk, Arena);
+	}
+	else
+	{
+		Data.Vertices = Chunk->Mesh == ChunkMesh_Greedy ? GetChunkGreedyMeshData(Chunk, Arena) : GetChunkMeshData(Chunk, Arena);
+	}
+
+	return Data;
+}
+
+
+uint64_t UploadChunkMesh(byte_string Name, chunk_mesh_data *Data, chunk *Chunk, renderer *Renderer, memory_arena *Arena)
+{
+	uint64_t Uploaded = 0;
+
+	Chunk->Material = GetDefaultMaterial(Renderer, Arena);
+
+	if (Chunk->Mesh == ChunkMesh_Tiles)
+	{
+		uint64_t InstanceDataSize = Chunk->InstanceCount * sizeof(tile_instance);
+
+		resource_handle InstanceBuffer = UpdateVertexBuffer(Name, Data->Instances, InstanceDataSize, Arena, Renderer);
+		Chunk->InstanceBuffer = BindResourceHandle(InstanceBuffer, Renderer->Resources);
+
+		Uploaded += InstanceDataSize;
+	}
+	else
+	{
+		uint64_t VertexDataSize = Chunk->VertexCount * sizeof(tile_vertex_packed);
+
+		resource_handle VertexBuffer = UpdateVertexBuffer(Name, Data->Vertices, VertexDataSize, Arena, Renderer);
+		Chunk->VertexBuffer = BindResourceHandle(VertexBuffer, Renderer->Resources);
+
+		Uploaded += VertexDataSize;
+	}
+
+	return Uploaded;
+}
+
+
+chunk CreateChunk(byte_string Name, ChunkMesh_Type Mesh, renderer *Renderer, memory_arena *Arena)
+{
+	ProfileBegin(CreateChunk);
 
-	tile_vertex_data *VertexData     = GetChunkMeshData(&Chunk, Arena);
-	uint64_t          VertexDataSize = Chunk.SizeX * Chunk.SizeY * 6 * sizeof(tile_vertex_data);
+	chunk           Chunk = MakeChunk(Mesh, Vec3(0.f, 0.f, 0.f));
+	chunk_mesh_data Data  = BuildChunkMesh(&Chunk, Arena);
 
-	resource_handle VertexBuffer = UpdateVertexBuffer(ByteStringLiteral("chunk_geometry"), VertexData, VertexDataSize, Arena, Renderer);
-	Chunk.VertexBuffer = BindResourceHandle(VertexBuffer, Renderer->Resources);
+	UploadChunkMesh(Name, &Data, &Chunk, Renderer, Arena);
+
+	ProfileEnd(CreateChunk);
 
 	return Chunk;
 }
 
 
+void ReleaseChunk(chunk *Chunk, renderer *Renderer)
+{
+	ReleaseBuffer(Chunk->VertexBuffer, Renderer);
+	ReleaseBuffer(Chunk->InstanceBuffer, Renderer);
+
+	Chunk->VertexBuffer   = (resource_handle){0};
+	Chunk->InstanceBuffer = (resource_handle){0};
+}
+
+
+bool SetTile(uint32_t X, uint32_t Y, uint8_t Data, chunk *Chunk)
+{
+	tile *Tile = GetTile(X, Y, Chunk);
+	if (!Tile || Tile->Data == Data)
+	{
+		return false;
+	}
+
+	Tile->Data = Data;
+
+	bool WasClean = !Chunk->Dirty;
+	if (WasClean)
+	{
+		Chunk->DirtyMinX = (uint16_t)X;
+		Chunk->DirtyMinY = (uint16_t)Y;
+		Chunk->DirtyMaxX = (uint16_t)(X + 1);
+		Chunk->DirtyMaxY = (uint16_t)(Y + 1);
+		Chunk->Dirty     = true;
+	}
+	else
+	{
+		Chunk->DirtyMinX = (uint16_t)Minimum(Chunk->DirtyMinX, X);
+		Chunk->DirtyMinY = (uint16_t)Minimum(Chunk->DirtyMinY, Y);
+		Chunk->DirtyMaxX = (uint16_t)Maximum(Chunk->DirtyMaxX, X + 1);
+		Chunk->DirtyMaxY = (uint16_t)Maximum(Chunk->DirtyMaxY, Y + 1);
+	}
+
+	return WasClean;
+}
+
+
+// Per-tile layouts (Vertices, Tiles) keep tile N at a fixed offset, so each dirty row
+// segment is one in-place range write. Greedy quads can span the dirty rectangle, so
+// greedy chunks are remeshed whole; that is bounded by the chunk size.
+void UpdateChunkMesh(chunk *Chunk, renderer *Renderer, memory_arena *Arena)
+{
+	if (!Chunk->Dirty || !Renderer || !Arena)
+	{
+		return;
+	}
+
+	ProfileBegin(UpdateChunkMesh);
+
+	memory_region Region = EnterMemoryRegion(Arena);
+
+	if (Chunk->Mesh == ChunkMesh_Greedy)
+	{
+		uint32_t            QuadCount = Chunk->QuadCount;
+		tile_vertex_packed *Vertices  = GetChunkGreedyMeshData(Chunk, Arena);
+
+		WriteBuffer(Chunk->VertexBuffer, Vertices, Chunk->VertexCount * sizeof(tile_vertex_packed), Renderer);
+
+		if (Chunk->QuadCount != QuadCount)
+		{
+			++Chunk->MeshVersion;
+		}
+	}
+	else
+	{
+		uint32_t Width = Chunk->DirtyMaxX - Chunk->DirtyMinX;
+
+		for (uint32_t Y = Chunk->DirtyMinY; Y < Chunk->DirtyMaxY; ++Y)
+		{
+			uint32_t First = Y * Chunk->SizeX + Chunk->DirtyMinX;
+
+			if (Chunk->Mesh == ChunkMesh_Tiles)
+			{
+				tile_instance Instances[CHUNK_SIZE_X];
+				FillTileInstances(First, Width, Chunk, Instances);
+
+				WriteBufferRange(Chunk->InstanceBuffer, First * sizeof(tile_instance), Instances, Width * sizeof(tile_instance), Renderer);
+			}
+			else
+			{
+				tile_vertex_packed Vertices[CHUNK_SIZE_X * ArrayCount(TileQuad)];
+				uint32_t           Count = 0;
+
+				for (uint32_t X = Chunk->DirtyMinX; X < Chunk->DirtyMaxX; ++X)
+				{
+					Count += EmitTileQuad(X, Y, 1, 1, GetTile(X, Y, Chunk)->Data, Vertices + Count);
+				}
+
+				uint64_t Offset = (uint64_t)First * ArrayCount(TileQuad) * sizeof(tile_vertex_packed);
+				WriteBufferRange(Chunk->VertexBuffer, Offset, Vertices, Count * sizeof(tile_vertex_packed), Renderer);
+			}
+		}
+	}
+
+	LeaveMemoryRegion(Region);
+
+	Chunk->Dirty = false;
+
+	ProfileEnd(UpdateChunkMesh);
+}
+
+
 void DrawChunk(camera *Camera, renderer *Renderer, memory_arena *Arena, chunk *Chunk)
 {
-	DrawChunkIntance(Chunk->VertexBuffer, Chunk->VertexCount, Chunk->Material, Camera, Renderer, Arena);
+	DrawChunks(Camera, Renderer, Arena, Chunk, 1, 0);
+}
+
+
+// Sort depth is the distance from the near plane over the clip range, so the
+// renderer can order chunks front to back within a material.
+static float
+GetChunkSortDepth(chunk *Chunk, plane *NearPlane, float InvDepthRange)
+{
+	vec3  Center = Vec3(Chunk->Origin.X + 0.5f * Chunk->SizeX, Chunk->Origin.Y + 0.5f * Chunk->SizeY, Chunk->Origin.Z);
+	float Result = (Vec3Dot(NearPlane->Normal, Center) + NearPlane->Offset) * InvDepthRange;
+
+	return Result;
+}
+
+
+static void
+SubmitChunk(chunk *Chunk, float Depth, camera *Camera, render_context *Context)
+{
+	if (Chunk->Mesh == ChunkMesh_Tiles)
+	{
+		DrawChunkTiles(Chunk->InstanceBuffer, Chunk->InstanceCount, Chunk->Material, Chunk->Origin, Depth, Camera, Context);
+	}
+	else
+	{
+		DrawChunkIntance(Chunk->VertexBuffer, Chunk->VertexCount, (resource_handle){0}, Chunk->IndexCount, RenderIndex_Quads,
+		                 Chunk->Material, Chunk->Origin, Depth, Camera, Context);
+	}
+}
+
+
+typedef struct
+{
+	chunk    *Chunks;
+	uint32_t *Visible;
+	uint32_t  VisibleCount;
+	uint32_t  BlockSize;
+	plane     NearPlane;
+	float     InvDepthRange;
+	camera   *Camera;
+	renderer *Renderer;
+} chunk_draw_job;
+
+
+static void
+RecordChunkDraws(uint64_t FirstBlock, uint64_t LastBlock, void *Context)
+{
+	chunk_draw_job *Job = (chunk_draw_job *)Context;
+
+	for (uint64_t Block = FirstBlock; Block < LastBlock; ++Block)
+	{
+		render_context *RenderContext = GetRenderContext(1 + (uint32_t)Block, Job->Renderer);
+		uint32_t        Begin         = (uint32_t)Block * Job->BlockSize;
+		uint32_t        End           = Minimum(Begin + Job->BlockSize, Job->VisibleCount);
+
+		for (uint32_t Idx = Begin; Idx < End; ++Idx)
+		{
+			chunk *Chunk = &Job->Chunks[Job->Visible[Idx]];
+			float  Depth = GetChunkSortDepth(Chunk, &Job->NearPlane, Job->InvDepthRange);
+
+			SubmitChunk(Chunk, Depth, Job->Camera, RenderContext);
+		}
+	}
+}
+
+
+// Chunk meshes are built in world space from the origin, so the bounds are the
+// origin plus the tile extent, flat on Z.
+uint32_t DrawChunks(camera *Camera, renderer *Renderer, memory_arena *Arena, chunk *Chunks, uint32_t ChunkCount, engine_memory *EngineMemory)
+{
+	if (!Camera || !Chunks || !ChunkCount)
+	{
+		return 0;
+	}
+
+	ProfileBegin(DrawChunks);
+
+	// Draws are recorded into the render contexts' arenas, so the culling scratch can
+	// be released before returning.
+	memory_region Region = EnterMemoryRegion(Arena);
+
+	vec3_soa  Centers = PushVec3SoA(Arena, ChunkCount);
+	vec3_soa  Extents = PushVec3SoA(Arena, ChunkCount);
+	uint32_t *Visible = PushArray(Arena, uint32_t, ChunkCount);
+
+	for (uint32_t Idx = 0; Idx < ChunkCount; ++Idx)
+	{
+		chunk *Chunk     = &Chunks[Idx];
+		float  HalfSizeX = 0.5f * Chunk->SizeX;
+		float  HalfSizeY = 0.5f * Chunk->SizeY;
+
+		Centers.X[Idx] = Chunk->Origin.X + HalfSizeX;
+		Centers.Y[Idx] = Chunk->Origin.Y + HalfSizeY;
+		Centers.Z[Idx] = Chunk->Origin.Z;
+		Extents.X[Idx] = HalfSizeX;
+		Extents.Y[Idx] = HalfSizeY;
+		Extents.Z[Idx] = 0.f;
+	}
+
+	camera_cache *Cache        = GetCameraCache(Camera);
+	uint32_t      VisibleCount = (uint32_t)Vec3BatchCullBoxes(Centers, Extents, Cache->Planes, FrustumPlane_Count, Visible, ChunkCount);
+
+	// Blocks map to fixed contexts, so the merged order does not depend on which
+	// thread recorded what.
+	uint32_t BlockCount = (VisibleCount + CHUNK_DRAWS_PER_BLOCK - 1) / CHUNK_DRAWS_PER_BLOCK;
+	BlockCount = Minimum(BlockCount, RENDER_MAX_CONTEXTS - 1);
+
+	if (BlockCount)
+	{
+		chunk_draw_job Job =
+		{
+			.Chunks        = Chunks,
+			.Visible       = Visible,
+			.VisibleCount  = VisibleCount,
+			.BlockSize     = (VisibleCount + BlockCount - 1) / BlockCount,
+			.NearPlane     = Cache->Planes[FrustumPlane_Near],
+			.InvDepthRange = 1.f / (Camera->FarPlane - Camera->NearPlane),
+			.Camera        = Camera,
+			.Renderer      = Renderer,
+		};
+
+		ParallelFor(0, BlockCount, 1, RecordChunkDraws, &Job, EngineMemory);
+	}
+
+	LeaveMemoryRegion(Region);
+
+	ProfileEnd(DrawChunks);
+
+	return VisibleCount;
+}
+
+
+void RecordChunks(camera *Camera, render_context *Context, chunk *Chunks, uint32_t ChunkCount)
+{
+	if (!Camera || !Context || !Chunks)
+	{
+		return;
+	}
+
+	camera_cache *Cache         = GetCameraCache(Camera);
+	float         InvDepthRange = 1.f / (Camera->FarPlane - Camera->NearPlane);
+
+	for (uint32_t Idx = 0; Idx < ChunkCount; ++Idx)
+	{
+		chunk *Chunk = &Chunks[Idx];
+		float  Depth = GetChunkSortDepth(Chunk, &Cache->Planes[FrustumPlane_Near], InvDepthRange);
+
+		SubmitChunk(Chunk, Depth, Camera, Context);
+	}
 }
\ No newline at end of file
@@ -6,11 +6,14 @@
 #include "engine/rendering/renderer_internal.h"
 
 
-typedef struct camera       camera;
-typedef struct renderer     renderer;
-typedef struct memory_arena memory_arena;
+typedef struct camera         camera;
+typedef struct renderer       renderer;
+typedef struct render_context render_context;
+typedef struct memory_arena   memory_arena;
+typedef struct engine_memory  engine_memory;
 
 
+// Tile vertices and instances store chunk-local coordinates in 8 bits.
 #define CHUNK_SIZE_X 16
 #define CHUNK_SIZE_Y 16
 
@@ -19,18 +22,79 @@ typedef struct
 	uint8_t Data;
 } tile;
 
+// Vertices expands every tile into four tile_vertex_packed, drawn with the renderer's
+// shared quad indices (RenderIndex_Quads), so no index data is uploaded. Tiles uploads
+// one tile_instance per tile (4 bytes) and lets the vertex shader build the quads.
+// Greedy merges neighbouring tiles with the same Data into rectangles; their UVs count
+// tiles, so the texture repeats once per tile.
+typedef enum ChunkMesh_Type
+{
+	ChunkMesh_Vertices = 0,
+	ChunkMesh_Tiles    = 1,
+	ChunkMesh_Greedy   = 2,
+} ChunkMesh_Type;
+
 typedef struct
 {
 	tile             Tiles[CHUNK_SIZE_X * CHUNK_SIZE_Y];
 	uint16_t         SizeX;
 	uint16_t         SizeY;
 
+	ChunkMesh_Type   Mesh;
 	resource_handle  Material;
 	resource_handle  VertexBuffer;
 	uint32_t         VertexCount;
+	uint32_t         QuadCount;
+	uint32_t         IndexCount;
+	resource_handle  InstanceBuffer;
+	uint32_t         InstanceCount;
+
+	// Changes when the draw counts change, i.e. when recorded draws go stale.
+	uint32_t         MeshVersion;
+
+	// Tiles written since the last UpdateChunkMesh, [Min, Max).
+	bool             Dirty;
+	uint16_t         DirtyMinX;
+	uint16_t         DirtyMinY;
+	uint16_t         DirtyMaxX;
+	uint16_t         DirtyMaxY;
 
 	vec3             Origin;
 } chunk;
 
-chunk CreateChunk(renderer *Renderer, memory_arena *Arena);
-void DrawChunk(camera *Camera, renderer *Renderer, memory_arena *Arena, chunk *Chunk);
\ No newline at end of file
+// Mesh arrays built by BuildChunkMesh, in the arena it was given. Only the arrays
+// used by the chunk's mesh type are set.
+typedef struct
+{
+	tile_vertex_packed *Vertices;
+	tile_instance      *Instances;
+} chunk_mesh_data;
+
+// Buffers are named after 'Name', which must be unique among live chunks.
+chunk CreateChunk(byte_string Name, ChunkMesh_Type Mesh, renderer *Renderer, memory_arena *Arena);
+
+// CreateChunk in two halves, for chunks built off the main thread. MakeChunk and
+// BuildChunkMesh only touch the chunk and the arena. UploadChunkMesh creates the
+// buffers and returns the number of bytes uploaded.
+chunk           MakeChunk       (ChunkMesh_Type Mesh, vec3 Origin);
+chunk_mesh_data BuildChunkMesh  (chunk *Chunk, memory_arena *Arena);
+uint64_t        UploadChunkMesh (byte_string Name, chunk_mesh_data *Data, chunk *Chunk, renderer *Renderer, memory_arena *Arena);
+
+// Releases the chunk's buffers. The tiles are kept.
+void ReleaseChunk(chunk *Chunk, renderer *Renderer);
+
+// Returns true when the chunk was clean, so it can be queued for UpdateChunkMesh once.
+bool SetTile(uint32_t X, uint32_t Y, uint8_t Data, chunk *Chunk);
+
+// Uploads the tiles written since the last call. Does nothing for clean chunks.
+void UpdateChunkMesh(chunk *Chunk, renderer *Renderer, memory_arena *Arena);
+void DrawChunk(camera *Camera, renderer *Renderer, memory_arena *Arena, chunk *Chunk);
+
+// Only chunks whose bounds intersect the camera frustum are submitted. Returns the
+// number of chunks drawn. Visible chunks are recorded in blocks, block N into render
+// context N + 1. With 'EngineMemory' the blocks are spread over the worker pool.
+uint32_t DrawChunks(camera *Camera, renderer *Renderer, memory_arena *Arena, chunk *Chunks, uint32_t ChunkCount, engine_memory *EngineMemory);
+
+// Records every chunk, without culling, into 'Context'. Meant for retained lists of
+// static chunks (see BeginRetainedList).
+void RecordChunks(camera *Camera, render_context *Context, chunk *Chunks, uint32_t ChunkCount);
\ No newline at end of file
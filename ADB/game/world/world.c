@@ -0,0 +1,516 @@
+#include "world.h"
+
+#include <assert.h>
+#include <math.h>
+#include <stdint.h>
+#include <stdio.h>
+#include <string.h>
+
+#include "utilities.h"
+#include "platform/platform.h"
+#include "engine/math/vector.h"
+#include "engine/rendering/renderer.h"
+#include "engine/rendering/resources.h"
+#include "engine/profiler/profiler.h"
+
+
+#define WORLD_MAP_EMPTY        0
+#define WORLD_MAP_JOB          0x80000000u
+
+#define WORLD_NOISE_CELL_SIZE  8
+#define WORLD_TILE_KINDS       4
+
+
+// 'Value' is WORLD_MAP_EMPTY, 1 + the index of a loaded chunk, or WORLD_MAP_JOB with
+// the index of the job building the chunk.
+typedef struct world_map_entry
+{
+	chunk_coord Coord;
+	uint32_t    Value;
+} world_map_entry;
+
+
+// The counter is raised while the job is queued or running. The main thread only
+// touches the chunk and the arena once it is back to zero.
+typedef struct world_build_job
+{
+	platform_work_counter Counter;
+	bool                  InUse;
+	uint32_t              Sequence;
+	uint32_t              Seed;
+	chunk_coord           Coord;
+	chunk                 Chunk;
+	chunk_mesh_data       Data;
+	memory_arena         *Arena;
+} world_build_job;
+
+
+static uint32_t
+HashCoord(int32_t X, int32_t Y, uint32_t Seed)
+{
+	uint32_t Hash = Seed ^ ((uint32_t)X * 0x9E3779B1u) ^ ((uint32_t)Y * 0x85EBCA77u);
+
+	Hash ^= Hash >> 15;
+	Hash *= 0x2C1B3C6Du;
+	Hash ^= Hash >> 12;
+	Hash *= 0x297A2D39u;
+	Hash ^= Hash >> 15;
+
+	return Hash;
+}
+
+
+static bool
+ChunkCoordAreEqual(chunk_coord A, chunk_coord B)
+{
+	bool Result = A.X == B.X && A.Y == B.Y;
+	return Result;
+}
+
+
+// Chebyshev distance, so the loaded region is a square of chunks.
+static bool
+IsWithinRadius(chunk_coord Coord, chunk_coord Center, uint32_t Radius)
+{
+	int64_t DistanceX = (int64_t)Coord.X - Center.X;
+	int64_t DistanceY = (int64_t)Coord.Y - Center.Y;
+
+	bool Result = DistanceX >= -(int64_t)Radius && DistanceX <= Radius && DistanceY >= -(int64_t)Radius && DistanceY <= Radius;
+	return Result;
+}
+
+
+static int32_t
+FloorDivide(int32_t Value, int32_t Divisor)
+{
+	int32_t Result = Value / Divisor;
+	if ((Value % Divisor) != 0 && (Value < 0) != (Divisor < 0))
+	{
+		--Result;
+	}
+
+	return Result;
+}
+
+
+// =====================================================
+// [SECTION] Chunk Map
+// [DESCRIP]
+//   Open addressing with linear probing. Removal shifts
+//   the rest of the probe run back instead of leaving
+//   tombstones, so lookups stay short however many
+//   chunks stream through.
+// =====================================================
+
+
+static world_map_entry *
+FindMapEntry(chunk_coord Coord, world *World)
+{
+	uint32_t Slot = HashCoord(Coord.X, Coord.Y, 0) & World->MapMask;
+
+	while (World->Map[Slot].Value != WORLD_MAP_EMPTY && !ChunkCoordAreEqual(World->Map[Slot].Coord, Coord))
+	{
+		Slot = (Slot + 1) & World->MapMask;
+	}
+
+	return &World->Map[Slot];
+}
+
+
+static void
+RemoveMapEntry(world_map_entry *Entry, world *World)
+{
+	uint32_t Mask = World->MapMask;
+	uint32_t Hole = (uint32_t)(Entry - World->Map);
+	uint32_t Slot = Hole;
+
+	for (;;)
+	{
+		Slot = (Slot + 1) & Mask;
+		if (World->Map[Slot].Value == WORLD_MAP_EMPTY)
+		{
+			break;
+		}
+
+		// An entry can fill the hole when its home slot is not between the hole and itself.
+		uint32_t Home = HashCoord(World->Map[Slot].Coord.X, World->Map[Slot].Coord.Y, 0) & Mask;
+		if (((Slot - Home) & Mask) >= ((Slot - Hole) & Mask))
+		{
+			World->Map[Hole] = World->Map[Slot];
+			Hole             = Slot;
+		}
+	}
+
+	World->Map[Hole].Value = WORLD_MAP_EMPTY;
+}
+
+
+// =====================================================
+// [SECTION] Chunk Generation
+// =====================================================
+
+
+static float
+GetLatticeValue(int32_t X, int32_t Y, uint32_t Seed)
+{
+	float Result = (float)(HashCoord(X, Y, Seed) & 0xFFFF) / 65536.f;
+	return Result;
+}
+
+
+// Value noise over a lattice of WORLD_NOISE_CELL_SIZE tiles, cut into a few kinds of
+// tile. Neighbouring tiles mostly match, which is what greedy meshing merges.
+static void
+GenerateChunkTiles(chunk_coord Coord, uint32_t Seed, chunk *Chunk)
+{
+	for (uint32_t Y = 0; Y < Chunk->SizeY; ++Y)
+	{
+		int32_t TileY   = Coord.Y * CHUNK_SIZE_Y + (int32_t)Y;
+		int32_t CellY   = FloorDivide(TileY, WORLD_NOISE_CELL_SIZE);
+		float   FracY   = (float)(TileY - CellY * WORLD_NOISE_CELL_SIZE) / WORLD_NOISE_CELL_SIZE;
+		float   SmoothY = FracY * FracY * (3.f - 2.f * FracY);
+
+		for (uint32_t X = 0; X < Chunk->SizeX; ++X)
+		{
+			int32_t TileX   = Coord.X * CHUNK_SIZE_X + (int32_t)X;
+			int32_t CellX   = FloorDivide(TileX, WORLD_NOISE_CELL_SIZE);
+			float   FracX   = (float)(TileX - CellX * WORLD_NOISE_CELL_SIZE) / WORLD_NOISE_CELL_SIZE;
+			float   SmoothX = FracX * FracX * (3.f - 2.f * FracX);
+
+			float Value00 = GetLatticeValue(CellX,     CellY,     Seed);
+			float Value10 = GetLatticeValue(CellX + 1, CellY,     Seed);
+			float Value01 = GetLatticeValue(CellX,     CellY + 1, Seed);
+			float Value11 = GetLatticeValue(CellX + 1, CellY + 1, Seed);
+
+			float Bottom = Value00 + SmoothX * (Value10 - Value00);
+			float Top    = Value01 + SmoothX * (Value11 - Value01);
+			float Value  = Bottom + SmoothY * (Top - Bottom);
+
+			uint32_t Kind = (uint32_t)(Value * WORLD_TILE_KINDS);
+			Chunk->Tiles[Y * Chunk->SizeX + X].Data = (uint8_t)Minimum(Kind, WORLD_TILE_KINDS - 1);
+		}
+	}
+}
+
+
+static void
+BuildChunkJob(platform_work_queue *Queue, void *Data)
+{
+	(void)Queue;
+
+	ProfileBegin(BuildChunk);
+
+	world_build_job *Job = (world_build_job *)Data;
+
+	GenerateChunkTiles(Job->Coord, Job->Seed, &Job->Chunk);
+	Job->Data = BuildChunkMesh(&Job->Chunk, Job->Arena);
+
+	ProfileEnd(BuildChunk);
+}
+
+
+// =====================================================
+// [SECTION] World API
+// =====================================================
+
+
+world *
+CreateWorld(world_params Params, memory_arena *Arena)
+{
+	if (!Arena || !Params.BuildJobCount)
+	{
+		return 0;
+	}
+
+	Params.UnloadRadius = Maximum(Params.UnloadRadius, Params.LoadRadius);
+
+	world *World = PushStruct(Arena, world);
+	if (!World)
+	{
+		return 0;
+	}
+
+	memset(World, 0, sizeof(world));
+
+	uint32_t Side     = 2 * Params.UnloadRadius + 1;
+	uint32_t MapCount = 1;
+	while (MapCount < 2 * (Side * Side + Params.BuildJobCount))
+	{
+		MapCount *= 2;
+	}
+
+	World->Params        = Params;
+	World->ChunkCapacity = Side * Side;
+	World->Chunks        = PushArray(Arena, chunk, World->ChunkCapacity);
+	World->Coords        = PushArray(Arena, chunk_coord, World->ChunkCapacity);
+	World->Dirty         = PushArray(Arena, chunk_coord, World->ChunkCapacity);
+	World->MapMask       = MapCount - 1;
+	World->Map           = PushArray(Arena, world_map_entry, MapCount);
+	World->Jobs          = PushArray(Arena, world_build_job, Params.BuildJobCount);
+
+	if (!World->Chunks || !World->Coords || !World->Dirty || !World->Map || !World->Jobs)
+	{
+		return 0;
+	}
+
+	memset(World->Map, 0, MapCount * sizeof(world_map_entry));
+	memset(World->Jobs, 0, Params.BuildJobCount * sizeof(world_build_job));
+
+	for (uint32_t JobIdx = 0; JobIdx < Params.BuildJobCount; ++JobIdx)
+	{
+		memory_arena_params ArenaParams =
+		{
+			.AllocatedFromFile = __FILE__,
+			.AllocatedFromLine = __LINE__,
+			.ReserveSize       = MiB(1),
+			.CommitSize        = KiB(64),
+		};
+
+		World->Jobs[JobIdx].Arena = AllocateArena(ArenaParams);
+		if (!World->Jobs[JobIdx].Arena)
+		{
+			return 0;
+		}
+	}
+
+	return World;
+}
+
+
+static void
+UnloadChunk(uint32_t Index, world *World, renderer *Renderer)
+{
+	ReleaseChunk(&World->Chunks[Index], Renderer);
+	RemoveMapEntry(FindMapEntry(World->Coords[Index], World), World);
+
+	uint32_t Last = --World->ChunkCount;
+	if (Index != Last)
+	{
+		World->Chunks[Index] = World->Chunks[Last];
+		World->Coords[Index] = World->Coords[Last];
+
+		FindMapEntry(World->Coords[Index], World)->Value = Index + 1;
+	}
+
+	++World->Stats.Unloaded;
+}
+
+
+// Oldest finished job first, so chunks come in the order they were queued (nearest
+// first).
+static world_build_job *
+GetFinishedJob(world *World)
+{
+	world_build_job *Result = 0;
+
+	for (uint32_t JobIdx = 0; JobIdx < World->Params.BuildJobCount; ++JobIdx)
+	{
+		world_build_job *Job = &World->Jobs[JobIdx];
+
+		if (Job->InUse && Job->Counter.Value == 0 && (!Result || Job->Sequence < Result->Sequence))
+		{
+			Result = Job;
+		}
+	}
+
+	return Result;
+}
+
+
+static void
+LoadFinishedChunk(world_build_job *Job, world *World, renderer *Renderer, memory_arena *Scratch)
+{
+	assert(World->ChunkCount < World->ChunkCapacity);
+
+	uint32_t Index = World->ChunkCount++;
+	World->Chunks[Index] = Job->Chunk;
+	World->Coords[Index] = Job->Coord;
+
+	char Name[64];
+	int  NameLength = snprintf(Name, sizeof(Name), "chunk::%d::%d", Job->Coord.X, Job->Coord.Y);
+
+	World->Stats.UploadedBytes += UploadChunkMesh(ByteString((uint8_t *)Name, (uint64_t)NameLength), &Job->Data, &World->Chunks[Index], Renderer, Scratch);
+	++World->Stats.Loaded;
+
+	FindMapEntry(Job->Coord, World)->Value = Index + 1;
+}
+
+
+static bool
+QueueChunk(world_map_entry *Entry, chunk_coord Coord, world *World, engine_memory *EngineMemory)
+{
+	uint32_t JobIdx = 0;
+	while (JobIdx < World->Params.BuildJobCount && World->Jobs[JobIdx].InUse)
+	{
+		++JobIdx;
+	}
+
+	if (JobIdx == World->Params.BuildJobCount)
+	{
+		return false;
+	}
+
+	world_build_job *Job = &World->Jobs[JobIdx];
+	ClearArena(Job->Arena);
+
+	vec3 Origin = Vec3((float)Coord.X * CHUNK_SIZE_X, (float)Coord.Y * CHUNK_SIZE_Y, 0.f);
+
+	Job->InUse    = true;
+	Job->Sequence = World->NextSequence++;
+	Job->Seed     = World->Params.Seed;
+	Job->Coord    = Coord;
+	Job->Chunk    = MakeChunk(World->Params.Mesh, Origin);
+
+	Entry->Coord = Coord;
+	Entry->Value = WORLD_MAP_JOB | JobIdx;
+
+	if (EngineMemory && EngineMemory->AddBackgroundEntry)
+	{
+		EngineMemory->AddBackgroundEntry(EngineMemory->WorkQueue, BuildChunkJob, Job, &Job->Counter);
+	}
+	else
+	{
+		BuildChunkJob(0, Job);
+	}
+
+	++World->Stats.Queued;
+
+	return true;
+}
+
+
+void
+UpdateWorld(vec3 Focus, world *World, renderer *Renderer, memory_arena *Scratch, engine_memory *EngineMemory)
+{
+	if (!World || !Renderer || !Scratch)
+	{
+		return;
+	}
+
+	ProfileBegin(UpdateWorld);
+
+	memory_region Region = EnterMemoryRegion(Scratch);
+
+	world_params *Params = &World->Params;
+	chunk_coord   Center =
+	{
+		.X = (int32_t)floorf(Focus.X / CHUNK_SIZE_X),
+		.Y = (int32_t)floorf(Focus.Y / CHUNK_SIZE_Y),
+	};
+
+	memset(&World->Stats, 0, sizeof(world_stats));
+
+	// Edits first: a chunk can only be unloaded once it is off the dirty queue.
+	for (uint32_t DirtyIdx = 0; DirtyIdx < World->DirtyCount; ++DirtyIdx)
+	{
+		world_map_entry *Entry = FindMapEntry(World->Dirty[DirtyIdx], World);
+		if (Entry->Value != WORLD_MAP_EMPTY && !(Entry->Value & WORLD_MAP_JOB))
+		{
+			UpdateChunkMesh(&World->Chunks[Entry->Value - 1], Renderer, Scratch);
+			++World->Stats.Edited;
+		}
+	}
+
+	World->DirtyCount = 0;
+
+	for (uint32_t Idx = World->ChunkCount; Idx-- > 0;)
+	{
+		if (!IsWithinRadius(World->Coords[Idx], Center, Params->UnloadRadius))
+		{
+			UnloadChunk(Idx, World, Renderer);
+		}
+	}
+
+	// Chunks that went out of range while they were built are dropped without an upload.
+	for (world_build_job *Job = GetFinishedJob(World); Job; Job = GetFinishedJob(World))
+	{
+		if (!IsWithinRadius(Job->Coord, Center, Params->UnloadRadius))
+		{
+			RemoveMapEntry(FindMapEntry(Job->Coord, World), World);
+			++World->Stats.Discarded;
+		}
+		else if (World->Stats.Loaded == 0 || World->Stats.UploadedBytes < Params->UploadBudget)
+		{
+			LoadFinishedChunk(Job, World, Renderer, Scratch);
+		}
+		else
+		{
+			break;
+		}
+
+		Job->InUse = false;
+	}
+
+	// Rings around the center, nearest first, until every job is busy.
+	bool JobsLeft = true;
+
+	for (int32_t Ring = 0; Ring <= (int32_t)Params->LoadRadius && JobsLeft; ++Ring)
+	{
+		for (int32_t Y = -Ring; Y <= Ring && JobsLeft; ++Y)
+		{
+			int32_t Step = (Y == -Ring || Y == Ring) ? 1 : 2 * Ring;
+
+			for (int32_t X = -Ring; X <= Ring && JobsLeft; X += Step)
+			{
+				chunk_coord      Coord = { .X = Center.X + X, .Y = Center.Y + Y };
+				world_map_entry *Entry = FindMapEntry(Coord, World);
+
+				if (Entry->Value == WORLD_MAP_EMPTY)
+				{
+					JobsLeft = QueueChunk(Entry, Coord, World, EngineMemory);
+				}
+			}
+		}
+	}
+
+	LeaveMemoryRegion(Region);
+
+	ProfileEnd(UpdateWorld);
+}
+
+
+uint32_t
+DrawWorld(camera *Camera, world *World, renderer *Renderer, memory_arena *Arena, engine_memory *EngineMemory)
+{
+	uint32_t Result = 0;
+
+	if (World)
+	{
+		Result = DrawChunks(Camera, Renderer, Arena, World->Chunks, World->ChunkCount, EngineMemory);
+	}
+
+	return Result;
+}
+
+
+bool
+SetWorldTile(int32_t X, int32_t Y, uint8_t Data, world *World)
+{
+	if (!World)
+	{
+		return false;
+	}
+
+	chunk_coord Coord =
+	{
+		.X = FloorDivide(X, CHUNK_SIZE_X),
+		.Y = FloorDivide(Y, CHUNK_SIZE_Y),
+	};
+
+	world_map_entry *Entry = FindMapEntry(Coord, World);
+	if (Entry->Value == WORLD_MAP_EMPTY || (Entry->Value & WORLD_MAP_JOB))
+	{
+		return false;
+	}
+
+	uint32_t LocalX = (uint32_t)(X - Coord.X * CHUNK_SIZE_X);
+	uint32_t LocalY = (uint32_t)(Y - Coord.Y * CHUNK_SIZE_Y);
+
+	if (SetTile(LocalX, LocalY, Data, &World->Chunks[Entry->Value - 1]))
+	{
+		assert(World->DirtyCount < World->ChunkCapacity);
+		World->Dirty[World->DirtyCount++] = Coord;
+	}
+
+	return true;
+}
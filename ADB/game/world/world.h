@@ -0,0 +1,108 @@
+#pragma once
+
+#include <stdint.h>
+#include <stdbool.h>
+
+#include <engine/math/vector.h>
+
+#include "chunk.h"
+
+
+typedef struct camera          camera;
+typedef struct renderer        renderer;
+typedef struct memory_arena    memory_arena;
+typedef struct engine_memory   engine_memory;
+typedef struct world_map_entry world_map_entry;
+typedef struct world_build_job world_build_job;
+
+
+// =====================================================
+// [SECTION] Streaming World
+// [DESCRIP]
+//   Chunks are generated from their coordinates, so the
+//   map has no size: only the chunks around the focus
+//   (usually the camera) are resident. Every chunk
+//   within LoadRadius is loaded, nearest first, and
+//   chunks are unloaded once they are more than
+//   UnloadRadius away, so moving back and forth across
+//   a chunk boundary does not reload anything.
+//
+//   Tiles are generated and meshed by background jobs,
+//   BuildJobCount at a time, each with its own arena.
+//   The main thread only uploads finished meshes, up to
+//   UploadBudget bytes per frame (at least one chunk).
+//   Memory is fixed at creation: the resident chunks fit
+//   in the square of UnloadRadius.
+// =====================================================
+
+
+typedef struct
+{
+	int32_t X;
+	int32_t Y;
+} chunk_coord;
+
+
+typedef struct
+{
+	ChunkMesh_Type Mesh;
+	uint32_t       LoadRadius;
+	uint32_t       UnloadRadius;
+	uint32_t       BuildJobCount;
+	uint64_t       UploadBudget;
+	uint32_t       Seed;
+} world_params;
+
+
+// Reset by every UpdateWorld.
+typedef struct
+{
+	uint32_t Queued;
+	uint32_t Loaded;
+	uint32_t Unloaded;
+	uint32_t Discarded;
+	uint32_t Edited;
+	uint64_t UploadedBytes;
+} world_stats;
+
+
+typedef struct world
+{
+	world_params     Params;
+
+	// Loaded chunks are packed, so they can be handed to DrawChunks as they are.
+	uint32_t         ChunkCapacity;
+	uint32_t         ChunkCount;
+	chunk           *Chunks;
+	chunk_coord     *Coords;
+
+	// Maps a coordinate to a loaded chunk or to the job building it.
+	uint32_t         MapMask;
+	world_map_entry *Map;
+
+	world_build_job *Jobs;
+	uint32_t         NextSequence;
+
+	// Chunks edited since the last UpdateWorld, each once.
+	uint32_t         DirtyCount;
+	chunk_coord     *Dirty;
+
+	world_stats      Stats;
+} world;
+
+
+// UnloadRadius is raised to LoadRadius when smaller. Returns null when the arena or
+// a job arena cannot be allocated.
+world    * CreateWorld   (world_params Params, memory_arena *Arena);
+
+// Uploads edits and finished chunks, unloads far chunks and queues missing ones.
+// 'Scratch' is released before returning. Without 'EngineMemory' chunks are built
+// on the calling thread.
+void       UpdateWorld   (vec3 Focus, world *World, renderer *Renderer, memory_arena *Scratch, engine_memory *EngineMemory);
+
+// Culls and draws the loaded chunks, see DrawChunks.
+uint32_t   DrawWorld     (camera *Camera, world *World, renderer *Renderer, memory_arena *Arena, engine_memory *EngineMemory);
+
+// X and Y are in tiles. Returns false when the tile's chunk is not loaded. Edits do
+// not survive unloading: chunks are generated again when they come back.
+bool       SetWorldTile  (int32_t X, int32_t Y, uint8_t Data, world *World);
@@ -1,5 +1,6 @@
 #pragma once
 
+#include <stdint.h>
 #include <stdbool.h>
 
 
@@ -8,11 +9,125 @@
 // ==============================================
 
 
-typedef struct platform_work_queue platform_work_queue;
+typedef struct platform_work_queue        platform_work_queue;
+typedef struct platform_work_counter      platform_work_counter;
+typedef struct platform_work_continuation platform_work_continuation;
+
 typedef void platform_work_queue_callback(platform_work_queue *Queue, void *Data);
+
+
+// A counter is incremented for every entry submitted against it and decremented
+// when that entry completes. When it reaches zero, every continuation attached to
+// it is pushed on the queue. Counters are zero-initialized by the caller and must
+// outlive the work they track.
+
+typedef struct platform_work_counter
+{
+	int32_t volatile                     Value;
+	platform_work_continuation *volatile FirstContinuation;
+} platform_work_counter;
+
+
+// Entries go to one of two lanes. Workers always drain the critical lane first and
+// CompleteWork only waits on it, so background work (streaming, decoding) never
+// delays the frame. Every Add* function below submits critical work except
+// AddBackgroundEntry, and continuations go to their own Priority. Long background
+// jobs should poll ShouldYield and split the rest of their work into a new entry
+// when it returns true.
+
+typedef enum PlatformWorkPriority_Type
+{
+	PlatformWorkPriority_Critical   = 0,
+	PlatformWorkPriority_Background = 1,
+	PlatformWorkPriority_Count      = 2,
+} PlatformWorkPriority_Type;
+
+
+// Continuations are owned by the caller (usually frame memory). 'Counter' is
+// the counter the continuation itself signals once it has run, and may be null.
+// 'Priority' is the lane it is pushed to; zero-initialized continuations are
+// critical.
+
+typedef struct platform_work_continuation
+{
+	platform_work_continuation   *Next;
+	platform_work_queue_callback *Callback;
+	void                         *Data;
+	platform_work_counter        *Counter;
+	PlatformWorkPriority_Type     Priority;
+} platform_work_continuation;
+
+
+// AddEntries submits 'Count' entries with Data advancing by DataStride bytes per
+// entry (zero hands the same pointer to all of them) and wakes workers once.
+// Fiber entries run on a pooled fiber: calling WaitForCounter from inside one
+// suspends the job instead of blocking the worker thread running it.
+
 typedef void platform_add_entry(platform_work_queue *Queue, platform_work_queue_callback *Callback, void *Data);
+typedef void platform_add_entries(platform_work_queue *Queue, platform_work_queue_callback *Callback, void *Data, uint64_t DataStride, uint32_t Count, platform_work_counter *Counter);
+typedef void platform_add_counted_entry(platform_work_queue *Queue, platform_work_queue_callback *Callback, void *Data, platform_work_counter *Counter);
+typedef void platform_add_fiber_entry(platform_work_queue *Queue, platform_work_queue_callback *Callback, void *Data, platform_work_counter *Counter);
+typedef void platform_add_background_entry(platform_work_queue *Queue, platform_work_queue_callback *Callback, void *Data, platform_work_counter *Counter);
+typedef bool platform_should_yield(platform_work_queue *Queue);
+typedef void platform_add_continuation(platform_work_queue *Queue, platform_work_counter *DependsOn, platform_work_continuation *Continuation);
+typedef void platform_wait_for_counter(platform_work_queue *Queue, platform_work_counter *Counter);
 typedef void platform_complete_work(platform_work_queue *Queue);
 
+
+// Work queue telemetry is opt-in on the platform side. Values are cumulative since
+// startup, so per-frame numbers come from the difference of two queries. Slot 0 is
+// the main thread, then one slot per worker. Contention counts failed compare-
+// exchanges on the ring cursors, latency is measured from enqueue to start and
+// depth is the number of entries left in the lane a thread just popped from.
+
+#define PLATFORM_MAX_TELEMETRY_THREADS 64
+
+typedef struct platform_worker_telemetry
+{
+	uint64_t EntriesRun;
+	uint64_t BusyNanoseconds;
+	uint64_t SpinNanoseconds;
+	uint64_t ParkedNanoseconds;
+	uint64_t PushContention;
+	uint64_t PopContention;
+	uint64_t LatencyP50Nanoseconds;
+	uint64_t LatencyP99Nanoseconds;
+	uint64_t LatencyMaxNanoseconds;
+	uint64_t DepthP50;
+	uint64_t DepthMax;
+} platform_worker_telemetry;
+
+typedef struct platform_work_telemetry
+{
+	uint32_t                  ThreadCount;
+	uint32_t                  QueueDepth[PlatformWorkPriority_Count];
+	platform_worker_telemetry Threads[PLATFORM_MAX_TELEMETRY_THREADS];
+} platform_work_telemetry;
+
+// Returns false (and leaves Telemetry untouched) when telemetry is compiled out.
+typedef bool platform_query_work_telemetry(platform_work_queue *Queue, platform_work_telemetry *Telemetry);
+
+// ==============================================
+// <Time>
+// ==============================================
+
+// Rolling statistics over the last few hundred frames, refreshed by the platform
+// layer at the end of every frame. TargetNanoseconds may be written by the engine;
+// zero runs the main loop unlocked.
+
+typedef struct platform_frame_timing
+{
+	uint64_t TargetNanoseconds;
+	uint64_t LastNanoseconds;
+	uint64_t P50Nanoseconds;
+	uint64_t P99Nanoseconds;
+	uint64_t MaxNanoseconds;
+	uint64_t FrameCount;
+} platform_frame_timing;
+
+uint64_t OSGetTimeNanoseconds(void);
+uint32_t OSGetThreadID(void);
+
 // ==============================================
 // <Memory>
 // ==============================================
@@ -20,11 +135,21 @@ typedef void platform_complete_work(platform_work_queue *Queue);
 typedef struct memory_arena memory_arena;
 typedef struct engine_memory
 {
-	memory_arena           *StateMemory;
-	memory_arena           *FrameMemory;
-	platform_add_entry     *AddEntry;
-	platform_complete_work *CompleteWork;
-	platform_work_queue    *WorkQueue;
+	memory_arena                  *StateMemory;
+	memory_arena                  *FrameMemory;
+	platform_add_entry            *AddEntry;
+	platform_add_entries          *AddEntries;
+	platform_add_counted_entry    *AddCountedEntry;
+	platform_add_fiber_entry      *AddFiberEntry;
+	platform_add_continuation     *AddContinuation;
+	platform_add_background_entry *AddBackgroundEntry;
+	platform_should_yield         *ShouldYield;
+	platform_wait_for_counter     *WaitForCounter;
+	platform_complete_work        *CompleteWork;
+	platform_query_work_telemetry *QueryWorkTelemetry;
+	platform_work_queue           *WorkQueue;
+	uint32_t                       WorkerCount;
+	platform_frame_timing         *FrameTiming;
 } engine_memory;
 
 void *OSReserve(size_t Size);
@@ -0,0 +1,69 @@
+#ifndef _WIN32
+
+// The OS layer without the rest of a platform: enough for the tests and benchmarks
+// to run on Linux and macOS. The game itself only ships on Win32 (win32_os.c).
+
+#define _GNU_SOURCE
+
+#include <stdint.h>
+#include <stdbool.h>
+#include <time.h>
+#include <pthread.h>
+#include <sys/mman.h>
+
+#if defined(__linux__)
+#include <unistd.h>
+#include <sys/syscall.h>
+#endif
+
+#include "utilities.h"
+#include "platform.h"
+
+// ==============================================
+// <Memory> : PUBLIC
+// ==============================================
+
+void *OSReserve(size_t Size)
+{
+    void *Result = mmap(0, Size, PROT_NONE, MAP_PRIVATE | MAP_ANONYMOUS | MAP_NORESERVE, -1, 0);
+    return Result == MAP_FAILED ? 0 : Result;
+}
+
+bool OSCommit(void *At, size_t Size)
+{
+    bool Result = mprotect(At, Size, PROT_READ | PROT_WRITE) == 0;
+    return Result;
+}
+
+void OSRelease(void *At, size_t Size)
+{
+    munmap(At, Size);
+}
+
+// ==============================================
+// <Time> : PUBLIC
+// ==============================================
+
+uint64_t OSGetTimeNanoseconds(void)
+{
+    struct timespec Time;
+    clock_gettime(CLOCK_MONOTONIC, &Time);
+
+    uint64_t Result = (uint64_t)Time.tv_sec * 1000000000ull + (uint64_t)Time.tv_nsec;
+    return Result;
+}
+
+uint32_t OSGetThreadID(void)
+{
+#if defined(__linux__)
+    uint32_t Result = (uint32_t)syscall(SYS_gettid);
+#else
+    uint64_t ThreadID = 0;
+    pthread_threadid_np(0, &ThreadID);
+    uint32_t Result = (uint32_t)ThreadID;
+#endif
+
+    return Result;
+}
+
+#endif // !_WIN32
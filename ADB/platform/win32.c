@@ -1,6 +1,9 @@
 #ifdef _WIN32
 
 #include <stdbool.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
 #include <assert.h>
 
 
@@ -18,42 +21,15 @@
 #include "engine/rendering/renderer.h"
 #include "engine/rendering/renderer_internal.h"
 #include "engine/rendering/d3d11/d3d11.h"
-
-// ==============================================
-// <Memory> : PUBLIC
-// ==============================================
-
-void *OSReserve(size_t Size)
-{
-	void *Result = VirtualAlloc(0, Size, MEM_RESERVE, PAGE_READWRITE);
-	return Result;
-}
-
-bool OSCommit(void *At, size_t Size)
-{
-	void *Committed = VirtualAlloc(At, Size, MEM_COMMIT, PAGE_READWRITE);
-	bool  Result    = Committed != 0;
-	return Result;
-}
-
-void OSRelease(void *At, size_t Size)
-{
-    Unused(Size);
-	VirtualFree(At, 0, MEM_RELEASE);
-}
+#include "engine/profiler/profiler.h"
+#include "win32_work_queue.h"
+#include "win32_frame_pacer.h"
 
 // ==============================================
 // <Utilities>   : INTERNAL
 // ==============================================
 
 
-static void
-Win32Sleep(DWORD Milliseconds)
-{
-    Sleep(Milliseconds);
-}
-
-
 static void
 Win32GetClientSize(HWND Window, int *OutWidth, int *OutHeight)
 {
@@ -67,113 +43,14 @@ Win32GetClientSize(HWND Window, int *OutWidth, int *OutHeight)
 
 
 // ==============================================
-// <Threading> : INTERNAL
-// =============================================
-
-
-typedef struct
-{
-    platform_work_queue_callback *Callback;
-    void                         *Data;
-} platform_work_queue_entry;
-
-
-typedef struct platform_work_queue
-{
-    uint32_t volatile CompletionGoal;
-    uint32_t volatile CompletionCount;
-
-    uint32_t volatile NextEntryToWrite;
-    uint32_t volatile NextEntryToRead;
-    HANDLE            SemaphoreHandle;
-
-    platform_work_queue_entry Entries[128];
-} platform_work_queue;
-
-
-typedef struct
-{
-    DWORD                ID;
-    platform_work_queue *Queue;
-} win32_thread_info;
-
-
-static void
-Win32AddEntry(platform_work_queue *Queue, platform_work_queue_callback *Callback, void *Data)
-{
-    assert((Queue->NextEntryToWrite + 1) % ArrayCount(Queue->Entries) != Queue->NextEntryToRead);
-
-    platform_work_queue_entry *Entry = Queue->Entries + Queue->NextEntryToWrite;
-    Entry->Callback = Callback;
-    Entry->Data     = Data;
-
-    // Use Array count macro 
-    _WriteBarrier();
-    _mm_sfence();
-    Queue->NextEntryToWrite = (Queue->NextEntryToWrite + 1) % ArrayCount(Queue->Entries);
-    Queue->CompletionGoal  += 1;
-
-    ReleaseSemaphore(Queue->SemaphoreHandle, 1, 0);
-}
-
-
-static bool
-Win32DoNextWorkQueueEntry(platform_work_queue *Queue)
-{
-    bool ShouldSleep = false;
-
-    uint32_t OriginalNextEntryToRead = Queue->NextEntryToRead;
-    uint32_t NewNextEntryToRead      = (OriginalNextEntryToRead + 1) % ArrayCount(Queue->Entries); // Use array count macro
-    if (OriginalNextEntryToRead != Queue->NextEntryToWrite)
-    {
-        uint32_t Index = InterlockedCompareExchange((LONG volatile *)&Queue->NextEntryToRead, NewNextEntryToRead, OriginalNextEntryToRead);
-        if (Index == OriginalNextEntryToRead)
-        {
-            platform_work_queue_entry Entry = Queue->Entries[Index];
-            Entry.Callback(Queue, Entry.Data);
-            InterlockedIncrement((LONG volatile *)&Queue->CompletionCount);
-        }
-    }
-    else
-    {
-        ShouldSleep = true;
-    }
-
-    return ShouldSleep;
-}
-
-
-static void
-Win32CompleteAllWork(platform_work_queue *Queue)
-{
-    while (Queue->CompletionGoal != Queue->CompletionCount)
-    {
-        Win32DoNextWorkQueueEntry(Queue);
-    }
-
-    Queue->CompletionGoal  = 0;
-    Queue->CompletionCount = 0;
-}
+// <Entry Point> : INTERNAL
+// ==============================================
 
 
-static DWORD WINAPI
-ThreadProc(LPVOID lpParameter)
-{
-    win32_thread_info *ThreadInfo = (win32_thread_info *)lpParameter;
+// Target frame time used at startup. Zero runs the loop unlocked; the engine can
+// change it at runtime through engine_memory.FrameTiming.
 
-    for (;;)
-    {
-        if (Win32DoNextWorkQueueEntry(ThreadInfo->Queue))
-        {
-            WaitForSingleObjectEx(ThreadInfo->Queue->SemaphoreHandle, INFINITE, FALSE);
-        }
-    }
-}
-
-
-// ==============================================
-// <Entry Point> : INTERNAL
-// ==============================================
+#define WIN32_TARGET_FRAME_NANOSECONDS 0
 
 
 typedef struct win32_state
@@ -280,34 +157,6 @@ WinMain(HINSTANCE HInstance, HINSTANCE PrevInstance, LPSTR CmdLine, int CmdShow)
     HWND WindowHandle = Win32CreateWindow(1920, 1080, HInstance, CmdShow);
     BOOL Running      = true;
 
-    // Threading Stuff
-    platform_work_queue WorkQueue = {0};
-    {
-        SYSTEM_INFO SystemInfo;
-        GetSystemInfo(&SystemInfo);
-
-        DWORD               ProcessorCount  = SystemInfo.dwNumberOfProcessors;
-        win32_thread_info   ThreadInfos[32] = {0};
-        HANDLE              SemaphoreHandle = CreateSemaphoreEx(0, 0, ProcessorCount, 0, 0, SEMAPHORE_ALL_ACCESS);
-
-        assert(ProcessorCount < 32);
-
-        for (DWORD LogicalIndex = 0; LogicalIndex < ProcessorCount; ++LogicalIndex)
-        {
-            win32_thread_info *ThreadInfo = ThreadInfos + LogicalIndex;
-            ThreadInfo->ID                     = LogicalIndex;
-            ThreadInfo->Queue                  = &WorkQueue;
-            ThreadInfo->Queue->SemaphoreHandle = SemaphoreHandle;
-
-            DWORD ThreadID;
-            HANDLE ThreadHandle = CreateThread(0, 0, ThreadProc, ThreadInfo, 0, &ThreadID);
-            if (ThreadHandle)
-            {
-                CloseHandle(ThreadHandle);
-            }
-        }
-    }
-
     engine_memory EngineMemory = { 0 };
     {
         {
@@ -333,12 +182,13 @@ WinMain(HINSTANCE HInstance, HINSTANCE PrevInstance, LPSTR CmdLine, int CmdShow)
 
             EngineMemory.FrameMemory = AllocateArena(Params);
         }
-
-        EngineMemory.AddEntry     = Win32AddEntry;
-        EngineMemory.CompleteWork = Win32CompleteAllWork;
-        EngineMemory.WorkQueue    = &WorkQueue;
     }
 
+    ProfilerInitialize();
+    ProfilerRegisterThread("Main", 0);
+
+    platform_work_queue *WorkQueue = Win32StartWorkQueue(WIN32_WORKERS_PER_CORE, EngineMemory.StateMemory, &EngineMemory);
+
     gui_input_event InputBuffer[64] = {0};
     gui_input_queue InputQueue      = GuiCreateInputQueue(InputBuffer, 64);
 
@@ -361,6 +211,11 @@ WinMain(HINSTANCE HInstance, HINSTANCE PrevInstance, LPSTR CmdLine, int CmdShow)
     Renderer->Resources      = CreateResourceManager(EngineMemory.StateMemory);
     Renderer->ReferenceTable = CreateResourceReferenceTable(EngineMemory.StateMemory);
 
+    win32_frame_pacer *Pacer = PushStruct(EngineMemory.StateMemory, win32_frame_pacer);
+    Win32InitializeFramePacer(Pacer, WIN32_TARGET_FRAME_NANOSECONDS);
+
+    EngineMemory.FrameTiming = &Pacer->Timing;
+
     while (Running)
     {
         PopArenaTo(EngineMemory.FrameMemory, 0);
@@ -381,9 +236,20 @@ WinMain(HINSTANCE HInstance, HINSTANCE PrevInstance, LPSTR CmdLine, int CmdShow)
 
         UpdateEngine(ClientWidth, ClientHeight, &InputQueue, Renderer, &EngineMemory);
 
-        Win32Sleep(8);
+        ProfileCounter(SleepingWorkers, Win32GetSleepingWorkerCount(WorkQueue));
+
+        ProfileBegin(FramePacing);
+        Win32EndFrame(Pacer);
+        ProfileEnd(FramePacing);
+
+        ProfileFrame();
     }
 
+    Win32ShutdownFramePacer(Pacer);
+    Win32StopWorkers(WorkQueue);
+    Win32WriteWorkTelemetry(WorkQueue, "work_telemetry.txt");
+    ProfilerWriteTrace("engine_trace.json");
+
     return 0;
 }
 
@@ -0,0 +1,145 @@
+#ifdef _WIN32
+
+#include <stdbool.h>
+#include <stdlib.h>
+#include <string.h>
+
+#define WIN32_LEAN_AND_MEAN
+#include <Windows.h>
+#include <timeapi.h>
+
+#pragma comment (lib, "winmm")
+
+#include "utilities.h"
+#include "platform.h"
+#include "win32_frame_pacer.h"
+
+#ifndef CREATE_WAITABLE_TIMER_HIGH_RESOLUTION
+#define CREATE_WAITABLE_TIMER_HIGH_RESOLUTION 0x00000002
+#endif
+
+// ==============================================
+// <Frame Statistics> : INTERNAL
+// ==============================================
+
+
+static int
+Win32CompareFrameTimes(const void *A, const void *B)
+{
+    uint64_t TimeA = *(const uint64_t *)A;
+    uint64_t TimeB = *(const uint64_t *)B;
+
+    int Result = (TimeA > TimeB) - (TimeA < TimeB);
+    return Result;
+}
+
+
+static void
+Win32UpdateFrameTiming(win32_frame_pacer *Pacer, uint64_t FrameNanoseconds)
+{
+    Pacer->History[Pacer->HistoryAt] = FrameNanoseconds;
+    Pacer->HistoryAt                 = (Pacer->HistoryAt + 1) % WIN32_FRAME_HISTORY;
+    Pacer->HistoryCount              = Minimum(Pacer->HistoryCount + 1, WIN32_FRAME_HISTORY);
+
+    uint64_t Sorted[WIN32_FRAME_HISTORY];
+    memcpy(Sorted, Pacer->History, Pacer->HistoryCount * sizeof(uint64_t));
+    qsort(Sorted, Pacer->HistoryCount, sizeof(uint64_t), Win32CompareFrameTimes);
+
+    platform_frame_timing *Timing = &Pacer->Timing;
+    Timing->LastNanoseconds = FrameNanoseconds;
+    Timing->P50Nanoseconds  = Sorted[(Pacer->HistoryCount - 1) / 2];
+    Timing->P99Nanoseconds  = Sorted[((Pacer->HistoryCount - 1) * 99) / 100];
+    Timing->MaxNanoseconds  = Sorted[Pacer->HistoryCount - 1];
+    Timing->FrameCount     += 1;
+}
+
+
+// ==============================================
+// <Frame Pacing> : PUBLIC
+// ==============================================
+
+
+void
+Win32InitializeFramePacer(win32_frame_pacer *Pacer, uint64_t TargetNanoseconds)
+{
+    // High resolution waitable timers wake within a few hundred microseconds. Without
+    // them, fall back to Sleep with a 1ms scheduler period and a larger spin margin.
+    Pacer->Timer = CreateWaitableTimerExW(0, 0, CREATE_WAITABLE_TIMER_HIGH_RESOLUTION, TIMER_ALL_ACCESS);
+    if (Pacer->Timer)
+    {
+        Pacer->TimerSlack = 500000ull;
+    }
+    else
+    {
+        timeBeginPeriod(1);
+        Pacer->TimerSlack = 2000000ull;
+    }
+
+    Pacer->FrameStart               = OSGetTimeNanoseconds();
+    Pacer->HistoryCount             = 0;
+    Pacer->HistoryAt                = 0;
+    Pacer->Timing.TargetNanoseconds = TargetNanoseconds;
+}
+
+
+// Undoes Win32InitializeFramePacer: the 1ms scheduler period is system-wide and
+// must be released before the process exits.
+
+void
+Win32ShutdownFramePacer(win32_frame_pacer *Pacer)
+{
+    if (Pacer->Timer)
+    {
+        CloseHandle(Pacer->Timer);
+        Pacer->Timer = 0;
+    }
+    else
+    {
+        timeEndPeriod(1);
+    }
+}
+
+
+// Sleeps coarsely until the target minus the timer slack, then spins for the
+// remainder, so frames end on time instead of whenever the scheduler wakes us.
+
+void
+Win32EndFrame(win32_frame_pacer *Pacer)
+{
+    uint64_t Target = Pacer->Timing.TargetNanoseconds;
+    uint64_t Now    = OSGetTimeNanoseconds();
+
+    if (Target)
+    {
+        uint64_t Deadline = Pacer->FrameStart + Target;
+
+        if (Now + Pacer->TimerSlack < Deadline)
+        {
+            uint64_t SleepNanoseconds = Deadline - Now - Pacer->TimerSlack;
+
+            if (Pacer->Timer)
+            {
+                LARGE_INTEGER DueTime = { .QuadPart = -(LONGLONG)(SleepNanoseconds / 100) };
+                if (SetWaitableTimerEx(Pacer->Timer, &DueTime, 0, 0, 0, 0, 0))
+                {
+                    WaitForSingleObject(Pacer->Timer, INFINITE);
+                }
+            }
+            else
+            {
+                Sleep((DWORD)(SleepNanoseconds / 1000000ull));
+            }
+        }
+
+        for (Now = OSGetTimeNanoseconds(); Now < Deadline; Now = OSGetTimeNanoseconds())
+        {
+            CPUPause();
+        }
+    }
+
+    Win32UpdateFrameTiming(Pacer, Now - Pacer->FrameStart);
+
+    Pacer->FrameStart = Now;
+}
+
+#endif // _WIN32
@@ -0,0 +1,36 @@
+#pragma once
+
+#include <stdint.h>
+
+#include "platform.h"
+
+// ==============================================
+// <Frame Pacing> : PUBLIC
+// ==============================================
+
+// Ends each frame on a target frame time (or unlocked when the target is zero) and
+// keeps rolling p50/p99/max frame times in 'Timing'. Split from win32.c so the
+// benchmarks can drive the same pacer without a window.
+
+#define WIN32_FRAME_HISTORY 256
+
+typedef struct
+{
+    void                 *Timer;
+    uint64_t              TimerSlack;
+    uint64_t              FrameStart;
+
+    uint32_t              HistoryCount;
+    uint32_t              HistoryAt;
+    uint64_t              History[WIN32_FRAME_HISTORY];
+
+    platform_frame_timing Timing;
+} win32_frame_pacer;
+
+// Opens a high resolution waitable timer, or raises the scheduler period to 1ms when
+// the OS has none. Either way Win32ShutdownFramePacer must undo it.
+void Win32InitializeFramePacer(win32_frame_pacer *Pacer, uint64_t TargetNanoseconds);
+void Win32ShutdownFramePacer  (win32_frame_pacer *Pacer);
+
+// Waits out the rest of the frame, then records its duration and starts the next.
+void Win32EndFrame            (win32_frame_pacer *Pacer);
@@ -0,0 +1,64 @@
+#ifdef _WIN32
+
+#include <stdint.h>
+#include <stdbool.h>
+
+#define WIN32_LEAN_AND_MEAN
+#include <Windows.h>
+
+#include "utilities.h"
+#include "platform.h"
+
+// ==============================================
+// <Memory> : PUBLIC
+// ==============================================
+
+void *OSReserve(size_t Size)
+{
+	void *Result = VirtualAlloc(0, Size, MEM_RESERVE, PAGE_READWRITE);
+	return Result;
+}
+
+bool OSCommit(void *At, size_t Size)
+{
+	void *Committed = VirtualAlloc(At, Size, MEM_COMMIT, PAGE_READWRITE);
+	bool  Result    = Committed != 0;
+	return Result;
+}
+
+void OSRelease(void *At, size_t Size)
+{
+    Unused(Size);
+	VirtualFree(At, 0, MEM_RELEASE);
+}
+
+// ==============================================
+// <Time> : PUBLIC
+// ==============================================
+
+uint64_t OSGetTimeNanoseconds(void)
+{
+    static LARGE_INTEGER Frequency;
+    if (!Frequency.QuadPart)
+    {
+        QueryPerformanceFrequency(&Frequency);
+    }
+
+    LARGE_INTEGER Counter;
+    QueryPerformanceCounter(&Counter);
+
+    // Split to avoid overflowing the multiplication after a few minutes of uptime.
+    uint64_t Ticks   = (uint64_t)Counter.QuadPart;
+    uint64_t PerSec  = (uint64_t)Frequency.QuadPart;
+    uint64_t Result  = (Ticks / PerSec) * 1000000000ull + ((Ticks % PerSec) * 1000000000ull) / PerSec;
+
+    return Result;
+}
+
+uint32_t OSGetThreadID(void)
+{
+    uint32_t Result = (uint32_t)GetCurrentThreadId();
+    return Result;
+}
+
+#endif // _WIN32
@@ -0,0 +1,1324 @@
+#ifdef _WIN32
+
+#include <stdbool.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <assert.h>
+
+#define WIN32_LEAN_AND_MEAN
+#include <Windows.h>
+
+#include "utilities.h"
+#include "platform.h"
+#include "win32_work_queue.h"
+#include "engine/profiler/profiler.h"
+
+// ==============================================
+// <Topology> : INTERNAL
+// ==============================================
+
+
+typedef struct
+{
+    GROUP_AFFINITY Affinity;      // Every logical processor (SMT sibling) of the core.
+    uint32_t       LogicalCount;
+} win32_cpu_core;
+
+
+typedef struct
+{
+    bool            HasAffinity;
+    uint32_t        LogicalCount;
+    uint32_t        CoreCount;
+    win32_cpu_core *Cores;
+} win32_cpu_topology;
+
+
+#define Win32ForEachProcessorInfo(Info, Buffer, Size)                                                     \
+    for (SYSTEM_LOGICAL_PROCESSOR_INFORMATION_EX *Info = (SYSTEM_LOGICAL_PROCESSOR_INFORMATION_EX *)(Buffer); \
+         (uint8_t *)Info < (Buffer) + (Size);                                                              \
+         Info = (SYSTEM_LOGICAL_PROCESSOR_INFORMATION_EX *)((uint8_t *)Info + Info->Size))
+
+
+// Walks every processor group, so machines with more than 64 logical processors
+// are fully described. When the query fails, every logical processor is reported
+// as its own core without affinity information and nothing gets pinned.
+
+static win32_cpu_topology
+Win32QueryCPUTopology(memory_arena *Arena)
+{
+    win32_cpu_topology Result = {0};
+
+    DWORD Size = 0;
+    GetLogicalProcessorInformationEx(RelationProcessorCore, 0, &Size);
+
+    uint8_t *Buffer = Size ? PushArray(Arena, uint8_t, Size) : 0;
+    if (Buffer && GetLogicalProcessorInformationEx(RelationProcessorCore, (SYSTEM_LOGICAL_PROCESSOR_INFORMATION_EX *)Buffer, &Size))
+    {
+        Win32ForEachProcessorInfo(Info, Buffer, Size)
+        {
+            ++Result.CoreCount;
+        }
+
+        Result.Cores = PushArray(Arena, win32_cpu_core, Result.CoreCount);
+
+        if (Result.Cores)
+        {
+            uint32_t CoreIndex = 0;
+
+            Win32ForEachProcessorInfo(Info, Buffer, Size)
+            {
+                win32_cpu_core *Core = Result.Cores + CoreIndex++;
+                Core->Affinity     = Info->Processor.GroupMask[0];
+                Core->LogicalCount = (uint32_t)__popcnt64(Core->Affinity.Mask);
+
+                Result.LogicalCount += Core->LogicalCount;
+            }
+
+            Result.HasAffinity = true;
+        }
+    }
+
+    if (!Result.HasAffinity)
+    {
+        Result.LogicalCount = GetActiveProcessorCount(ALL_PROCESSOR_GROUPS);
+        Result.CoreCount    = Result.LogicalCount;
+        Result.Cores        = 0;
+    }
+
+    return Result;
+}
+
+
+// ==============================================
+// <Threading> : INTERNAL
+// =============================================
+
+
+// The queue is a bounded multi-producer/multi-consumer ring. Every entry carries a
+// sequence number telling whether it is ready to be written (Sequence == Position)
+// or ready to be read (Sequence == Position + 1), so continuations can be pushed
+// from worker threads and not only from the main thread.
+
+typedef struct
+{
+    uint32_t volatile             Sequence;
+    platform_work_queue_callback *Callback;
+    void                         *Data;
+    platform_work_counter        *Counter;
+    PlatformWorkPriority_Type     Priority;
+    bool                          RunInFiber;
+    uint64_t                      EnqueueNanoseconds;
+} platform_work_queue_entry;
+
+
+// Fiber jobs run on pooled fibers whose stacks are allocated once at startup.
+// A fiber job that waits on a non-zero counter parks itself and switches back
+// to the thread it runs on, which keeps executing other entries. Parked fibers
+// are resumed by whichever thread first observes their counter at zero.
+
+#define WIN32_FIBER_COUNT      128
+#define WIN32_FIBER_STACK_SIZE KiB(64)
+
+typedef enum
+{
+    Win32Fiber_Free      = 0,
+    Win32Fiber_Running   = 1,
+    Win32Fiber_Suspended = 2,
+    Win32Fiber_Finished  = 3,
+} Win32Fiber_State;
+
+
+typedef struct win32_fiber win32_fiber;
+struct win32_fiber
+{
+    void                         *Handle;
+    void                         *SchedulerFiber;
+    win32_fiber                  *NextFree;
+    Win32Fiber_State volatile     State;
+
+    platform_work_queue          *Queue;
+    platform_work_queue_callback *Callback;
+    void                         *Data;
+    platform_work_counter        *Counter;
+    platform_work_counter        *WaitingOn;
+    PlatformWorkPriority_Type     Priority;
+};
+
+
+typedef struct
+{
+    SRWLOCK      Lock;
+    win32_fiber *FirstFree;
+
+    uint32_t volatile SuspendedCount;
+    win32_fiber      *Suspended[WIN32_FIBER_COUNT];
+
+    win32_fiber  Fibers[WIN32_FIBER_COUNT];
+} win32_fiber_pool;
+
+
+// Telemetry is allocated and sampled only when this is set. Histograms are
+// log-linear: exact below 16, then 8 sub-buckets per power of two (12.5% relative
+// error), saturating around 9 minutes.
+
+#define WIN32_WORK_QUEUE_TELEMETRY       0
+#define WIN32_HISTOGRAM_LINEAR_BUCKETS   16
+#define WIN32_HISTOGRAM_SUB_BUCKET_BITS  3
+#define WIN32_HISTOGRAM_MAX_EXPONENT     39
+#define WIN32_HISTOGRAM_BUCKET_COUNT     (WIN32_HISTOGRAM_LINEAR_BUCKETS + (WIN32_HISTOGRAM_MAX_EXPONENT - 3) * (1 << WIN32_HISTOGRAM_SUB_BUCKET_BITS))
+
+typedef struct
+{
+    uint64_t Count;
+    uint64_t Max;
+    uint32_t Buckets[WIN32_HISTOGRAM_BUCKET_COUNT];
+} win32_histogram;
+
+
+// Every slot is written by its own thread only, readers take racy snapshots.
+
+typedef struct
+{
+    uint64_t        EntriesRun;
+    uint64_t        BusyNanoseconds;
+    uint64_t        SpinNanoseconds;
+    uint64_t        ParkedNanoseconds;
+    uint64_t        PushContention;
+    uint64_t        PopContention;
+
+    win32_histogram Latency;
+    win32_histogram Depth;
+} win32_thread_telemetry;
+
+
+typedef struct
+{
+    uint32_t               ThreadCount;
+    win32_thread_telemetry Threads[PLATFORM_MAX_TELEMETRY_THREADS];
+} win32_work_telemetry;
+
+
+static __declspec(thread) uint32_t Win32TelemetrySlot;
+
+
+// One ring per priority. Completion is tracked per lane so CompleteWork can wait on
+// frame-critical work while background entries keep running.
+
+typedef struct
+{
+    uint32_t volatile CompletionGoal;
+    uint32_t volatile CompletionCount;
+
+    uint32_t volatile NextEntryToWrite;
+    uint32_t volatile NextEntryToRead;
+
+    platform_work_queue_entry Entries[128];
+} win32_work_lane;
+
+
+typedef struct platform_work_queue
+{
+    win32_work_lane       Lanes[PlatformWorkPriority_Count];
+
+    HANDLE                SemaphoreHandle;
+    LONG volatile         SleepingWorkerCount;
+    uint32_t              SpinCount;
+
+    // Set once at shutdown: workers drain both lanes, then return.
+    bool volatile         Stopping;
+    LONG volatile         RunningWorkerCount;
+
+    win32_fiber_pool      FiberPool;
+    win32_work_telemetry *Telemetry;
+} platform_work_queue;
+
+
+typedef struct
+{
+    DWORD                ID;
+    platform_work_queue *Queue;
+} win32_thread_info;
+
+
+// Number of pause iterations an idle worker polls the queue before parking.
+
+#define WIN32_WORKER_SPIN_COUNT 4096
+
+
+// When set, workers are pinned one per physical core, so SMT siblings don't fight
+// over the same L1 and the main thread's core stays free of workers.
+
+#define WIN32_PIN_WORKERS_TO_PHYSICAL_CORES 1
+
+
+static void WINAPI Win32FiberProc(void *Parameter);
+
+
+static void
+Win32InitializeWorkQueue(platform_work_queue *Queue, HANDLE SemaphoreHandle, uint32_t SpinCount, win32_work_telemetry *Telemetry)
+{
+    static_assert((ArrayCount(Queue->Lanes[0].Entries) & (ArrayCount(Queue->Lanes[0].Entries) - 1)) == 0, "Queue size must be a power of two");
+
+    for (uint32_t LaneIdx = 0; LaneIdx < PlatformWorkPriority_Count; ++LaneIdx)
+    {
+        win32_work_lane *Lane = Queue->Lanes + LaneIdx;
+        Lane->CompletionGoal   = 0;
+        Lane->CompletionCount  = 0;
+        Lane->NextEntryToWrite = 0;
+        Lane->NextEntryToRead  = 0;
+
+        for (uint32_t Idx = 0; Idx < ArrayCount(Lane->Entries); ++Idx)
+        {
+            Lane->Entries[Idx].Sequence = Idx;
+        }
+    }
+
+    Queue->SemaphoreHandle     = SemaphoreHandle;
+    Queue->SpinCount           = SpinCount;
+    Queue->SleepingWorkerCount = 0;
+    Queue->Stopping            = false;
+    Queue->RunningWorkerCount  = 0;
+    Queue->Telemetry           = Telemetry;
+
+    win32_fiber_pool *Pool = &Queue->FiberPool;
+    InitializeSRWLock(&Pool->Lock);
+    Pool->FirstFree      = 0;
+    Pool->SuspendedCount = 0;
+
+    for (uint32_t Idx = 0; Idx < WIN32_FIBER_COUNT; ++Idx)
+    {
+        win32_fiber *Fiber = Pool->Fibers + Idx;
+        Fiber->Handle = CreateFiberEx(0, WIN32_FIBER_STACK_SIZE, FIBER_FLAG_FLOAT_SWITCH, Win32FiberProc, Fiber);
+        Fiber->State  = Win32Fiber_Free;
+
+        if (Fiber->Handle)
+        {
+            Fiber->NextFree = Pool->FirstFree;
+            Pool->FirstFree = Fiber;
+        }
+    }
+}
+
+
+static win32_thread_telemetry *
+Win32GetThreadTelemetry(platform_work_queue *Queue)
+{
+    win32_thread_telemetry *Result = 0;
+
+    // Threads past the last slot (very wide machines) are not tracked.
+    if (Queue->Telemetry && Win32TelemetrySlot < Queue->Telemetry->ThreadCount)
+    {
+        Result = Queue->Telemetry->Threads + Win32TelemetrySlot;
+    }
+
+    return Result;
+}
+
+
+static uint32_t
+Win32GetHistogramBucket(uint64_t Value)
+{
+    if (Value < WIN32_HISTOGRAM_LINEAR_BUCKETS)
+    {
+        return (uint32_t)Value;
+    }
+
+    unsigned long Exponent;
+    _BitScanReverse64(&Exponent, Value);
+
+    if (Exponent > WIN32_HISTOGRAM_MAX_EXPONENT)
+    {
+        return WIN32_HISTOGRAM_BUCKET_COUNT - 1;
+    }
+
+    uint32_t SubBucketCount = 1u << WIN32_HISTOGRAM_SUB_BUCKET_BITS;
+    uint32_t SubBucket      = (uint32_t)(Value >> (Exponent - WIN32_HISTOGRAM_SUB_BUCKET_BITS)) & (SubBucketCount - 1);
+    uint32_t Result         = WIN32_HISTOGRAM_LINEAR_BUCKETS + (Exponent - 4) * SubBucketCount + SubBucket;
+
+    return Result;
+}
+
+
+// Smallest value that lands in the bucket.
+
+static uint64_t
+Win32GetHistogramBucketValue(uint32_t Bucket)
+{
+    if (Bucket < WIN32_HISTOGRAM_LINEAR_BUCKETS)
+    {
+        return Bucket;
+    }
+
+    uint32_t SubBucketCount = 1u << WIN32_HISTOGRAM_SUB_BUCKET_BITS;
+    uint32_t Exponent       = 4 + (Bucket - WIN32_HISTOGRAM_LINEAR_BUCKETS) / SubBucketCount;
+    uint32_t SubBucket      = (Bucket - WIN32_HISTOGRAM_LINEAR_BUCKETS) % SubBucketCount;
+    uint64_t Result         = (uint64_t)(SubBucketCount + SubBucket) << (Exponent - WIN32_HISTOGRAM_SUB_BUCKET_BITS);
+
+    return Result;
+}
+
+
+static void
+Win32RecordHistogram(win32_histogram *Histogram, uint64_t Value)
+{
+    Histogram->Buckets[Win32GetHistogramBucket(Value)] += 1;
+    Histogram->Count                                   += 1;
+    Histogram->Max                                      = Maximum(Histogram->Max, Value);
+}
+
+
+// Reports the highest value of the bucket holding the percentile, capped by the
+// largest recorded value.
+
+static uint64_t
+Win32GetHistogramPercentile(win32_histogram *Histogram, uint32_t Percent)
+{
+    uint64_t Target  = (Histogram->Count * Percent + 99) / 100;
+    uint64_t Running = 0;
+
+    for (uint32_t Bucket = 0; Bucket < WIN32_HISTOGRAM_BUCKET_COUNT && Target; ++Bucket)
+    {
+        Running += Histogram->Buckets[Bucket];
+        if (Running >= Target)
+        {
+            uint64_t Upper  = Bucket + 1 < WIN32_HISTOGRAM_BUCKET_COUNT ? Win32GetHistogramBucketValue(Bucket + 1) - 1 : Histogram->Max;
+            uint64_t Result = Minimum(Upper, Histogram->Max);
+
+            return Result;
+        }
+    }
+
+    return 0;
+}
+
+
+static bool
+Win32QueryWorkTelemetry(platform_work_queue *Queue, platform_work_telemetry *Telemetry)
+{
+    win32_work_telemetry *Source = Queue->Telemetry;
+    if (!Source || !Telemetry)
+    {
+        return false;
+    }
+
+    Telemetry->ThreadCount = Source->ThreadCount;
+
+    for (uint32_t LaneIdx = 0; LaneIdx < PlatformWorkPriority_Count; ++LaneIdx)
+    {
+        win32_work_lane *Lane = Queue->Lanes + LaneIdx;
+        Telemetry->QueueDepth[LaneIdx] = Lane->NextEntryToWrite - Lane->NextEntryToRead;
+    }
+
+    for (uint32_t Idx = 0; Idx < Source->ThreadCount; ++Idx)
+    {
+        win32_thread_telemetry    *From = Source->Threads + Idx;
+        platform_worker_telemetry *Into = Telemetry->Threads + Idx;
+
+        Into->EntriesRun            = From->EntriesRun;
+        Into->BusyNanoseconds       = From->BusyNanoseconds;
+        Into->SpinNanoseconds       = From->SpinNanoseconds;
+        Into->ParkedNanoseconds     = From->ParkedNanoseconds;
+        Into->PushContention        = From->PushContention;
+        Into->PopContention         = From->PopContention;
+        Into->LatencyP50Nanoseconds = Win32GetHistogramPercentile(&From->Latency, 50);
+        Into->LatencyP99Nanoseconds = Win32GetHistogramPercentile(&From->Latency, 99);
+        Into->LatencyMaxNanoseconds = From->Latency.Max;
+        Into->DepthP50              = Win32GetHistogramPercentile(&From->Depth, 50);
+        Into->DepthMax              = From->Depth.Max;
+    }
+
+    return true;
+}
+
+
+static void
+Win32WriteHistogram(FILE *File, const char *Name, win32_histogram *Histogram)
+{
+    fprintf(File, "  %s: count %llu, p50 %llu, p99 %llu, max %llu\n", Name,
+            (unsigned long long)Histogram->Count,
+            (unsigned long long)Win32GetHistogramPercentile(Histogram, 50),
+            (unsigned long long)Win32GetHistogramPercentile(Histogram, 99),
+            (unsigned long long)Histogram->Max);
+
+    for (uint32_t Bucket = 0; Bucket < WIN32_HISTOGRAM_BUCKET_COUNT; ++Bucket)
+    {
+        if (Histogram->Buckets[Bucket])
+        {
+            fprintf(File, "    >= %llu: %u\n", (unsigned long long)Win32GetHistogramBucketValue(Bucket), Histogram->Buckets[Bucket]);
+        }
+    }
+}
+
+
+void
+Win32WriteWorkTelemetry(platform_work_queue *Queue, const char *Path)
+{
+    win32_work_telemetry *Telemetry = Queue->Telemetry;
+    if (!Telemetry)
+    {
+        return;
+    }
+
+    FILE *File = fopen(Path, "wb");
+    if (!File)
+    {
+        return;
+    }
+
+    for (uint32_t Idx = 0; Idx < Telemetry->ThreadCount; ++Idx)
+    {
+        win32_thread_telemetry *Thread = Telemetry->Threads + Idx;
+
+        fprintf(File, "%s %u: entries %llu, busy %llu ns, spin %llu ns, parked %llu ns, push contention %llu, pop contention %llu\n",
+                Idx == 0 ? "Main" : "Worker", Idx == 0 ? 0 : Idx - 1,
+                (unsigned long long)Thread->EntriesRun,
+                (unsigned long long)Thread->BusyNanoseconds,
+                (unsigned long long)Thread->SpinNanoseconds,
+                (unsigned long long)Thread->ParkedNanoseconds,
+                (unsigned long long)Thread->PushContention,
+                (unsigned long long)Thread->PopContention);
+
+        Win32WriteHistogram(File, "latency (ns)", &Thread->Latency);
+        Win32WriteHistogram(File, "depth", &Thread->Depth);
+    }
+
+    fclose(File);
+}
+
+
+static bool
+Win32TryPushWorkQueueEntry(win32_work_lane *Lane, platform_work_queue_callback *Callback, void *Data, platform_work_counter *Counter,
+                           PlatformWorkPriority_Type Priority, bool RunInFiber, win32_thread_telemetry *Telemetry)
+{
+    uint32_t Mask     = ArrayCount(Lane->Entries) - 1;
+    uint32_t Position = Lane->NextEntryToWrite;
+
+    for (;;)
+    {
+        platform_work_queue_entry *Entry      = Lane->Entries + (Position & Mask);
+        int32_t                    Difference = (int32_t)(Entry->Sequence - Position);
+
+        if (Difference == 0)
+        {
+            uint32_t Observed = InterlockedCompareExchange((LONG volatile *)&Lane->NextEntryToWrite, Position + 1, Position);
+            if (Observed == Position)
+            {
+                Entry->Callback   = Callback;
+                Entry->Data       = Data;
+                Entry->Counter    = Counter;
+                Entry->Priority   = Priority;
+                Entry->RunInFiber = RunInFiber;
+
+                Entry->EnqueueNanoseconds = Telemetry ? OSGetTimeNanoseconds() : 0;
+
+                _WriteBarrier();
+                Entry->Sequence = Position + 1;
+
+                return true;
+            }
+
+            if (Telemetry)
+            {
+                Telemetry->PushContention += 1;
+            }
+
+            Position = Observed;
+        }
+        else if (Difference < 0)
+        {
+            return false;
+        }
+        else
+        {
+            Position = Lane->NextEntryToWrite;
+        }
+    }
+}
+
+
+static bool
+Win32TryPopWorkQueueEntry(win32_work_lane *Lane, platform_work_queue_entry *OutEntry, win32_thread_telemetry *Telemetry)
+{
+    uint32_t Mask     = ArrayCount(Lane->Entries) - 1;
+    uint32_t Position = Lane->NextEntryToRead;
+
+    for (;;)
+    {
+        platform_work_queue_entry *Entry      = Lane->Entries + (Position & Mask);
+        int32_t                    Difference = (int32_t)(Entry->Sequence - (Position + 1));
+
+        if (Difference == 0)
+        {
+            uint32_t Observed = InterlockedCompareExchange((LONG volatile *)&Lane->NextEntryToRead, Position + 1, Position);
+            if (Observed == Position)
+            {
+                OutEntry->Callback   = Entry->Callback;
+                OutEntry->Data       = Entry->Data;
+                OutEntry->Counter    = Entry->Counter;
+                OutEntry->Priority   = Entry->Priority;
+                OutEntry->RunInFiber = Entry->RunInFiber;
+
+                OutEntry->EnqueueNanoseconds = Entry->EnqueueNanoseconds;
+
+                _ReadWriteBarrier();
+                Entry->Sequence = Position + Mask + 1;
+
+                return true;
+            }
+
+            if (Telemetry)
+            {
+                Telemetry->PopContention += 1;
+            }
+
+            Position = Observed;
+        }
+        else if (Difference < 0)
+        {
+            return false;
+        }
+        else
+        {
+            Position = Lane->NextEntryToRead;
+        }
+    }
+}
+
+
+static bool Win32DoNextWorkQueueEntry(platform_work_queue *Queue, PlatformWorkPriority_Type LowestPriority);
+
+
+static bool
+Win32WorkLaneHasEntries(win32_work_lane *Lane)
+{
+    uint32_t                   Position = Lane->NextEntryToRead;
+    platform_work_queue_entry *Entry    = Lane->Entries + (Position & (ArrayCount(Lane->Entries) - 1));
+    bool                       Result   = Entry->Sequence == Position + 1;
+
+    return Result;
+}
+
+
+static bool
+Win32WorkQueueHasEntries(platform_work_queue *Queue)
+{
+    bool Result = false;
+
+    for (uint32_t LaneIdx = 0; LaneIdx < PlatformWorkPriority_Count && !Result; ++LaneIdx)
+    {
+        Result = Win32WorkLaneHasEntries(Queue->Lanes + LaneIdx);
+    }
+
+    return Result;
+}
+
+
+static bool
+Win32ShouldYield(platform_work_queue *Queue)
+{
+    bool Result = Win32WorkLaneHasEntries(Queue->Lanes + PlatformWorkPriority_Critical);
+    return Result;
+}
+
+
+// Workers announce themselves in SleepingWorkerCount before re-checking the queue
+// and parking, and producers read it after publishing. One ReleaseSemaphore call
+// then wakes as many sleepers as there are new entries, instead of one kernel
+// transition per entry.
+
+static void
+Win32WakeWorkers(platform_work_queue *Queue, uint32_t EntryCount)
+{
+    MemoryBarrier();
+
+    LONG Sleeping = Queue->SleepingWorkerCount;
+    LONG Release  = Minimum((LONG)EntryCount, Sleeping);
+
+    if (Release > 0)
+    {
+        ReleaseSemaphore(Queue->SemaphoreHandle, Release, 0);
+    }
+}
+
+
+// 'Count' entries are pushed with Data advancing by DataStride bytes each time
+// (a stride of zero hands the same pointer to every entry). The counter (if any)
+// must already account for these entries.
+
+static void
+Win32PushWorkQueueEntries(platform_work_queue *Queue, platform_work_queue_callback *Callback, void *Data, uint64_t DataStride, uint32_t Count,
+                          platform_work_counter *Counter, PlatformWorkPriority_Type Priority, bool RunInFiber)
+{
+    win32_work_lane        *Lane      = Queue->Lanes + Priority;
+    win32_thread_telemetry *Telemetry = Win32GetThreadTelemetry(Queue);
+
+    InterlockedExchangeAdd((LONG volatile *)&Lane->CompletionGoal, (LONG)Count);
+
+    uint8_t *At = (uint8_t *)Data;
+    for (uint32_t Idx = 0; Idx < Count; ++Idx, At += DataStride)
+    {
+        // When the ring is full, wake the workers to drain it and help instead of failing.
+        // Helping stays within this lane's priority, so a full critical lane never
+        // makes the producer pick up a long background job.
+        while (!Win32TryPushWorkQueueEntry(Lane, Callback, At, Counter, Priority, RunInFiber, Telemetry))
+        {
+            Win32WakeWorkers(Queue, Idx + 1);
+
+            if (Win32DoNextWorkQueueEntry(Queue, Priority))
+            {
+                CPUPause();
+            }
+        }
+    }
+
+    Win32WakeWorkers(Queue, Count);
+}
+
+
+static void
+Win32ReleaseWorkCounter(platform_work_queue *Queue, platform_work_counter *Counter)
+{
+    if (InterlockedDecrement((LONG volatile *)&Counter->Value) == 0)
+    {
+        platform_work_continuation *Continuation = InterlockedExchangePointer((PVOID volatile *)&Counter->FirstContinuation, 0);
+        while (Continuation)
+        {
+            // Read the link first, the continuation may run (and be reused) as soon as it is pushed.
+            platform_work_continuation *Next = Continuation->Next;
+            Win32PushWorkQueueEntries(Queue, Continuation->Callback, Continuation->Data, 0, 1, Continuation->Counter, Continuation->Priority, false);
+            Continuation = Next;
+        }
+
+        // A fiber parked on this counter is only resumed by a thread that looks for
+        // work. This thread may be about to leave the queue (a non-fiber wait
+        // returning), so make sure a worker comes by if they are all parked.
+        if (Queue->FiberPool.SuspendedCount > 0)
+        {
+            Win32WakeWorkers(Queue, 1);
+        }
+    }
+}
+
+
+static void
+Win32AddCountedEntry(platform_work_queue *Queue, platform_work_queue_callback *Callback, void *Data, platform_work_counter *Counter)
+{
+    if (Counter)
+    {
+        InterlockedIncrement((LONG volatile *)&Counter->Value);
+    }
+
+    Win32PushWorkQueueEntries(Queue, Callback, Data, 0, 1, Counter, PlatformWorkPriority_Critical, false);
+}
+
+
+static void
+Win32AddBackgroundEntry(platform_work_queue *Queue, platform_work_queue_callback *Callback, void *Data, platform_work_counter *Counter)
+{
+    if (Counter)
+    {
+        InterlockedIncrement((LONG volatile *)&Counter->Value);
+    }
+
+    Win32PushWorkQueueEntries(Queue, Callback, Data, 0, 1, Counter, PlatformWorkPriority_Background, false);
+}
+
+
+static void
+Win32AddEntries(platform_work_queue *Queue, platform_work_queue_callback *Callback, void *Data, uint64_t DataStride, uint32_t Count, platform_work_counter *Counter)
+{
+    if (Count == 0)
+    {
+        return;
+    }
+
+    if (Counter)
+    {
+        InterlockedExchangeAdd((LONG volatile *)&Counter->Value, (LONG)Count);
+    }
+
+    Win32PushWorkQueueEntries(Queue, Callback, Data, DataStride, Count, Counter, PlatformWorkPriority_Critical, false);
+}
+
+
+static void
+Win32AddFiberEntry(platform_work_queue *Queue, platform_work_queue_callback *Callback, void *Data, platform_work_counter *Counter)
+{
+    if (Counter)
+    {
+        InterlockedIncrement((LONG volatile *)&Counter->Value);
+    }
+
+    Win32PushWorkQueueEntries(Queue, Callback, Data, 0, 1, Counter, PlatformWorkPriority_Critical, true);
+}
+
+
+static void
+Win32AddEntry(platform_work_queue *Queue, platform_work_queue_callback *Callback, void *Data)
+{
+    Win32AddCountedEntry(Queue, Callback, Data, 0);
+}
+
+
+// The dependency counter is held for the duration of the insertion, so a counter
+// reaching zero concurrently cannot miss the continuation: whoever drops the last
+// reference fires the list.
+
+static void
+Win32AddContinuation(platform_work_queue *Queue, platform_work_counter *DependsOn, platform_work_continuation *Continuation)
+{
+    assert(DependsOn && Continuation && Continuation->Callback);
+
+    if (Continuation->Counter)
+    {
+        InterlockedIncrement((LONG volatile *)&Continuation->Counter->Value);
+    }
+
+    InterlockedIncrement((LONG volatile *)&DependsOn->Value);
+
+    platform_work_continuation *Head = 0;
+    do
+    {
+        Head               = DependsOn->FirstContinuation;
+        Continuation->Next = Head;
+    } while (InterlockedCompareExchangePointer((PVOID volatile *)&DependsOn->FirstContinuation, Continuation, Head) != Head);
+
+    Win32ReleaseWorkCounter(Queue, DependsOn);
+}
+
+
+static void
+Win32FinishWorkQueueEntry(platform_work_queue *Queue, platform_work_counter *Counter, PlatformWorkPriority_Type Priority)
+{
+    if (Counter)
+    {
+        Win32ReleaseWorkCounter(Queue, Counter);
+    }
+
+    InterlockedIncrement((LONG volatile *)&Queue->Lanes[Priority].CompletionCount);
+}
+
+
+static win32_fiber *
+Win32AcquireFiber(win32_fiber_pool *Pool)
+{
+    AcquireSRWLockExclusive(&Pool->Lock);
+
+    win32_fiber *Result = Pool->FirstFree;
+    if (Result)
+    {
+        Pool->FirstFree  = Result->NextFree;
+        Result->NextFree = 0;
+    }
+
+    ReleaseSRWLockExclusive(&Pool->Lock);
+
+    return Result;
+}
+
+
+static void
+Win32ReleaseFiber(win32_fiber_pool *Pool, win32_fiber *Fiber)
+{
+    AcquireSRWLockExclusive(&Pool->Lock);
+
+    Fiber->State    = Win32Fiber_Free;
+    Fiber->NextFree = Pool->FirstFree;
+    Pool->FirstFree = Fiber;
+
+    ReleaseSRWLockExclusive(&Pool->Lock);
+}
+
+
+static void
+Win32ParkFiber(win32_fiber_pool *Pool, win32_fiber *Fiber)
+{
+    AcquireSRWLockExclusive(&Pool->Lock);
+
+    assert(Pool->SuspendedCount < WIN32_FIBER_COUNT);
+    Pool->Suspended[Pool->SuspendedCount++] = Fiber;
+
+    ReleaseSRWLockExclusive(&Pool->Lock);
+}
+
+
+static win32_fiber *
+Win32PopResumableFiber(win32_fiber_pool *Pool, PlatformWorkPriority_Type LowestPriority)
+{
+    win32_fiber *Result = 0;
+
+    if (Pool->SuspendedCount > 0)
+    {
+        AcquireSRWLockExclusive(&Pool->Lock);
+
+        for (uint32_t Idx = 0; Idx < Pool->SuspendedCount; ++Idx)
+        {
+            win32_fiber *Fiber = Pool->Suspended[Idx];
+            if (Fiber->Priority <= LowestPriority && Fiber->WaitingOn->Value == 0)
+            {
+                Pool->Suspended[Idx] = Pool->Suspended[--Pool->SuspendedCount];
+                Result = Fiber;
+                break;
+            }
+        }
+
+        ReleaseSRWLockExclusive(&Pool->Lock);
+    }
+
+    return Result;
+}
+
+
+static bool
+Win32HasResumableFiber(win32_fiber_pool *Pool)
+{
+    bool Result = false;
+
+    if (Pool->SuspendedCount > 0)
+    {
+        AcquireSRWLockExclusive(&Pool->Lock);
+
+        for (uint32_t Idx = 0; Idx < Pool->SuspendedCount && !Result; ++Idx)
+        {
+            Result = Pool->Suspended[Idx]->WaitingOn->Value == 0;
+        }
+
+        ReleaseSRWLockExclusive(&Pool->Lock);
+    }
+
+    return Result;
+}
+
+
+// Switches to the fiber and handles its state once it switches back. A suspended
+// fiber is only made visible to other threads here, after its stack is no longer
+// in use.
+
+static void
+Win32RunFiber(platform_work_queue *Queue, win32_fiber *Fiber)
+{
+    Fiber->SchedulerFiber = GetCurrentFiber();
+    Fiber->WaitingOn      = 0;
+    Fiber->State          = Win32Fiber_Running;
+
+    SwitchToFiber(Fiber->Handle);
+
+    if (Fiber->State == Win32Fiber_Finished)
+    {
+        platform_work_counter    *Counter  = Fiber->Counter;
+        PlatformWorkPriority_Type Priority = Fiber->Priority;
+
+        Win32ReleaseFiber(&Queue->FiberPool, Fiber);
+        Win32FinishWorkQueueEntry(Queue, Counter, Priority);
+    }
+    else if (Fiber->State == Win32Fiber_Suspended)
+    {
+        Win32ParkFiber(&Queue->FiberPool, Fiber);
+    }
+    else
+    {
+        assert(!"INVALID ENGINE STATE");
+    }
+}
+
+
+static void WINAPI
+Win32FiberProc(void *Parameter)
+{
+    win32_fiber *Fiber = (win32_fiber *)Parameter;
+
+    for (;;)
+    {
+        Fiber->Callback(Fiber->Queue, Fiber->Data);
+        Fiber->State = Win32Fiber_Finished;
+
+        SwitchToFiber(Fiber->SchedulerFiber);
+    }
+}
+
+
+// Threads that execute entries are converted to fibers with no fiber data, so a
+// non-null fiber data means the caller is running inside a pooled job fiber.
+
+static win32_fiber *
+Win32GetCurrentJobFiber(void)
+{
+    win32_fiber *Result = 0;
+
+    if (IsThreadAFiber())
+    {
+        Result = (win32_fiber *)GetFiberData();
+    }
+
+    return Result;
+}
+
+
+// Lanes are tried in priority order, down to LowestPriority. Resumable fibers of an
+// allowed priority go first: they already hold a stack and are usually what some
+// wait is blocked on.
+
+static bool
+Win32DoNextWorkQueueEntry(platform_work_queue *Queue, PlatformWorkPriority_Type LowestPriority)
+{
+    bool ShouldSleep = false;
+
+    win32_fiber *Resumable = Win32PopResumableFiber(&Queue->FiberPool, LowestPriority);
+    if (Resumable)
+    {
+        Win32RunFiber(Queue, Resumable);
+        return ShouldSleep;
+    }
+
+    win32_thread_telemetry   *Telemetry = Win32GetThreadTelemetry(Queue);
+    platform_work_queue_entry Entry;
+    bool                      Popped    = false;
+
+    for (uint32_t LaneIdx = 0; LaneIdx <= (uint32_t)LowestPriority && !Popped; ++LaneIdx)
+    {
+        win32_work_lane *Lane = Queue->Lanes + LaneIdx;
+
+        Popped = Win32TryPopWorkQueueEntry(Lane, &Entry, Telemetry);
+
+        if (Popped && Telemetry)
+        {
+            uint64_t Now = OSGetTimeNanoseconds();
+
+            Win32RecordHistogram(&Telemetry->Latency, Now > Entry.EnqueueNanoseconds ? Now - Entry.EnqueueNanoseconds : 0);
+            Win32RecordHistogram(&Telemetry->Depth, (uint32_t)(Lane->NextEntryToWrite - Lane->NextEntryToRead));
+            Telemetry->EntriesRun += 1;
+        }
+    }
+
+    if (Popped)
+    {
+        win32_fiber *Fiber = Entry.RunInFiber ? Win32AcquireFiber(&Queue->FiberPool) : 0;
+        if (Fiber)
+        {
+            Fiber->Queue    = Queue;
+            Fiber->Callback = Entry.Callback;
+            Fiber->Data     = Entry.Data;
+            Fiber->Counter  = Entry.Counter;
+            Fiber->Priority = Entry.Priority;
+
+            Win32RunFiber(Queue, Fiber);
+        }
+        else
+        {
+            // Plain entries, and fiber entries when the pool is exhausted, run on the current stack.
+            Entry.Callback(Queue, Entry.Data);
+            Win32FinishWorkQueueEntry(Queue, Entry.Counter, Entry.Priority);
+        }
+    }
+    else
+    {
+        ShouldSleep = true;
+    }
+
+    return ShouldSleep;
+}
+
+
+// Inside a fiber job the wait parks the fiber so its thread can pick up other
+// work. Anywhere else the waiting thread executes critical entries instead of
+// blocking, so nested waits make progress as long as the queue holds work. It
+// never picks up background entries: a frame waiting on a ParallelFor must not
+// end up running a streaming job.
+
+static void
+Win32WaitForCounter(platform_work_queue *Queue, platform_work_counter *Counter)
+{
+    win32_fiber *Fiber = Win32GetCurrentJobFiber();
+    if (Fiber)
+    {
+        while (Counter->Value != 0)
+        {
+            Fiber->WaitingOn = Counter;
+            Fiber->State     = Win32Fiber_Suspended;
+
+            SwitchToFiber(Fiber->SchedulerFiber);
+        }
+
+        return;
+    }
+
+    while (Counter->Value != 0)
+    {
+        if (Win32DoNextWorkQueueEntry(Queue, PlatformWorkPriority_Critical))
+        {
+            CPUPause();
+        }
+    }
+}
+
+
+// Only frame-critical work is waited on (and helped with). Background entries
+// are tracked through their own counters.
+//
+// Goal and count only ever grow (and wrap together), since workers may push
+// critical entries while this waits. The goal is raised before an entry is pushed
+// and the count after it finished (and pushed its continuations), so reading the
+// count first and seeing the goal equal to it means nothing was outstanding.
+
+static bool
+Win32IsLaneComplete(win32_work_lane *Lane)
+{
+    uint32_t Count = Lane->CompletionCount;
+    MemoryBarrier();
+    uint32_t Goal  = Lane->CompletionGoal;
+
+    bool Result = Count == Goal;
+    return Result;
+}
+
+
+static void
+Win32CompleteAllWork(platform_work_queue *Queue)
+{
+    win32_work_lane *Lane = Queue->Lanes + PlatformWorkPriority_Critical;
+
+    win32_thread_telemetry *Telemetry = Win32GetThreadTelemetry(Queue);
+
+    while (!Win32IsLaneComplete(Lane))
+    {
+        uint64_t Start = Telemetry ? OSGetTimeNanoseconds() : 0;
+
+        if (Win32DoNextWorkQueueEntry(Queue, PlatformWorkPriority_Critical))
+        {
+            CPUPause();
+        }
+        else if (Telemetry)
+        {
+            Telemetry->BusyNanoseconds += OSGetTimeNanoseconds() - Start;
+        }
+    }
+}
+
+
+// Runs at shutdown, before the telemetry and the profiler trace are read. Both
+// lanes are drained (the calling thread helps) and every worker has returned, so
+// no job is still writing to its ring buffer or counters. The release covers
+// every worker, parked or not: the ones that are not parked leave a stale count
+// behind, which no longer matters. The fibers and the semaphore are released last,
+// so a benchmark can start another queue afterwards.
+
+void
+Win32StopWorkers(platform_work_queue *Queue)
+{
+    Queue->Stopping = true;
+    MemoryBarrier();
+
+    LONG Running = Queue->RunningWorkerCount;
+    if (Running > 0)
+    {
+        ReleaseSemaphore(Queue->SemaphoreHandle, Running, 0);
+    }
+
+    while (Queue->RunningWorkerCount > 0 || Win32WorkQueueHasEntries(Queue) || Queue->FiberPool.SuspendedCount > 0)
+    {
+        if (Win32DoNextWorkQueueEntry(Queue, PlatformWorkPriority_Background))
+        {
+            CPUPause();
+        }
+    }
+
+    for (uint32_t Idx = 0; Idx < WIN32_FIBER_COUNT; ++Idx)
+    {
+        win32_fiber *Fiber = Queue->FiberPool.Fibers + Idx;
+        if (Fiber->Handle)
+        {
+            DeleteFiber(Fiber->Handle);
+            Fiber->Handle = 0;
+        }
+    }
+
+    CloseHandle(Queue->SemaphoreHandle);
+    Queue->SemaphoreHandle = 0;
+}
+
+
+static DWORD WINAPI
+ThreadProc(LPVOID lpParameter)
+{
+    win32_thread_info   *ThreadInfo = (win32_thread_info *)lpParameter;
+    platform_work_queue *Queue      = ThreadInfo->Queue;
+
+    ConvertThreadToFiber(0);
+    ProfilerRegisterThread("Worker", ThreadInfo->ID);
+
+    // Slot 0 belongs to the main thread.
+    Win32TelemetrySlot = ThreadInfo->ID + 1;
+
+    win32_thread_telemetry *Telemetry = Win32GetThreadTelemetry(Queue);
+
+    for (;;)
+    {
+        uint64_t Start = Telemetry ? OSGetTimeNanoseconds() : 0;
+
+        ProfileBegin(WorkerEntry);
+        bool ShouldSleep = Win32DoNextWorkQueueEntry(Queue, PlatformWorkPriority_Background);
+        ProfileEnd(WorkerEntry);
+
+        if (!ShouldSleep)
+        {
+            if (Telemetry)
+            {
+                Telemetry->BusyNanoseconds += OSGetTimeNanoseconds() - Start;
+            }
+
+            continue;
+        }
+
+        if (Queue->Stopping)
+        {
+            break;
+        }
+
+        // Spin for a while before parking: a burst submitted right after the queue
+        // drained is picked up without a kernel round trip.
+        bool FoundWork = false;
+        for (uint32_t Spin = 0; Spin < Queue->SpinCount && !FoundWork; ++Spin)
+        {
+            CPUPause();
+            FoundWork = Win32WorkQueueHasEntries(Queue) || Win32HasResumableFiber(&Queue->FiberPool);
+        }
+
+        uint64_t SpinEnd = Telemetry ? OSGetTimeNanoseconds() : 0;
+
+        if (!FoundWork)
+        {
+            InterlockedIncrement(&Queue->SleepingWorkerCount);
+
+            if (!Win32WorkQueueHasEntries(Queue) && !Win32HasResumableFiber(&Queue->FiberPool) && !Queue->Stopping)
+            {
+                ProfileBegin(WorkerPark);
+                WaitForSingleObjectEx(Queue->SemaphoreHandle, INFINITE, FALSE);
+                ProfileEnd(WorkerPark);
+            }
+
+            InterlockedDecrement(&Queue->SleepingWorkerCount);
+
+            if (Telemetry)
+            {
+                Telemetry->ParkedNanoseconds += OSGetTimeNanoseconds() - SpinEnd;
+            }
+        }
+
+        if (Telemetry)
+        {
+            Telemetry->SpinNanoseconds += SpinEnd - Start;
+        }
+    }
+
+    InterlockedDecrement(&Queue->RunningWorkerCount);
+
+    return 0;
+}
+
+
+// Hands out the queue in engine_memory: the calling thread becomes a fiber (fiber
+// jobs can only be switched to from one) and the workers start parked.
+
+platform_work_queue *
+Win32StartWorkQueue(uint32_t WorkerCount, memory_arena *Arena, engine_memory *EngineMemory)
+{
+    platform_work_queue *Queue = PushStruct(Arena, platform_work_queue);
+    if (!Queue)
+    {
+        return 0;
+    }
+
+    if (!IsThreadAFiber())
+    {
+        ConvertThreadToFiber(0);
+    }
+
+    win32_cpu_topology Topology        = Win32QueryCPUTopology(Arena);
+    HANDLE             SemaphoreHandle = CreateSemaphoreEx(0, 0, MAXLONG, 0, 0, SEMAPHORE_ALL_ACCESS);
+
+    // The main thread keeps the first core to itself. Pinned workers get one
+    // physical core each (all of its SMT siblings in the mask), unpinned workers
+    // get one thread per remaining logical processor. An explicit WorkerCount only
+    // pins when there are enough cores for it.
+    uint32_t MainCoreLogical = Topology.HasAffinity ? Topology.Cores[0].LogicalCount : 1;
+    uint32_t ThreadCount     = WorkerCount;
+    bool     PinWorkers      = WIN32_PIN_WORKERS_TO_PHYSICAL_CORES && Topology.HasAffinity && Topology.CoreCount > 1;
+
+    if (WorkerCount == WIN32_WORKERS_PER_CORE)
+    {
+        ThreadCount = PinWorkers ? Topology.CoreCount - 1 : Topology.LogicalCount - Minimum(MainCoreLogical, Topology.LogicalCount);
+    }
+    else
+    {
+        PinWorkers = PinWorkers && WorkerCount < Topology.CoreCount;
+    }
+
+    if (PinWorkers)
+    {
+        SetThreadGroupAffinity(GetCurrentThread(), &Topology.Cores[0].Affinity, 0);
+    }
+
+    win32_work_telemetry *Telemetry = 0;
+    if (WIN32_WORK_QUEUE_TELEMETRY)
+    {
+        Telemetry = PushStruct(Arena, win32_work_telemetry);
+        if (Telemetry)
+        {
+            Telemetry->ThreadCount = Minimum(ThreadCount + 1, PLATFORM_MAX_TELEMETRY_THREADS);
+        }
+    }
+
+    Win32InitializeWorkQueue(Queue, SemaphoreHandle, WIN32_WORKER_SPIN_COUNT, Telemetry);
+
+    win32_thread_info *ThreadInfos = PushArray(Arena, win32_thread_info, Maximum(ThreadCount, 1));
+    uint32_t           Started     = 0;
+
+    for (uint32_t WorkerIndex = 0; WorkerIndex < ThreadCount && ThreadInfos; ++WorkerIndex)
+    {
+        win32_thread_info *ThreadInfo = ThreadInfos + WorkerIndex;
+        ThreadInfo->ID    = WorkerIndex;
+        ThreadInfo->Queue = Queue;
+
+        DWORD  ThreadID;
+        HANDLE ThreadHandle = CreateThread(0, 0, ThreadProc, ThreadInfo, CREATE_SUSPENDED, &ThreadID);
+        if (ThreadHandle)
+        {
+            if (PinWorkers)
+            {
+                SetThreadGroupAffinity(ThreadHandle, &Topology.Cores[WorkerIndex + 1].Affinity, 0);
+            }
+
+            InterlockedIncrement(&Queue->RunningWorkerCount);
+            ResumeThread(ThreadHandle);
+            CloseHandle(ThreadHandle);
+            ++Started;
+        }
+    }
+
+    EngineMemory->AddEntry           = Win32AddEntry;
+    EngineMemory->AddEntries         = Win32AddEntries;
+    EngineMemory->AddCountedEntry    = Win32AddCountedEntry;
+    EngineMemory->AddFiberEntry      = Win32AddFiberEntry;
+    EngineMemory->AddContinuation    = Win32AddContinuation;
+    EngineMemory->AddBackgroundEntry = Win32AddBackgroundEntry;
+    EngineMemory->ShouldYield        = Win32ShouldYield;
+    EngineMemory->WaitForCounter     = Win32WaitForCounter;
+    EngineMemory->CompleteWork       = Win32CompleteAllWork;
+    EngineMemory->QueryWorkTelemetry = Win32QueryWorkTelemetry;
+    EngineMemory->WorkQueue          = Queue;
+    EngineMemory->WorkerCount        = Started;
+
+    return Queue;
+}
+
+
+uint32_t
+Win32GetSleepingWorkerCount(platform_work_queue *Queue)
+{
+    uint32_t Result = (uint32_t)Queue->SleepingWorkerCount;
+    return Result;
+}
+
+#endif // _WIN32
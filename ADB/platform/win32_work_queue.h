@@ -0,0 +1,30 @@
+#pragma once
+
+#include <stdint.h>
+
+#include "platform.h"
+
+// ==============================================
+// <Work Queue> : PUBLIC
+// ==============================================
+
+// The Win32 side of the engine_memory job API: a two-lane ring buffer served by a
+// pool of worker threads and fibers. Split from win32.c so the benchmarks can drive
+// the same queue without a window.
+
+typedef struct memory_arena memory_arena;
+
+// Pass as WorkerCount to get one worker per remaining physical core (or logical
+// processor, when workers are not pinned).
+#define WIN32_WORKERS_PER_CORE 0xFFFFFFFFu
+
+// Allocates the queue in 'Arena', converts the calling thread to a fiber, starts
+// the workers and fills the job functions of 'EngineMemory'. Returns null when the
+// arena is full.
+platform_work_queue *Win32StartWorkQueue        (uint32_t WorkerCount, memory_arena *Arena, engine_memory *EngineMemory);
+
+// Drains both lanes and joins every worker. The queue cannot be used afterwards.
+void                 Win32StopWorkers           (platform_work_queue *Queue);
+
+void                 Win32WriteWorkTelemetry    (platform_work_queue *Queue, const char *Path);
+uint32_t             Win32GetSleepingWorkerCount(platform_work_queue *Queue);
@@ -0,0 +1,29 @@
+@echo off
+rem Builds and runs the tests with cl. Run from a Visual Studio developer prompt;
+rem binaries go to tests\build. Exits non-zero when a test fails.
+
+setlocal
+set Root=%~dp0..
+set Out=%~dp0build
+set Flags=/nologo /std:c11 /O2 /Zi /I"%Root%" /I"%Root%\engine" /DENGINE_PROFILER=0
+
+rem Every test links the same engine core; unused files cost link time only.
+set Core="%Root%\utilities.c" "%Root%\platform\win32_os.c" "%Root%\engine\math\vector.c" "%Root%\engine\math\matrix.c" "%Root%\engine\rendering\renderer.c" "%Root%\engine\rendering\renderer_internal.c"
+
+if not exist "%Out%" mkdir "%Out%"
+pushd "%Out%"
+
+cl %Flags% /Fe:test_vertex_packing.exe "%Root%\tests\test_vertex_packing.c" %Core% || goto :Failed
+
+set Failed=0
+for %%T in (test_*.exe) do (
+    echo == %%T
+    %%T || set Failed=1
+)
+
+popd
+exit /b %Failed
+
+:Failed
+popd
+exit /b 1
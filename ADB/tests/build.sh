@@ -0,0 +1,26 @@
+#!/bin/sh
+# Builds and runs the tests on a POSIX system. Run from anywhere; binaries go to
+# tests/build. Exits non-zero when a test fails. CC defaults to cc.
+
+set -e
+
+Root=$(cd "$(dirname "$0")/.." && pwd)
+Out="$Root/tests/build"
+CC=${CC:-cc}
+Flags="-std=gnu11 -O2 -g -I$Root -I$Root/engine -DENGINE_PROFILER=0"
+
+mkdir -p "$Out"
+
+# Every test links the same engine core; unused files cost link time only.
+Core="$Root/utilities.c $Root/platform/posix_os.c $Root/engine/math/vector.c $Root/engine/math/matrix.c
+      $Root/engine/rendering/renderer.c $Root/engine/rendering/renderer_internal.c"
+
+$CC $Flags -o "$Out/test_vertex_packing" "$Root/tests/test_vertex_packing.c" $Core -lm -lpthread
+
+Failed=0
+for Test in "$Out"/test_*; do
+    echo "== $(basename "$Test")"
+    "$Test" || Failed=1
+done
+
+exit $Failed
@@ -0,0 +1,150 @@
+// Quantization error of the packed vertex formats (renderer_internal.h). Every
+// packer rounds to nearest, so the decoded value must be within half a step of the
+// input once it is clamped to the format's range.
+
+#include <math.h>
+#include <stdio.h>
+#include <stdint.h>
+#include <stdlib.h>
+#include <string.h>
+
+#include "utilities.h"
+#include "engine/math/vector.h"
+#include "engine/rendering/renderer_internal.h"
+
+
+static uint32_t FailureCount;
+
+#define Check(Condition, ...)                                   \
+    do                                                          \
+    {                                                           \
+        if (!(Condition))                                       \
+        {                                                       \
+            printf("%s:%d: ", __FILE__, __LINE__);              \
+            printf(__VA_ARGS__);                                \
+            printf("\n");                                       \
+            ++FailureCount;                                     \
+        }                                                       \
+    } while (0)
+
+
+static uint32_t RandomState = 0x9E3779B9u;
+
+static float
+RandomUnit(void)
+{
+    RandomState ^= RandomState << 13;
+    RandomState ^= RandomState >> 17;
+    RandomState ^= RandomState << 5;
+
+    float Result = (float)(RandomState >> 8) / (float)(1u << 24);
+    return Result;
+}
+
+
+static float
+RandomRange(float Min, float Max)
+{
+    float Result = Min + (Max - Min) * RandomUnit();
+    return Result;
+}
+
+
+static double
+ClampRange(double Value, double Min, double Max)
+{
+    double Result = Value < Min ? Min : (Value > Max ? Max : Value);
+    return Result;
+}
+
+
+// Chunk meshing only feeds integer corners and tile counts, which must survive
+// exactly. Fractional inputs round to the nearest integer.
+static void
+TestTileVertex(void)
+{
+    for (uint32_t Y = 0; Y <= 255; ++Y)
+    {
+        for (uint32_t X = 0; X <= 255; ++X)
+        {
+            tile_vertex_packed Packed = PackTileVertex(Vec3((float)X, (float)Y, (float)(X ^ Y)), Vec2((float)(X * 257), (float)(Y * 257)), (uint8_t)(X + Y));
+
+            Check(Packed.X == X && Packed.Y == Y && Packed.Z == (X ^ Y), "tile position (%u, %u) packed to (%u, %u, %u)", X, Y, Packed.X, Packed.Y, Packed.Z);
+            Check(Packed.U == X * 257 && Packed.V == Y * 257, "tile uv (%u, %u) packed to (%u, %u)", X * 257, Y * 257, Packed.U, Packed.V);
+            Check(Packed.TileID == (uint8_t)(X + Y), "tile id %u packed to %u", (uint8_t)(X + Y), Packed.TileID);
+        }
+    }
+
+    double MaxPositionError = 0.0;
+    double MaxUVError       = 0.0;
+
+    for (uint32_t Idx = 0; Idx < 1000000; ++Idx)
+    {
+        vec3 Position = Vec3(RandomRange(-8.f, 264.f), RandomRange(-8.f, 264.f), RandomRange(-8.f, 264.f));
+        vec2 UV       = Vec2(RandomRange(-8.f, 65544.f), RandomRange(-8.f, 65544.f));
+
+        tile_vertex_packed Packed = PackTileVertex(Position, UV, 0);
+
+        MaxPositionError = fmax(MaxPositionError, fabs(Packed.X - ClampRange(Position.X, 0.0, 255.0)));
+        MaxPositionError = fmax(MaxPositionError, fabs(Packed.Y - ClampRange(Position.Y, 0.0, 255.0)));
+        MaxPositionError = fmax(MaxPositionError, fabs(Packed.Z - ClampRange(Position.Z, 0.0, 255.0)));
+        MaxUVError       = fmax(MaxUVError, fabs(Packed.U - ClampRange(UV.X, 0.0, 65535.0)));
+        MaxUVError       = fmax(MaxUVError, fabs(Packed.V - ClampRange(UV.Y, 0.0, 65535.0)));
+    }
+
+    // Large UVs are floats with a few ulps of their own, hence the small margin.
+    Check(MaxPositionError <= 0.5, "tile position error %f is over half a step", MaxPositionError);
+    Check(MaxUVError <= 0.5 + 1e-2, "tile uv error %f is over half a step", MaxUVError);
+
+    printf("tile_vertex_packed:  %2zu bytes (was %2zu), position error %.4f, uv error %.4f (steps)\n",
+           sizeof(tile_vertex_packed), sizeof(tile_vertex_data), MaxPositionError, MaxUVError);
+}
+
+
+static void
+TestGizmoVertex(void)
+{
+    double HalfStep      = 0.5 / 255.0;
+    double MaxColorError = 0.0;
+
+    for (uint32_t Idx = 0; Idx < 1000000; ++Idx)
+    {
+        vec3 Position = Vec3(RandomRange(-1e4f, 1e4f), RandomRange(-1e4f, 1e4f), RandomRange(-1e4f, 1e4f));
+        vec3 Color    = Vec3(RandomRange(-0.1f, 1.1f), RandomRange(-0.1f, 1.1f), RandomRange(-0.1f, 1.1f));
+
+        gizmo_vertex_packed Packed = PackGizmoVertex(Position, Color);
+
+        Check(memcmp(&Packed.Position, &Position, sizeof(vec3)) == 0, "gizmo position changed");
+        Check((Packed.Color >> 24) == 0xFF, "gizmo alpha is %u", Packed.Color >> 24);
+
+        MaxColorError = fmax(MaxColorError, fabs(((Packed.Color >>  0) & 0xFF) / 255.0 - ClampRange(Color.X, 0.0, 1.0)));
+        MaxColorError = fmax(MaxColorError, fabs(((Packed.Color >>  8) & 0xFF) / 255.0 - ClampRange(Color.Y, 0.0, 1.0)));
+        MaxColorError = fmax(MaxColorError, fabs(((Packed.Color >> 16) & 0xFF) / 255.0 - ClampRange(Color.Z, 0.0, 1.0)));
+    }
+
+    Check(MaxColorError <= HalfStep + 1e-6, "gizmo color error %f is over half a step (%f)", MaxColorError, HalfStep);
+
+    gizmo_vertex_packed White = PackGizmoVertex(Vec3(0.f, 0.f, 0.f), Vec3(1.f, 1.f, 1.f));
+    gizmo_vertex_packed Black = PackGizmoVertex(Vec3(0.f, 0.f, 0.f), Vec3(0.f, 0.f, 0.f));
+
+    Check(White.Color == 0xFFFFFFFFu, "white packed to %08X", White.Color);
+    Check(Black.Color == 0xFF000000u, "black packed to %08X", Black.Color);
+
+    printf("gizmo_vertex_packed: %2zu bytes (was %2zu), color error %.6f (half step %.6f)\n",
+           sizeof(gizmo_vertex_packed), sizeof(gizmo_vertex_data), MaxColorError, HalfStep);
+}
+
+
+int
+main(void)
+{
+    TestTileVertex();
+    TestGizmoVertex();
+
+    if (FailureCount)
+    {
+        printf("FAILED: %u checks\n", FailureCount);
+    }
+
+    return FailureCount ? 1 : 0;
+}
@@ -1,5 +1,6 @@
 #pragma once
 
+#include <stddef.h>
 #include <stdint.h>
 #include <stdbool.h>
 
@@ -20,6 +21,30 @@
 
 #define ArrayCount(a) (sizeof(a) / sizeof(a[0]))
 
+// ==============================================
+// <Atomics>
+// ==============================================
+
+#if defined(_MSC_VER)
+
+#include <intrin.h>
+
+#define AtomicIncrementU32(Target)                    ((uint32_t)_InterlockedIncrement((long volatile *)(Target)))
+#define AtomicAddU32(Target, Value)                   ((uint32_t)_InterlockedExchangeAdd((long volatile *)(Target), (long)(Value)))
+#define AtomicAddU64(Target, Value)                   ((uint64_t)_InterlockedExchangeAdd64((long long volatile *)(Target), (long long)(Value)))
+#define AtomicCompareExchangeU64(Target, New, Expect) ((uint64_t)_InterlockedCompareExchange64((long long volatile *)(Target), (long long)(New), (long long)(Expect)))
+#define CPUPause()                                    _mm_pause()
+
+#else
+
+#define AtomicIncrementU32(Target)                    ((uint32_t)__sync_add_and_fetch((Target), 1))
+#define AtomicAddU32(Target, Value)                   ((uint32_t)__sync_fetch_and_add((Target), (Value)))
+#define AtomicAddU64(Target, Value)                   ((uint64_t)__sync_fetch_and_add((Target), (Value)))
+#define AtomicCompareExchangeU64(Target, New, Expect) ((uint64_t)__sync_val_compare_and_swap((Target), (Expect), (New)))
+#define CPUPause()                                    __builtin_ia32_pause()
+
+#endif
+
 // ==============================================
 // <Memory Arenas>
 // ==============================================